@@ -0,0 +1,58 @@
+/**
+ ******************************************************************************
+ * @file           : adpcm.h
+ * @brief          : Streaming IMA-ADPCM decoder for the audio assets
+ ******************************************************************************
+ * @attention
+ *
+ * Assets are a single IMA-ADPCM stream (4 bits per sample, low nibble
+ * first, predictor and step index starting at 0) produced by
+ * tools/audio_adpcm.py. The decoder keeps its place between calls, so the
+ * audio engine can pull one half buffer at a time from its refill interrupt.
+ *
+ * No HAL dependencies (also built on the host by tools/adpcm_bench).
+ *
+ ******************************************************************************
+ */
+
+#ifndef __ADPCM_H
+#define __ADPCM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+    typedef struct
+    {
+        const uint8_t *data; /* Two samples per byte */
+        uint32_t samples;    /* Samples in the stream */
+        uint32_t position;   /* Next sample */
+        int32_t predictor;
+        int32_t index;
+    } AdpcmDecoder;
+
+    /**
+     * @brief Start decoding a stream from its beginning
+     * @param decoder: Decoder state
+     * @param data: ADPCM bytes
+     * @param samples: Number of samples (twice the bytes, or one less)
+     */
+    void Adpcm_Init(AdpcmDecoder *decoder, const uint8_t *data, uint32_t samples);
+
+    /**
+     * @brief Decode the next samples
+     * @param decoder: Decoder state
+     * @param out: Signed 16-bit samples
+     * @param count: Samples wanted
+     * @retval Samples decoded, fewer than count at the end of the stream
+     */
+    uint32_t Adpcm_Decode(AdpcmDecoder *decoder, int16_t *out, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADPCM_H */
@@ -0,0 +1,115 @@
+/**
+ ******************************************************************************
+ * @file           : audio_engine.h
+ * @brief          : DMA streamed 1-bit audio on the buzzer pin
+ ******************************************************************************
+ * @attention
+ *
+ * The buzzer sits on PG13, which has no timer channel or DAC behind it, so
+ * the output stays the 1-bit DAC it always was: the pin is high while the
+ * sample is positive. Instead of one interrupt per sample, TIM8 raises a
+ * DMA request at AUDIO_SAMPLE_RATE and DMA2 stream 1 copies the next word
+ * of a circular ping-pong buffer into GPIOG->BSRR (set or reset PG13). The
+ * CPU only refills the half that just played, on the half and full transfer
+ * interrupts: AUDIO_SAMPLE_RATE / AUDIO_HALF_SAMPLES interrupts per second
+ * instead of AUDIO_SAMPLE_RATE.
+ *
+ * Samples come from a source callback, called from the refill interrupt.
+ *
+ * With AUDIO_PER_SAMPLE_ISR set to 1 the old path is used instead: TIM7
+ * interrupts at AUDIO_SAMPLE_RATE and each interrupt pulls one sample and
+ * writes the pin. Both paths count their interrupts and busy cycles the
+ * same way (AudioEngine_GetStats), so the CPU load can be compared.
+ *
+ ******************************************************************************
+ */
+
+#ifndef __AUDIO_ENGINE_H
+#define __AUDIO_ENGINE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+/* 1 = one TIM7 interrupt per sample (for comparison) */
+#ifndef AUDIO_PER_SAMPLE_ISR
+#define AUDIO_PER_SAMPLE_ISR 0
+#endif
+
+#define AUDIO_SAMPLE_RATE 8000U
+#define AUDIO_BUFFER_SAMPLES 256U /* Both halves, 32 ms at 8 kHz */
+#define AUDIO_HALF_SAMPLES (AUDIO_BUFFER_SAMPLES / 2U)
+
+    /**
+     * @brief Sample source (called from an interrupt)
+     * @param samples: Buffer for signed 16-bit samples at AUDIO_SAMPLE_RATE
+     * @param count: Samples wanted
+     * @retval Samples written; fewer than count ends the playback
+     */
+    typedef uint32_t (*AudioEngineSource)(int16_t *samples, uint32_t count);
+
+    /**
+     * @brief Interrupt load of the playback since the last reset
+     */
+    typedef struct
+    {
+        uint32_t interrupts;   /* Refill (or per-sample) interrupts */
+        uint32_t maxCycles;    /* Longest one */
+        uint64_t busyCycles;   /* Cycles spent in them */
+        uint64_t playCycles;   /* Cycles of playback */
+        uint32_t loadPermille; /* busyCycles / playCycles */
+    } AudioEngineStats;
+
+    /**
+     * @brief Set up the timer and the DMA stream (call once after the clocks)
+     */
+    void AudioEngine_Init(void);
+
+    /**
+     * @brief Start streaming from a source
+     * @param source: Sample callback
+     * @retval 0 on success, -1 if already playing
+     */
+    int AudioEngine_Play(AudioEngineSource source);
+
+    /**
+     * @brief Stop streaming and leave the pin low (task context; the end of
+     *        a stream stops itself from the interrupt)
+     */
+    void AudioEngine_Stop(void);
+
+    /**
+     * @brief Playback state
+     * @retval 1 while playing
+     */
+    int AudioEngine_IsPlaying(void);
+
+    /**
+     * @brief DMA2 stream 1 interrupt (half and full transfer)
+     */
+    void AudioEngine_DMAIRQHandler(void);
+
+    /**
+     * @brief TIM7 update, only used with AUDIO_PER_SAMPLE_ISR
+     */
+    void AudioEngine_SampleTick(void);
+
+    /**
+     * @brief Interrupt load since the last reset
+     * @param stats: Filled in
+     */
+    void AudioEngine_GetStats(AudioEngineStats *stats);
+
+    /**
+     * @brief Clear the load statistics
+     */
+    void AudioEngine_ResetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AUDIO_ENGINE_H */
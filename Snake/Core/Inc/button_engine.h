@@ -0,0 +1,126 @@
+/**
+ ******************************************************************************
+ * @file           : button_engine.h
+ * @brief          : Debounce, hold/repeat and chord state machines for buttons
+ ******************************************************************************
+ * @attention
+ *
+ * ButtonEngine_Sample() is called at a fixed rate (e.g. from a 1 kHz timer
+ * interrupt) with the raw button levels. Each button has an integrator that
+ * counts towards integratorMax while the raw level reads pressed and towards
+ * 0 while it reads released; the debounced state only changes at either end,
+ * so a bounce has to last integratorMax samples to get through. The work per
+ * sample is the same whatever happens: no loops over history, no blocking.
+ *
+ * Events (press, hold, repeat, release, chord) go into a small lock-free
+ * queue with one producer (the sampling interrupt) and one consumer (a
+ * task calling ButtonEngine_PopEvent()). Repeats only fire while a single
+ * button is down, so holding a chord does not repeat its buttons.
+ *
+ * All times are in samples.
+ *
+ ******************************************************************************
+ */
+
+#ifndef __BUTTON_ENGINE_H
+#define __BUTTON_ENGINE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+#define BUTTON_ENGINE_MAX_BUTTONS 8U
+#define BUTTON_ENGINE_MAX_CHORDS 4U
+#define BUTTON_ENGINE_QUEUE_SIZE 16U /* Power of two */
+
+    typedef enum
+    {
+        BUTTON_EVENT_PRESS = 0, /* Debounced press, id = button */
+        BUTTON_EVENT_HOLD,      /* Held for holdSamples, id = button */
+        BUTTON_EVENT_REPEAT,    /* Every repeatSamples after the hold, id = button */
+        BUTTON_EVENT_RELEASE,   /* Debounced release, id = button */
+        BUTTON_EVENT_CHORD      /* All buttons of a chord held long enough, id = chord */
+    } ButtonEventType;
+
+    typedef struct
+    {
+        uint8_t type; /* ButtonEventType */
+        uint8_t id;
+    } ButtonEvent;
+
+    typedef struct
+    {
+        uint8_t buttonCount;    /* Up to BUTTON_ENGINE_MAX_BUTTONS */
+        uint8_t integratorMax;  /* Samples a level must persist (debounce time) */
+        uint16_t holdSamples;   /* Press to HOLD, 0 = no hold and no repeat */
+        uint16_t repeatSamples; /* HOLD to the first REPEAT and between repeats, 0 = no repeat */
+    } ButtonEngineConfig;
+
+    typedef struct
+    {
+        uint8_t mask;         /* Bit n = button n must be down */
+        uint16_t holdSamples; /* How long all of them must be down; fires once per hold */
+    } ButtonChordConfig;
+
+    typedef struct
+    {
+        ButtonEngineConfig config;
+        const ButtonChordConfig *chords;
+        uint8_t chordCount;
+
+        uint8_t integrator[BUTTON_ENGINE_MAX_BUTTONS];
+        uint16_t holdCountdown[BUTTON_ENGINE_MAX_BUTTONS];
+        uint8_t repeating[BUTTON_ENGINE_MAX_BUTTONS];
+        uint16_t chordSamples[BUTTON_ENGINE_MAX_CHORDS];
+        uint8_t chordFired[BUTTON_ENGINE_MAX_CHORDS];
+        volatile uint8_t state; /* Debounced, bit n = button n down */
+
+        ButtonEvent events[BUTTON_ENGINE_QUEUE_SIZE];
+        volatile uint8_t head; /* Written by the sampler only */
+        volatile uint8_t tail; /* Written by the consumer only */
+        volatile uint32_t overflows;
+    } ButtonEngine;
+
+    /**
+     * @brief Reset an engine (before the sampling interrupt is enabled)
+     * @param engine: Engine to set up
+     * @param config: Debounce and hold/repeat timing, copied
+     * @param chords: Chords to detect (kept by reference), may be NULL
+     * @param chordCount: Number of chords, up to BUTTON_ENGINE_MAX_CHORDS
+     */
+    void ButtonEngine_Init(ButtonEngine *engine, const ButtonEngineConfig *config,
+                           const ButtonChordConfig *chords, uint8_t chordCount);
+
+    /**
+     * @brief Feed one sample of the raw levels (fixed rate, interrupt safe)
+     * @param engine: Engine to update
+     * @param raw: Bit n set while button n reads pressed
+     * @retval Debounced state after the sample
+     */
+    uint8_t ButtonEngine_Sample(ButtonEngine *engine, uint8_t raw);
+
+    /**
+     * @brief Debounced state
+     * @retval Bit n set while button n is down
+     */
+    static inline uint8_t ButtonEngine_GetState(const ButtonEngine *engine)
+    {
+        return engine->state;
+    }
+
+    /**
+     * @brief Take the oldest event (single consumer)
+     * @param engine: Engine to read
+     * @param event: Filled in when an event was waiting
+     * @retval 1 if an event was taken, 0 if the queue was empty
+     */
+    int ButtonEngine_PopEvent(ButtonEngine *engine, ButtonEvent *event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BUTTON_ENGINE_H */
@@ -0,0 +1,147 @@
+/**
+ ******************************************************************************
+ * @file           : button_input.h
+ * @brief          : Interrupt driven game buttons with DWT edge timestamps
+ ******************************************************************************
+ * @attention
+ *
+ * PD4..PD7 are sampled every millisecond from the TIM6 timebase interrupt
+ * with a single read of GPIOD->IDR, decoded through a 16-entry table into a
+ * button mask and debounced by a ButtonEngine (integrator, see button_engine.h), which
+ * also produces hold/repeat and chord events for the default task. Level
+ * changes are handed to the GUI from the same interrupt instead of waiting
+ * for the next 20 ms loop of the default task: new presses first, oldest
+ * edge first and with their edge times, then the levels.
+ *
+ * The pins also raise EXTI on both edges, only to stamp the first edge of a
+ * press with the DWT cycle counter, so latency is measured from the real
+ * edge rather than from the end of the debounce. Further edges until the
+ * engine accepts the change are counted as bounces.
+ *
+ * With BUTTON_INPUT_POLLED set to 1 the default task delivers the debounced
+ * levels from its loop, while the edges are still stamped. Both builds
+ * therefore measure the press to setDirection() latency the same way and can
+ * be compared with the debugger (ButtonInput_GetLatencyStats).
+ *
+ ******************************************************************************
+ */
+
+#ifndef __BUTTON_INPUT_H
+#define __BUTTON_INPUT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include "button_engine.h"
+
+/* 1 = deliver buttons from the 20 ms polling loop (for comparison) */
+#ifndef BUTTON_INPUT_POLLED
+#define BUTTON_INPUT_POLLED 0
+#endif
+
+/* Timing in milliseconds, one engine sample per TIM6 tick */
+#define BUTTON_DEBOUNCE_MS 5U      /* A level must hold this long to count */
+#define BUTTON_HOLD_MS 400U        /* Press to the hold event */
+#define BUTTON_REPEAT_MS 120U      /* Between repeats while a single button is held */
+#define BUTTON_RESET_HOLD_MS 3000U /* All four buttons held, erases the highscores */
+
+/* Button indices, in SnakeDirection order */
+#define BUTTON_UP 0U
+#define BUTTON_DOWN 1U
+#define BUTTON_LEFT 2U
+#define BUTTON_RIGHT 3U
+#define BUTTON_COUNT 4U
+
+/* Chord indices (ButtonEvent.id of BUTTON_EVENT_CHORD) */
+#define BUTTON_CHORD_RESET 0U
+
+    /**
+     * @brief Press to setDirection() latency, accumulated since the last reset
+     */
+    typedef struct
+    {
+        uint32_t samples;      /* Presses that reached the game */
+        uint32_t lastUs;       /* Latency of the latest press */
+        uint32_t maxUs;        /* Worst latency */
+        uint32_t totalUs;      /* Sum of all latencies, for the average */
+        uint32_t presses;      /* Debounced presses */
+        uint32_t bounces;      /* Edges after the first one of a change */
+    } ButtonLatencyStats;
+
+    /**
+     * @brief Cost and regularity of the 1 ms sampling, in CPU cycles
+     */
+    typedef struct
+    {
+        uint32_t samples;         /* Samples taken */
+        uint32_t lastCycles;      /* Cost of the latest sample */
+        uint32_t maxCycles;       /* Worst cost */
+        uint32_t totalCycles;     /* Sum of all costs, for the average (wraps after ~12 h at 100 cycles) */
+        uint32_t maxJitterCycles; /* Worst deviation of a sample interval from 1 ms */
+    } ButtonSampleStats;
+
+    /**
+     * @brief Switch PD4..PD7 to EXTI on both edges and start sampling
+     *        (call from the default task, once the GUI exists)
+     */
+    void ButtonInput_Init(void);
+
+    /**
+     * @brief Timestamp the first edge of a change (call from HAL_GPIO_EXTI_Callback)
+     * @param pin: GPIO_PIN_x of the interrupting line
+     */
+    void ButtonInput_HandleEdge(uint16_t pin);
+
+    /**
+     * @brief Sample and debounce the buttons (call every 1 ms from the TIM6 interrupt)
+     */
+    void ButtonInput_Tick(void);
+
+    /**
+     * @brief Take the oldest press/hold/repeat/release/chord event
+     * @param event: Filled in when an event was waiting
+     * @retval 1 if an event was taken, 0 if none was waiting
+     */
+    int ButtonInput_PopEvent(ButtonEvent *event);
+
+    /**
+     * @brief Debounced button levels
+     * @retval Bit n set while button n is pressed
+     */
+    uint8_t ButtonInput_GetState(void);
+
+    /**
+     * @brief Record the latency of a press that reached the game
+     * @param button: BUTTON_UP..BUTTON_RIGHT
+     * @note Each press is counted once, repeated calls are ignored
+     */
+    void ButtonInput_PressHandled(uint8_t button);
+
+    /**
+     * @brief Latency statistics since boot or the last reset
+     */
+    const ButtonLatencyStats *ButtonInput_GetLatencyStats(void);
+
+    /**
+     * @brief Clear the latency statistics
+     */
+    void ButtonInput_ResetLatencyStats(void);
+
+    /**
+     * @brief Sampling cost and jitter since boot or the last reset
+     */
+    const ButtonSampleStats *ButtonInput_GetSampleStats(void);
+
+    /**
+     * @brief Clear the sampling statistics
+     */
+    void ButtonInput_ResetSampleStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BUTTON_INPUT_H */
@@ -0,0 +1,139 @@
+/**
+ ******************************************************************************
+ * @file           : latency_probe.h
+ * @brief          : Input to photon latency measurement
+ ******************************************************************************
+ * @attention
+ *
+ * One press at a time is followed through the pipeline, all stamps taken
+ * with the DWT cycle counter:
+ *
+ *   press    EXTI edge (ButtonInput) or LatencyProbe_Inject()
+ *   apply    SnakeGame::update() applied the turn       -> input stage
+ *   render   the frame with the new head was finished  -> render stage
+ *   scanout  the LTDC beam reaches the row of the head  -> scanout stage
+ *
+ * The scanout time is computed from the LTDC line position and the measured
+ * frame period, when the frame is shown (next vsync with two framebuffers,
+ * right away with one). Presses while a measurement is in flight are not
+ * followed. Only the turn in the pressed direction completes a sample; a
+ * press the game rejects, or one not applied within a second, is counted as
+ * dropped.
+ *
+ * Results go into a ring of the last LATENCY_RING_SIZE samples and a
+ * histogram of the display latency (render plus scanout). The input stage
+ * waits for the next game step (83 ms to 1 s depending on the difficulty),
+ * so it is only reported as average and maximum; the histogram shows what
+ * the rendering path adds. LatencyProbe_Report() prints a summary on
+ * USART1 (PA9, 115200 8N1, the ST-LINK virtual COM port of the DISC1 board).
+ *
+ ******************************************************************************
+ */
+
+#ifndef __LATENCY_PROBE_H
+#define __LATENCY_PROBE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+#define LATENCY_RING_SIZE 64U
+#define LATENCY_HISTOGRAM_BINS 16U
+#define LATENCY_BIN_MS 4U          /* Display latency per bin, the last bin collects the rest */
+#define LATENCY_REPORT_SAMPLES 32U /* New samples between two UART reports */
+
+    /**
+     * @brief Pipeline stages of a sample
+     */
+    typedef enum
+    {
+        LATENCY_INPUT = 0, /* Press to applied by the game */
+        LATENCY_RENDER,    /* Applied to frame rendered */
+        LATENCY_SCANOUT,   /* Frame rendered to the beam reaching the head */
+        LATENCY_STAGE_COUNT
+    } LatencyStage;
+
+    /**
+     * @brief Summary of the samples in the ring
+     */
+    typedef struct
+    {
+        uint32_t samples;                       /* Completed samples since the last reset */
+        uint32_t dropped;                       /* Presses never applied */
+        uint32_t avgUs[LATENCY_STAGE_COUNT];    /* Over the ring */
+        uint32_t maxUs[LATENCY_STAGE_COUNT];    /* Over the ring */
+        uint32_t histogram[LATENCY_HISTOGRAM_BINS]; /* Display latency since the last reset */
+    } LatencySummary;
+
+    /**
+     * @brief Set up USART1 for the reports (call once after the clocks)
+     */
+    void LatencyProbe_Init(void);
+
+    /**
+     * @brief A press happened (may be called from an interrupt)
+     * @param cycles: DWT cycle count of the press edge
+     * @param direction: SnakeDirection of the button
+     */
+    void LatencyProbe_Press(uint32_t cycles, uint8_t direction);
+
+    /**
+     * @brief Software press through the regular input path, stamped now
+     * @param direction: SnakeDirection to press
+     */
+    void LatencyProbe_Inject(uint8_t direction);
+
+    /**
+     * @brief The game applied a turn (call from the GUI task)
+     * @param line: Screen row of the new head
+     * @param direction: SnakeDirection the snake turned to
+     */
+    void LatencyProbe_Applied(uint16_t line, uint8_t direction);
+
+    /**
+     * @brief The game rejected a press (call from the GUI task)
+     * @param direction: SnakeDirection of the press
+     */
+    void LatencyProbe_Rejected(uint8_t direction);
+
+    /**
+     * @brief A frame was rendered (call from the GUI task, at the end of the frame)
+     */
+    void LatencyProbe_FrameRendered(void);
+
+    /**
+     * @brief Vertical sync (call from the GUI task once per LTDC frame)
+     */
+    void LatencyProbe_VSync(void);
+
+    /**
+     * @brief Summarise the ring and the histogram
+     * @param summary: Filled in
+     */
+    void LatencyProbe_GetSummary(LatencySummary *summary);
+
+    /**
+     * @brief Clear the ring, the histogram and the counters
+     */
+    void LatencyProbe_Reset(void);
+
+    /**
+     * @brief Print the summary on USART1 after every LATENCY_REPORT_SAMPLES
+     *        new samples; formats into a buffer that the USART1 interrupt
+     *        sends, so the caller does not wait for the UART
+     */
+    void LatencyProbe_Report(void);
+
+    /**
+     * @brief USART1 interrupt, sends the report (called from USART1_IRQHandler)
+     */
+    void LatencyProbe_UARTIRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LATENCY_PROBE_H */
@@ -91,6 +91,10 @@ extern "C"
 #define ISD1820_PLAY_GPIO_Port GPIOD
   /* PD13 is reserved but not needed for basic playback - only PLAY-L is required */
 
+/* STMPE811 touch controller interrupt (open drain, active LOW) */
+#define TP_INT_Pin GPIO_PIN_15
+#define TP_INT_GPIO_Port GPIOA
+
   /* USER CODE END Private defines */
 
 #ifdef __cplusplus
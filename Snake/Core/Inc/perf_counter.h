@@ -0,0 +1,81 @@
+/**
+ ******************************************************************************
+ * @file           : perf_counter.h
+ * @brief          : Cycle-accurate timing based on the Cortex-M4 DWT counter
+ ******************************************************************************
+ * @attention
+ *
+ * The DWT cycle counter runs at SYSCLK (180 MHz), so one count is ~5.6 ns
+ * and the 32-bit counter wraps after ~23.8 s. Differences computed with
+ * unsigned subtraction are therefore valid for intervals shorter than that.
+ *
+ * CPU load is measured by the FreeRTOS idle hook, which sleeps in WFI and
+ * accumulates the sleeping cycles. Load is the share of the elapsed time
+ * (SysTick based, so it is correct whether or not the counter keeps running
+ * during sleep) that was not spent sleeping.
+ *
+ ******************************************************************************
+ */
+
+#ifndef __PERF_COUNTER_H
+#define __PERF_COUNTER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stm32f4xx.h"
+#include <stdint.h>
+
+    /**
+     * @brief Enable the DWT cycle counter (call once after SystemClock_Config)
+     */
+    void PerfCounter_Init(void);
+
+    /**
+     * @brief Read the current cycle count
+     * @retval Free running SYSCLK cycle count
+     */
+    static inline uint32_t PerfCounter_GetCycles(void)
+    {
+        return DWT->CYCCNT;
+    }
+
+    /**
+     * @brief Convert a cycle count to microseconds
+     * @param cycles: Number of SYSCLK cycles
+     * @retval Duration in microseconds
+     */
+    uint32_t PerfCounter_CyclesToUs(uint32_t cycles);
+
+    /**
+     * @brief Sleep until the next interrupt and account the time as idle
+     *        (call from vApplicationIdleHook)
+     */
+    void PerfCounter_IdleSleep(void);
+
+    /**
+     * @brief Count a frame that was actually rendered (called by the GUI HAL)
+     */
+    void PerfCounter_FrameRendered(void);
+
+    /**
+     * @brief CPU load and rendered frames since the previous call
+     * @param load_permille: Busy time in 1/1000 of the elapsed time
+     * @param frames: Number of frames rendered
+     * @param elapsed_ms: Length of the measured interval in milliseconds
+     */
+    void PerfCounter_GetLoad(uint16_t *load_permille, uint32_t *frames, uint32_t *elapsed_ms);
+
+    /**
+     * @brief Total cycles spent sleeping in the idle hook since boot (wraps like CYCCNT)
+     * @retval Idle cycle count, compare two reads with unsigned subtraction
+     */
+    uint32_t PerfCounter_GetIdleCycles(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PERF_COUNTER_H */
@@ -0,0 +1,98 @@
+/**
+ ******************************************************************************
+ * @file           : adpcm.c
+ * @brief          : IMA-ADPCM decoding, one nibble per sample
+ ******************************************************************************
+ */
+
+#include "adpcm.h"
+
+static const int16_t step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+    34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143,
+    157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+    724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024,
+    3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+static const int8_t index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8};
+
+/**
+ * @brief Rewind to the start of a stream
+ */
+void Adpcm_Init(AdpcmDecoder *decoder, const uint8_t *data, uint32_t samples)
+{
+    decoder->data = data;
+    decoder->samples = samples;
+    decoder->position = 0;
+    decoder->predictor = 0;
+    decoder->index = 0;
+}
+
+/**
+ * @brief Decode up to count samples from where the last call stopped
+ */
+uint32_t Adpcm_Decode(AdpcmDecoder *decoder, int16_t *out, uint32_t count)
+{
+    uint32_t position = decoder->position;
+    int32_t predictor = decoder->predictor;
+    int32_t index = decoder->index;
+    uint32_t i;
+
+    if (count > decoder->samples - position)
+    {
+        count = decoder->samples - position;
+    }
+
+    for (i = 0; i < count; i++, position++)
+    {
+        uint8_t code = decoder->data[position >> 1];
+        int32_t step = step_table[index];
+        int32_t diff;
+
+        code = (position & 1U) ? (uint8_t)(code >> 4) : (uint8_t)(code & 0x0FU);
+
+        /* diff = (code & 7 + 0.5) * step / 4, in the reference's shift-and-add form */
+        diff = step >> 3;
+        if (code & 4U)
+        {
+            diff += step;
+        }
+        if (code & 2U)
+        {
+            diff += step >> 1;
+        }
+        if (code & 1U)
+        {
+            diff += step >> 2;
+        }
+        predictor += (code & 8U) ? -diff : diff;
+        if (predictor > 32767)
+        {
+            predictor = 32767;
+        }
+        else if (predictor < -32768)
+        {
+            predictor = -32768;
+        }
+
+        index += index_table[code];
+        if (index < 0)
+        {
+            index = 0;
+        }
+        else if (index > 88)
+        {
+            index = 88;
+        }
+
+        out[i] = (int16_t)predictor;
+    }
+
+    decoder->position = position;
+    decoder->predictor = predictor;
+    decoder->index = index;
+    return count;
+}
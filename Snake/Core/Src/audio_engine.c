@@ -0,0 +1,342 @@
+/**
+ ******************************************************************************
+ * @file           : audio_engine.c
+ * @brief          : Ping-pong DMA from a sample buffer to the buzzer pin
+ ******************************************************************************
+ */
+
+#include "audio_engine.h"
+#include "main.h"
+#include "perf_counter.h"
+
+#define AUDIO_PORT GPIOG
+#define AUDIO_PIN GPIO_PIN_13
+#define AUDIO_PIN_HIGH ((uint32_t)AUDIO_PIN)
+#define AUDIO_PIN_LOW ((uint32_t)AUDIO_PIN << 16)
+
+static AudioEngineSource audio_source = NULL;
+static volatile uint8_t audio_playing = 0;
+
+static AudioEngineStats audio_stats;
+static uint32_t play_start_cycles = 0;
+
+/**
+ * @brief Account one interrupt that started at start
+ */
+static void AudioEngine_Account(uint32_t start)
+{
+    uint32_t cycles = PerfCounter_GetCycles() - start;
+
+    audio_stats.interrupts++;
+    audio_stats.busyCycles += cycles;
+    if (cycles > audio_stats.maxCycles)
+    {
+        audio_stats.maxCycles = cycles;
+    }
+}
+
+/**
+ * @brief Common end of playback once the sample clock is stopped
+ */
+static void AudioEngine_Stopped(void)
+{
+    if (audio_playing)
+    {
+        audio_stats.playCycles += PerfCounter_GetCycles() - play_start_cycles;
+    }
+    audio_playing = 0;
+    AUDIO_PORT->BSRR = AUDIO_PIN_LOW;
+}
+
+#if !AUDIO_PER_SAMPLE_ISR
+static DMA_HandleTypeDef hdma_audio;
+
+/* BSRR words; DMA2 cannot reach the CCM RAM, this lives in SRAM */
+static uint32_t audio_buffer[AUDIO_BUFFER_SAMPLES];
+
+static uint8_t audio_ending = 0;
+static uint8_t audio_end_half = 0;
+
+/**
+ * @brief Stop from the stream's own interrupt: HAL_DMA_Abort() would poll the
+ *        enable bit and reset the handle under HAL_DMA_IRQHandler(), so only
+ *        request the abort; the HAL completes it in the next stream interrupt
+ */
+static void AudioEngine_StopFromIRQ(void)
+{
+    TIM8->CR1 = 0;
+    TIM8->DIER = 0;
+    HAL_DMA_Abort_IT(&hdma_audio);
+    AudioEngine_Stopped();
+}
+
+/**
+ * @brief Fill one half with the next samples, silence after the end
+ */
+static void AudioEngine_Fill(uint32_t half)
+{
+    int16_t samples[AUDIO_HALF_SAMPLES];
+    uint32_t *words = &audio_buffer[half * AUDIO_HALF_SAMPLES];
+    uint32_t count = 0;
+    uint32_t i;
+
+    if (!audio_ending)
+    {
+        count = audio_source(samples, AUDIO_HALF_SAMPLES);
+        if (count < AUDIO_HALF_SAMPLES)
+        {
+            /* This half holds the tail: stop once it has played */
+            audio_ending = 1;
+            audio_end_half = (uint8_t)half;
+        }
+    }
+
+    /* 1-bit DAC: pin high while the sample is positive */
+    for (i = 0; i < count; i++)
+    {
+        words[i] = samples[i] > 0 ? AUDIO_PIN_HIGH : AUDIO_PIN_LOW;
+    }
+    for (; i < AUDIO_HALF_SAMPLES; i++)
+    {
+        words[i] = AUDIO_PIN_LOW;
+    }
+}
+
+/**
+ * @brief A half finished playing: stop after the tail, refill otherwise
+ */
+static void AudioEngine_HalfDone(uint32_t half)
+{
+    if (!audio_playing)
+    {
+        return;
+    }
+    if (audio_ending && audio_end_half == half)
+    {
+        AudioEngine_StopFromIRQ();
+        return;
+    }
+    AudioEngine_Fill(half);
+}
+
+static void AudioEngine_HalfCplt(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+    AudioEngine_HalfDone(0);
+}
+
+static void AudioEngine_Cplt(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+    AudioEngine_HalfDone(1);
+}
+
+/**
+ * @brief TIM8 runs at the sample rate and only requests DMA; DMA2 stream 1
+ *        channel 7 (TIM8_UP) writes the buffer to BSRR in a circle
+ */
+void AudioEngine_Init(void)
+{
+    uint32_t clock = HAL_RCC_GetPCLK2Freq();
+
+    __HAL_RCC_TIM8_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    /* APB2 timers run at twice PCLK2 when APB2 is divided */
+    if ((RCC->CFGR & RCC_CFGR_PPRE2) != RCC_CFGR_PPRE2_DIV1)
+    {
+        clock *= 2U;
+    }
+    TIM8->CR1 = 0;
+    TIM8->PSC = 0;
+    TIM8->ARR = clock / AUDIO_SAMPLE_RATE - 1U;
+
+    hdma_audio.Instance = DMA2_Stream1;
+    hdma_audio.Init.Channel = DMA_CHANNEL_7;
+    hdma_audio.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_audio.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_audio.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_audio.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    hdma_audio.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdma_audio.Init.Mode = DMA_CIRCULAR;
+    hdma_audio.Init.Priority = DMA_PRIORITY_LOW;
+    hdma_audio.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_audio) != HAL_OK)
+    {
+        return;
+    }
+    hdma_audio.XferHalfCpltCallback = AudioEngine_HalfCplt;
+    hdma_audio.XferCpltCallback = AudioEngine_Cplt;
+
+    HAL_NVIC_SetPriority(DMA2_Stream1_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream1_IRQn);
+}
+
+/**
+ * @brief Prime both halves, then start the DMA and the timer
+ */
+int AudioEngine_Play(AudioEngineSource source)
+{
+    if (audio_playing || source == NULL)
+    {
+        return -1;
+    }
+
+    audio_source = source;
+    audio_ending = 0;
+    audio_playing = 1;
+    AudioEngine_Fill(0);
+    AudioEngine_Fill(1);
+
+    if (HAL_DMA_Start_IT(&hdma_audio, (uint32_t)audio_buffer, (uint32_t)&AUDIO_PORT->BSRR,
+                         AUDIO_BUFFER_SAMPLES) != HAL_OK)
+    {
+        audio_playing = 0;
+        return -1;
+    }
+    play_start_cycles = PerfCounter_GetCycles();
+    TIM8->CNT = 0;
+    TIM8->DIER = TIM_DIER_UDE;
+    TIM8->CR1 = TIM_CR1_CEN;
+    return 0;
+}
+
+/**
+ * @brief Stop the timer and the stream (task context)
+ */
+void AudioEngine_Stop(void)
+{
+    TIM8->CR1 = 0;
+    TIM8->DIER = 0;
+    HAL_DMA_Abort(&hdma_audio);
+    AudioEngine_Stopped();
+}
+
+/**
+ * @brief Half/full transfer: the refill runs from the HAL callbacks
+ */
+void AudioEngine_DMAIRQHandler(void)
+{
+    uint32_t start = PerfCounter_GetCycles();
+
+    HAL_DMA_IRQHandler(&hdma_audio);
+    AudioEngine_Account(start);
+}
+
+/**
+ * @brief Not used with DMA
+ */
+void AudioEngine_SampleTick(void)
+{
+}
+
+#else /* AUDIO_PER_SAMPLE_ISR */
+
+/**
+ * @brief TIM7 is set up by MX_TIM7_Init() at the sample rate; only its
+ *        update interrupt is switched on and off here
+ */
+void AudioEngine_Init(void)
+{
+}
+
+/**
+ * @brief Start the per-sample interrupt
+ */
+int AudioEngine_Play(AudioEngineSource source)
+{
+    if (audio_playing || source == NULL)
+    {
+        return -1;
+    }
+
+    audio_source = source;
+    audio_playing = 1;
+    play_start_cycles = PerfCounter_GetCycles();
+    TIM7->CNT = 0;
+    TIM7->SR = 0;
+    TIM7->DIER = TIM_DIER_UIE;
+    TIM7->CR1 = TIM_CR1_CEN;
+    return 0;
+}
+
+/**
+ * @brief Stop the per-sample interrupt
+ */
+void AudioEngine_Stop(void)
+{
+    TIM7->CR1 = 0;
+    TIM7->DIER = 0;
+    AudioEngine_Stopped();
+}
+
+/**
+ * @brief Not used without DMA
+ */
+void AudioEngine_DMAIRQHandler(void)
+{
+}
+
+/**
+ * @brief One sample per interrupt, straight to the pin
+ */
+void AudioEngine_SampleTick(void)
+{
+    uint32_t start = PerfCounter_GetCycles();
+    int16_t sample;
+
+    if (!audio_playing)
+    {
+        return;
+    }
+
+    if (audio_source(&sample, 1) == 0U)
+    {
+        AudioEngine_Stop();
+    }
+    else
+    {
+        AUDIO_PORT->BSRR = sample > 0 ? AUDIO_PIN_HIGH : AUDIO_PIN_LOW;
+    }
+    AudioEngine_Account(start);
+}
+
+#endif /* AUDIO_PER_SAMPLE_ISR */
+
+/**
+ * @brief Playback state
+ */
+int AudioEngine_IsPlaying(void)
+{
+    return audio_playing;
+}
+
+/**
+ * @brief Counters plus the share of the playback time spent in interrupts
+ */
+void AudioEngine_GetStats(AudioEngineStats *stats)
+{
+    __disable_irq();
+    *stats = audio_stats;
+    if (audio_playing)
+    {
+        stats->playCycles += PerfCounter_GetCycles() - play_start_cycles;
+    }
+    __enable_irq();
+
+    stats->loadPermille = stats->playCycles ? (uint32_t)(stats->busyCycles * 1000U / stats->playCycles) : 0U;
+}
+
+/**
+ * @brief Clear the load statistics
+ */
+void AudioEngine_ResetStats(void)
+{
+    __disable_irq();
+    audio_stats.interrupts = 0;
+    audio_stats.maxCycles = 0;
+    audio_stats.busyCycles = 0;
+    audio_stats.playCycles = 0;
+    play_start_cycles = PerfCounter_GetCycles();
+    __enable_irq();
+}
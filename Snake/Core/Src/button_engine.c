@@ -0,0 +1,163 @@
+/**
+ ******************************************************************************
+ * @file           : button_engine.c
+ * @brief          : Integrator debouncing, hold/repeat and chords for buttons
+ ******************************************************************************
+ */
+
+#include "button_engine.h"
+
+/**
+ * @brief Queue an event; dropped and counted when the consumer fell behind
+ */
+static void ButtonEngine_Post(ButtonEngine *engine, ButtonEventType type, uint8_t id)
+{
+    uint8_t head = engine->head;
+
+    if ((uint8_t)(head - engine->tail) >= BUTTON_ENGINE_QUEUE_SIZE)
+    {
+        engine->overflows++;
+        return;
+    }
+
+    engine->events[head & (BUTTON_ENGINE_QUEUE_SIZE - 1U)].type = (uint8_t)type;
+    engine->events[head & (BUTTON_ENGINE_QUEUE_SIZE - 1U)].id = id;
+    /* Publish the slot only after it is written */
+    __asm volatile("" ::: "memory");
+    engine->head = (uint8_t)(head + 1U);
+}
+
+/**
+ * @brief Clear all state and take the configuration
+ */
+void ButtonEngine_Init(ButtonEngine *engine, const ButtonEngineConfig *config,
+                       const ButtonChordConfig *chords, uint8_t chordCount)
+{
+    uint8_t i;
+
+    engine->config = *config;
+    if (engine->config.buttonCount > BUTTON_ENGINE_MAX_BUTTONS)
+    {
+        engine->config.buttonCount = BUTTON_ENGINE_MAX_BUTTONS;
+    }
+    engine->chords = chords;
+    engine->chordCount = chordCount > BUTTON_ENGINE_MAX_CHORDS ? BUTTON_ENGINE_MAX_CHORDS : chordCount;
+
+    for (i = 0; i < BUTTON_ENGINE_MAX_BUTTONS; i++)
+    {
+        engine->integrator[i] = 0;
+        engine->holdCountdown[i] = 0;
+        engine->repeating[i] = 0;
+    }
+    for (i = 0; i < BUTTON_ENGINE_MAX_CHORDS; i++)
+    {
+        engine->chordSamples[i] = 0;
+        engine->chordFired[i] = 0;
+    }
+    engine->state = 0;
+    engine->head = 0;
+    engine->tail = 0;
+    engine->overflows = 0;
+}
+
+/**
+ * @brief One step of every button and chord state machine
+ */
+uint8_t ButtonEngine_Sample(ButtonEngine *engine, uint8_t raw)
+{
+    const ButtonEngineConfig *config = &engine->config;
+    uint8_t state = engine->state;
+    uint8_t i;
+
+    for (i = 0; i < config->buttonCount; i++)
+    {
+        uint8_t mask = (uint8_t)(1U << i);
+
+        /* Integrate the raw level, change state only at the ends */
+        if (raw & mask)
+        {
+            if (engine->integrator[i] < config->integratorMax)
+            {
+                engine->integrator[i]++;
+            }
+        }
+        else if (engine->integrator[i] > 0U)
+        {
+            engine->integrator[i]--;
+        }
+
+        if ((state & mask) == 0U)
+        {
+            if (engine->integrator[i] >= config->integratorMax)
+            {
+                state |= mask;
+                engine->holdCountdown[i] = config->holdSamples;
+                engine->repeating[i] = 0;
+                ButtonEngine_Post(engine, BUTTON_EVENT_PRESS, i);
+            }
+            continue;
+        }
+
+        if (engine->integrator[i] == 0U)
+        {
+            state &= (uint8_t)~mask;
+            ButtonEngine_Post(engine, BUTTON_EVENT_RELEASE, i);
+            continue;
+        }
+
+        /* Held: count down to the hold, then to each repeat */
+        if (engine->holdCountdown[i] == 0U || --engine->holdCountdown[i] != 0U)
+        {
+            continue;
+        }
+        if (!engine->repeating[i])
+        {
+            ButtonEngine_Post(engine, BUTTON_EVENT_HOLD, i);
+            engine->repeating[i] = 1;
+        }
+        else if ((state & (uint8_t)(state - 1U)) == 0U)
+        {
+            /* Only this button is down */
+            ButtonEngine_Post(engine, BUTTON_EVENT_REPEAT, i);
+        }
+        engine->holdCountdown[i] = config->repeatSamples;
+    }
+
+    for (i = 0; i < engine->chordCount; i++)
+    {
+        const ButtonChordConfig *chord = &engine->chords[i];
+
+        if ((state & chord->mask) != chord->mask)
+        {
+            engine->chordSamples[i] = 0;
+            engine->chordFired[i] = 0;
+            continue;
+        }
+        if (!engine->chordFired[i] && ++engine->chordSamples[i] >= chord->holdSamples)
+        {
+            engine->chordFired[i] = 1;
+            ButtonEngine_Post(engine, BUTTON_EVENT_CHORD, i);
+        }
+    }
+
+    engine->state = state;
+    return state;
+}
+
+/**
+ * @brief Take the oldest event
+ */
+int ButtonEngine_PopEvent(ButtonEngine *engine, ButtonEvent *event)
+{
+    uint8_t tail = engine->tail;
+
+    if (tail == engine->head)
+    {
+        return 0;
+    }
+
+    *event = engine->events[tail & (BUTTON_ENGINE_QUEUE_SIZE - 1U)];
+    __asm volatile("" ::: "memory");
+    engine->tail = (uint8_t)(tail + 1U);
+    return 1;
+}
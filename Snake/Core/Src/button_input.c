@@ -0,0 +1,310 @@
+/**
+ ******************************************************************************
+ * @file           : button_input.c
+ * @brief          : Timer sampled button input with EXTI edge timestamps
+ ******************************************************************************
+ */
+
+#include "button_input.h"
+#include "main.h"
+#include "latency_probe.h"
+#include "perf_counter.h"
+
+/* Snake game button interface - declared in SnakeInterface.h */
+extern void Snake_ButtonPressed(int direction, uint32_t timeMs);
+extern void Snake_SetButtonLevels(int up, int down, int left, int right);
+
+#define BUTTON_PIN_MASK (BTN_UP_Pin | BTN_DOWN_Pin | BTN_LEFT_Pin | BTN_RIGHT_Pin)
+
+/* The buttons are the consecutive pins PD4..PD7 (UP, DOWN, LEFT, RIGHT) */
+#define BUTTON_PORT_SHIFT 4U
+
+/* An edge stamp older than this belongs to bouncing after the last change */
+#define BUTTON_EDGE_WINDOW_MS 50U
+
+static const uint16_t button_pins[BUTTON_COUNT] = {BTN_UP_Pin, BTN_DOWN_Pin, BTN_LEFT_Pin, BTN_RIGHT_Pin};
+
+/* Port nibble (active low, bit n = PD(4+n)) to button mask: one lookup instead of a test per pin */
+static const uint8_t button_decode[16] = {
+    0x0F, 0x0E, 0x0D, 0x0C, 0x0B, 0x0A, 0x09, 0x08,
+    0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00};
+
+static const ButtonEngineConfig engine_config = {
+    BUTTON_COUNT, BUTTON_DEBOUNCE_MS, BUTTON_HOLD_MS, BUTTON_REPEAT_MS};
+
+static const ButtonChordConfig engine_chords[] = {
+    /* BUTTON_CHORD_RESET */
+    {(1U << BUTTON_UP) | (1U << BUTTON_DOWN) | (1U << BUTTON_LEFT) | (1U << BUTTON_RIGHT), BUTTON_RESET_HOLD_MS},
+};
+
+static ButtonEngine engine;
+static volatile uint8_t engine_ready = 0;
+
+/* One byte per button: written by EXTI and TIM6 without read-modify-write */
+static volatile uint8_t edge_pending[BUTTON_COUNT];
+static volatile uint32_t edge_cycles[BUTTON_COUNT];
+static volatile uint32_t press_cycles[BUTTON_COUNT];
+static volatile uint8_t press_pending = 0;
+static uint32_t edge_window_cycles = 0;
+static uint32_t sample_period_cycles = 0;
+static uint32_t last_sample_cycles = 0;
+static ButtonLatencyStats latency_stats;
+static ButtonSampleStats sample_stats;
+
+/**
+ * @brief Reconfigure the button pins for EXTI and start the engine
+ */
+void ButtonInput_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    edge_window_cycles = (SystemCoreClock / 1000U) * BUTTON_EDGE_WINDOW_MS;
+    sample_period_cycles = SystemCoreClock / 1000U;
+    ButtonEngine_Init(&engine, &engine_config, engine_chords,
+                      (uint8_t)(sizeof(engine_chords) / sizeof(engine_chords[0])));
+    engine_ready = 1;
+
+    /* Buttons are active LOW with pull-up, both edges matter */
+    GPIO_InitStruct.Pin = BUTTON_PIN_MASK;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    HAL_GPIO_Init(GPIOD, &GPIO_InitStruct);
+
+    /* Same priority as the other FreeRTOS-aware interrupts */
+    HAL_NVIC_SetPriority(EXTI4_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(EXTI4_IRQn);
+    HAL_NVIC_SetPriority(EXTI9_5_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+}
+
+/**
+ * @brief Stamp the first edge of a change, count the rest as bounces
+ */
+void ButtonInput_HandleEdge(uint16_t pin)
+{
+    uint32_t now = PerfCounter_GetCycles();
+    uint32_t i;
+
+    for (i = 0; i < BUTTON_COUNT; i++)
+    {
+        if (pin != button_pins[i])
+        {
+            continue;
+        }
+
+        if (edge_pending[i] && now - edge_cycles[i] < edge_window_cycles)
+        {
+            latency_stats.bounces++;
+            return;
+        }
+        edge_cycles[i] = now;
+        edge_pending[i] = 1;
+        return;
+    }
+}
+
+/**
+ * @brief Take the stamps of the presses the engine just accepted
+ * @retval Mask of the buttons that were pressed
+ */
+static uint8_t ButtonInput_StampPresses(uint8_t changed, uint8_t state, uint32_t now)
+{
+    uint8_t pressed = 0;
+    uint32_t i;
+
+    for (i = 0; i < BUTTON_COUNT; i++)
+    {
+        uint8_t mask = (uint8_t)(1U << i);
+
+        if ((changed & mask) == 0U)
+        {
+            continue;
+        }
+        if (state & mask)
+        {
+            /* No recent edge (missed, or stale from bouncing): stamp now */
+            uint32_t stamp = (edge_pending[i] && now - edge_cycles[i] < edge_window_cycles) ? edge_cycles[i] : now;
+            press_cycles[i] = stamp;
+            press_pending |= mask;
+            pressed |= mask;
+            latency_stats.presses++;
+            LatencyProbe_Press(stamp, (uint8_t)i);
+        }
+        edge_pending[i] = 0;
+    }
+    return pressed;
+}
+
+#if !BUTTON_INPUT_POLLED
+/**
+ * @brief Hand new presses to the GUI oldest edge first, each with its edge
+ *        time on the HAL tick clock (Snake_GetTickMs)
+ */
+static void ButtonInput_DeliverPresses(uint8_t pressed, uint32_t now)
+{
+    uint32_t now_ms = HAL_GetTick();
+
+    while (pressed != 0U)
+    {
+        uint32_t oldest = BUTTON_COUNT;
+        uint32_t i;
+
+        for (i = 0; i < BUTTON_COUNT; i++)
+        {
+            if ((pressed & (1U << i)) != 0U &&
+                (oldest == BUTTON_COUNT || (int32_t)(press_cycles[i] - press_cycles[oldest]) < 0))
+            {
+                oldest = i;
+            }
+        }
+        pressed &= (uint8_t)~(1U << oldest);
+        Snake_ButtonPressed((int)oldest, now_ms - PerfCounter_CyclesToUs(now - press_cycles[oldest]) / 1000U);
+    }
+}
+#endif
+
+/**
+ * @brief One read of the port, one table lookup, one engine sample
+ */
+void ButtonInput_Tick(void)
+{
+    uint32_t start = PerfCounter_GetCycles();
+    uint32_t idr = GPIOD->IDR;
+    uint32_t jitter, cost;
+    uint8_t before, after;
+
+    if (!engine_ready)
+    {
+        return;
+    }
+
+    before = ButtonEngine_GetState(&engine);
+    after = ButtonEngine_Sample(&engine, button_decode[(idr >> BUTTON_PORT_SHIFT) & 0x0FU]);
+    if (after != before)
+    {
+        uint8_t pressed = ButtonInput_StampPresses((uint8_t)(before ^ after), after, start);
+#if !BUTTON_INPUT_POLLED
+        /* Presses before levels, so a GUI tick that sees a level also has its press */
+        ButtonInput_DeliverPresses(pressed, start);
+        Snake_SetButtonLevels((after >> BUTTON_UP) & 1, (after >> BUTTON_DOWN) & 1,
+                              (after >> BUTTON_LEFT) & 1, (after >> BUTTON_RIGHT) & 1);
+#else
+        (void)pressed;
+#endif
+    }
+
+    /* Deviation from the nominal period, then the cost of this sample */
+    if (sample_stats.samples > 0U)
+    {
+        uint32_t period = start - last_sample_cycles;
+        jitter = period > sample_period_cycles ? period - sample_period_cycles : sample_period_cycles - period;
+        if (jitter > sample_stats.maxJitterCycles)
+        {
+            sample_stats.maxJitterCycles = jitter;
+        }
+    }
+    last_sample_cycles = start;
+
+    cost = PerfCounter_GetCycles() - start;
+    sample_stats.samples++;
+    sample_stats.lastCycles = cost;
+    sample_stats.totalCycles += cost;
+    if (cost > sample_stats.maxCycles)
+    {
+        sample_stats.maxCycles = cost;
+    }
+}
+
+/**
+ * @brief Oldest engine event, for the default task
+ */
+int ButtonInput_PopEvent(ButtonEvent *event)
+{
+    return ButtonEngine_PopEvent(&engine, event);
+}
+
+/**
+ * @brief Debounced levels, bit n for button n
+ */
+uint8_t ButtonInput_GetState(void)
+{
+    return ButtonEngine_GetState(&engine);
+}
+
+/**
+ * @brief Account the time from the press edge to now, once per press
+ */
+void ButtonInput_PressHandled(uint8_t button)
+{
+    uint8_t mask = (uint8_t)(1U << button);
+    uint32_t now = PerfCounter_GetCycles();
+    uint32_t us;
+
+    if (button >= BUTTON_COUNT)
+    {
+        return;
+    }
+
+    __disable_irq();
+    if ((press_pending & mask) == 0U)
+    {
+        __enable_irq();
+        return;
+    }
+    press_pending &= (uint8_t)~mask;
+    us = PerfCounter_CyclesToUs(now - press_cycles[button]);
+    __enable_irq();
+
+    latency_stats.samples++;
+    latency_stats.lastUs = us;
+    latency_stats.totalUs += us;
+    if (us > latency_stats.maxUs)
+    {
+        latency_stats.maxUs = us;
+    }
+}
+
+/**
+ * @brief Latency statistics, also readable with the debugger
+ */
+const ButtonLatencyStats *ButtonInput_GetLatencyStats(void)
+{
+    return &latency_stats;
+}
+
+/**
+ * @brief Clear the latency statistics
+ */
+void ButtonInput_ResetLatencyStats(void)
+{
+    __disable_irq();
+    latency_stats.samples = 0;
+    latency_stats.lastUs = 0;
+    latency_stats.maxUs = 0;
+    latency_stats.totalUs = 0;
+    latency_stats.presses = 0;
+    latency_stats.bounces = 0;
+    __enable_irq();
+}
+
+/**
+ * @brief Sampling statistics, also readable with the debugger
+ */
+const ButtonSampleStats *ButtonInput_GetSampleStats(void)
+{
+    return &sample_stats;
+}
+
+/**
+ * @brief Clear the sampling statistics
+ */
+void ButtonInput_ResetSampleStats(void)
+{
+    __disable_irq();
+    sample_stats.samples = 0;
+    sample_stats.lastCycles = 0;
+    sample_stats.maxCycles = 0;
+    sample_stats.totalCycles = 0;
+    sample_stats.maxJitterCycles = 0;
+    __enable_irq();
+}
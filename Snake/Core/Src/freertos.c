@@ -25,6 +25,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "perf_counter.h"
 
 /* USER CODE END Includes */
 
@@ -53,6 +54,38 @@
    
 /* USER CODE END FunctionPrototypes */
 
+/* Hook prototypes */
+void vApplicationIdleHook(void);
+void vApplicationStackOverflowHook(xTaskHandle xTask, signed char *pcTaskName);
+
+/* USER CODE BEGIN 2 */
+void vApplicationIdleHook( void )
+{
+   /* vApplicationIdleHook() will only be called if configUSE_IDLE_HOOK is set
+   to 1 in FreeRTOSConfig.h. It will be called on each iteration of the idle
+   task. The GUI task blocks on vsync and only renders when something was
+   invalidated, so between frames the core sleeps here until the next
+   interrupt; the sleeping time is what PerfCounter reports as idle. */
+   PerfCounter_IdleSleep();
+}
+/* USER CODE END 2 */
+
+/* USER CODE BEGIN 4 */
+void vApplicationStackOverflowHook(xTaskHandle xTask, signed char *pcTaskName)
+{
+   /* Run time stack overflow checking is performed if
+   configCHECK_FOR_STACK_OVERFLOW is defined to 1 or 2. This hook function is
+   called if a stack overflow is detected. Stop here instead of running on with
+   a corrupted heap; pcTaskName names the task in the debugger. */
+   (void)xTask;
+   (void)pcTaskName;
+   taskDISABLE_INTERRUPTS();
+   for (;;)
+   {
+   }
+}
+/* USER CODE END 4 */
+
 /* Private application code --------------------------------------------------*/
 /* USER CODE BEGIN Application */
      
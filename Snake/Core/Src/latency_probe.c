@@ -0,0 +1,358 @@
+/**
+ ******************************************************************************
+ * @file           : latency_probe.c
+ * @brief          : Input to photon latency ring, histogram and UART report
+ ******************************************************************************
+ */
+
+#include "latency_probe.h"
+#include "main.h"
+#include "perf_counter.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+/* Snake game button interface - declared in SnakeInterface.h */
+extern void Snake_InjectButtonPress(int direction);
+
+#define LATENCY_UART_BAUD 115200U
+#define LATENCY_TX_BUFFER 768U /* One whole report */
+#define LATENCY_TIMEOUT_MS 1000U
+
+typedef enum
+{
+    PROBE_IDLE = 0,
+    PROBE_PRESSED,
+    PROBE_APPLIED,
+    PROBE_RENDERED
+} ProbeState;
+
+typedef struct
+{
+    uint32_t stageUs[LATENCY_STAGE_COUNT];
+} LatencySample;
+
+static volatile uint8_t probe_state = PROBE_IDLE;
+static volatile uint32_t press_cycles = 0;
+static volatile uint8_t press_direction = 0;
+static uint32_t applied_cycles = 0;
+static uint32_t rendered_cycles = 0;
+static uint16_t head_line = 0;
+
+static uint32_t last_vsync_cycles = 0;
+static uint32_t frame_period_cycles = 0;
+
+static LatencySample ring[LATENCY_RING_SIZE];
+static uint32_t histogram[LATENCY_HISTOGRAM_BINS];
+static uint32_t samples_total = 0;
+static uint32_t samples_dropped = 0;
+static uint32_t samples_reported = 0;
+
+/* Report text, sent from the USART1 TXE interrupt */
+static char tx_buffer[LATENCY_TX_BUFFER];
+static volatile uint16_t tx_length = 0;
+static volatile uint16_t tx_position = 0;
+
+/**
+ * @brief USART1 TX on PA9; register level, the HAL UART driver is not part of the build
+ */
+void LatencyProbe_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_USART1_CLK_ENABLE();
+
+    GPIO_InitStruct.Pin = GPIO_PIN_9;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    GPIO_InitStruct.Alternate = GPIO_AF7_USART1;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+    /* 16x oversampling: BRR holds PCLK2 / baud with 4 fraction bits */
+    USART1->BRR = (HAL_RCC_GetPCLK2Freq() + LATENCY_UART_BAUD / 2U) / LATENCY_UART_BAUD;
+    USART1->CR1 = USART_CR1_UE | USART_CR1_TE;
+
+    HAL_NVIC_SetPriority(USART1_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
+}
+
+/**
+ * @brief Cycles until the beam reaches a row of the active area, 0 without LTDC timing
+ */
+static uint32_t LatencyProbe_CyclesToLine(uint16_t line)
+{
+    uint32_t totalLines = (LTDC->TWCR & LTDC_TWCR_TOTALH) + 1U;
+    uint32_t firstActive = (LTDC->BPCR & LTDC_BPCR_AVBP) + 1U;
+    uint32_t current = LTDC->CPSR & LTDC_CPSR_CYPOS;
+
+    if (frame_period_cycles == 0U || totalLines <= 1U)
+    {
+        return 0U;
+    }
+    return ((firstActive + line + totalLines - current) % totalLines) * (frame_period_cycles / totalLines);
+}
+
+/**
+ * @brief Store a finished sample
+ */
+static void LatencyProbe_Complete(uint32_t visible_cycles)
+{
+    LatencySample *sample = &ring[samples_total % LATENCY_RING_SIZE];
+    uint32_t displayMs;
+    uint32_t bin;
+
+    sample->stageUs[LATENCY_INPUT] = PerfCounter_CyclesToUs(applied_cycles - press_cycles);
+    sample->stageUs[LATENCY_RENDER] = PerfCounter_CyclesToUs(rendered_cycles - applied_cycles);
+    sample->stageUs[LATENCY_SCANOUT] = PerfCounter_CyclesToUs(visible_cycles - rendered_cycles);
+
+    /* Applied to visible: the input stage is quantised by the game step */
+    displayMs = PerfCounter_CyclesToUs(visible_cycles - applied_cycles) / 1000U;
+    bin = displayMs / LATENCY_BIN_MS;
+    if (bin >= LATENCY_HISTOGRAM_BINS)
+    {
+        bin = LATENCY_HISTOGRAM_BINS - 1U;
+    }
+    histogram[bin]++;
+
+    samples_total++;
+    probe_state = PROBE_IDLE;
+}
+
+/**
+ * @brief Give up on a press that was not applied (rejected turn, game over)
+ */
+static void LatencyProbe_CheckTimeout(void)
+{
+    uint32_t timeout = (SystemCoreClock / 1000U) * LATENCY_TIMEOUT_MS;
+
+    if (probe_state != PROBE_IDLE && PerfCounter_GetCycles() - press_cycles > timeout)
+    {
+        samples_dropped++;
+        probe_state = PROBE_IDLE;
+    }
+}
+
+/**
+ * @brief Start following a press unless one is in flight
+ */
+void LatencyProbe_Press(uint32_t cycles, uint8_t direction)
+{
+    if (probe_state == PROBE_IDLE)
+    {
+        press_cycles = cycles;
+        press_direction = direction;
+        probe_state = PROBE_PRESSED;
+    }
+}
+
+/**
+ * @brief Stamp a software press and hand it to the GUI like a button
+ */
+void LatencyProbe_Inject(uint8_t direction)
+{
+    LatencyProbe_Press(PerfCounter_GetCycles(), direction);
+    Snake_InjectButtonPress(direction);
+}
+
+/**
+ * @brief The game applied a turn; the new head is on screen row line. Turns
+ *        queued before the followed press are not its sample
+ */
+void LatencyProbe_Applied(uint16_t line, uint8_t direction)
+{
+    if (probe_state == PROBE_PRESSED && direction == press_direction)
+    {
+        applied_cycles = PerfCounter_GetCycles();
+        head_line = line;
+        probe_state = PROBE_APPLIED;
+    }
+}
+
+/**
+ * @brief A rejected press (180-degree turn, repeat, full queue) never completes
+ */
+void LatencyProbe_Rejected(uint8_t direction)
+{
+    if (probe_state == PROBE_PRESSED && direction == press_direction)
+    {
+        samples_dropped++;
+        probe_state = PROBE_IDLE;
+    }
+}
+
+/**
+ * @brief The frame holding the new head is complete
+ */
+void LatencyProbe_FrameRendered(void)
+{
+    if (probe_state != PROBE_APPLIED)
+    {
+        LatencyProbe_CheckTimeout();
+        return;
+    }
+
+    rendered_cycles = PerfCounter_GetCycles();
+#if SNAKE_SINGLE_FRAMEBUFFER
+    /* Already in the scanned buffer: visible when the beam next reaches the head */
+    LatencyProbe_Complete(rendered_cycles + LatencyProbe_CyclesToLine(head_line));
+#elif SNAKE_PARTIAL_FRAMEBUFFER
+    /* No LTDC; the SPI transfer of the blocks is not included */
+    LatencyProbe_Complete(rendered_cycles);
+#else
+    probe_state = PROBE_RENDERED;
+#endif
+}
+
+/**
+ * @brief Measure the frame period; with two framebuffers the rendered frame is shown from now
+ */
+void LatencyProbe_VSync(void)
+{
+    uint32_t now = PerfCounter_GetCycles();
+
+    if (last_vsync_cycles != 0U)
+    {
+        frame_period_cycles = now - last_vsync_cycles;
+    }
+    last_vsync_cycles = now;
+
+    if (probe_state == PROBE_RENDERED)
+    {
+        LatencyProbe_Complete(now + LatencyProbe_CyclesToLine(head_line));
+        return;
+    }
+    LatencyProbe_CheckTimeout();
+}
+
+/**
+ * @brief Averages and maxima over the ring, histogram since the last reset
+ */
+void LatencyProbe_GetSummary(LatencySummary *summary)
+{
+    uint32_t count = samples_total < LATENCY_RING_SIZE ? samples_total : LATENCY_RING_SIZE;
+    uint32_t i, stage;
+
+    summary->samples = samples_total;
+    summary->dropped = samples_dropped;
+    for (stage = 0; stage < LATENCY_STAGE_COUNT; stage++)
+    {
+        uint32_t sum = 0;
+        uint32_t max = 0;
+        for (i = 0; i < count; i++)
+        {
+            uint32_t us = ring[i].stageUs[stage];
+            sum += us;
+            if (us > max)
+            {
+                max = us;
+            }
+        }
+        summary->avgUs[stage] = count ? sum / count : 0U;
+        summary->maxUs[stage] = max;
+    }
+    for (i = 0; i < LATENCY_HISTOGRAM_BINS; i++)
+    {
+        summary->histogram[i] = histogram[i];
+    }
+}
+
+/**
+ * @brief Start over, e.g. when the latency test is switched on
+ */
+void LatencyProbe_Reset(void)
+{
+    uint32_t i;
+
+    probe_state = PROBE_IDLE;
+    samples_total = 0;
+    samples_dropped = 0;
+    samples_reported = 0;
+    for (i = 0; i < LATENCY_HISTOGRAM_BINS; i++)
+    {
+        histogram[i] = 0;
+    }
+}
+
+/**
+ * @brief Append formatted text to the report, cut off when the buffer is full
+ */
+static void LatencyProbe_Print(const char *format, ...)
+{
+    va_list args;
+    int written;
+
+    if (tx_length >= LATENCY_TX_BUFFER - 1U)
+    {
+        return;
+    }
+    va_start(args, format);
+    written = vsnprintf(&tx_buffer[tx_length], LATENCY_TX_BUFFER - tx_length, format, args);
+    va_end(args);
+    if (written > 0)
+    {
+        uint32_t end = tx_length + (uint32_t)written;
+        tx_length = (uint16_t)(end < LATENCY_TX_BUFFER ? end : LATENCY_TX_BUFFER - 1U);
+    }
+}
+
+/**
+ * @brief One byte per TXE interrupt until the report is out
+ */
+void LatencyProbe_UARTIRQHandler(void)
+{
+    if ((USART1->SR & USART_SR_TXE) == 0U)
+    {
+        return;
+    }
+    if (tx_position < tx_length)
+    {
+        USART1->DR = (uint8_t)tx_buffer[tx_position++];
+    }
+    if (tx_position >= tx_length)
+    {
+        USART1->CR1 &= ~USART_CR1_TXEIE;
+    }
+}
+
+/**
+ * @brief Print stage averages/maxima and the histogram when enough new samples arrived
+ */
+void LatencyProbe_Report(void)
+{
+    static const char *const names[LATENCY_STAGE_COUNT] = {"input", "render", "scanout"};
+    /* Static: only the default task reports, and its stack is small */
+    static LatencySummary summary;
+    uint32_t i;
+
+    /* The previous report is still going out: try again later */
+    if (samples_total - samples_reported < LATENCY_REPORT_SAMPLES || tx_position < tx_length)
+    {
+        return;
+    }
+    samples_reported = samples_total;
+
+    LatencyProbe_GetSummary(&summary);
+    tx_length = 0;
+    tx_position = 0;
+    LatencyProbe_Print("latency: %lu samples, %lu dropped\r\n",
+                       (unsigned long)summary.samples, (unsigned long)summary.dropped);
+
+    for (i = 0; i < LATENCY_STAGE_COUNT; i++)
+    {
+        LatencyProbe_Print("  %-8s avg %6lu us  max %6lu us\r\n", names[i],
+                           (unsigned long)summary.avgUs[i], (unsigned long)summary.maxUs[i]);
+    }
+
+    LatencyProbe_Print("  display latency (render + scanout):\r\n");
+    for (i = 0; i < LATENCY_HISTOGRAM_BINS - 1U; i++)
+    {
+        LatencyProbe_Print("  %3lu-%3lu ms %6lu\r\n", (unsigned long)(i * LATENCY_BIN_MS),
+                           (unsigned long)((i + 1U) * LATENCY_BIN_MS), (unsigned long)summary.histogram[i]);
+    }
+    LatencyProbe_Print("  %3lu+    ms %6lu\r\n", (unsigned long)(i * LATENCY_BIN_MS),
+                       (unsigned long)summary.histogram[i]);
+
+    /* The interrupt takes it from here (about 40 ms at 115200 baud) */
+    USART1->CR1 |= USART_CR1_TXEIE;
+}
@@ -25,11 +25,20 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "Components/ili9341/ili9341.h"
+#include "adpcm.h"
 #include "audio_data.h"
+#include "audio_engine.h"
+#include "button_input.h"
 #include "flash_storage.h"
+#include "latency_probe.h"
+#include "perf_counter.h"
 
 /* Snake game button interface - declared in SnakeInterface.h */
 extern void Snake_UpdateButtonStates(int up, int down, int left, int right);
+extern void Snake_InjectButtonPress(int direction);
+
+/* STMPE811 interrupt, handled in STM32TouchController.cpp */
+extern void TouchController_IRQHandler(void);
 
 /* Buzzer control variables */
 static volatile uint32_t buzzerEndTick = 0;
@@ -39,20 +48,8 @@ static volatile uint32_t musicPlayEndTick = 0;
 #define ISD1820_PLAY_PULSE_MS 100 /* Pulse duration for play button (100ms) */
 
 /* ========== Simple Audio Playback (Embedded Implementation) ========== */
-typedef struct
-{
-  const uint8_t *data;
-  uint32_t size;
-  uint32_t position;
-  uint32_t sample_rate;
-  uint8_t channels;
-  uint8_t bits_per_sample;
-  uint8_t is_playing;
-  uint32_t sample_skip;
-} AudioState_t;
-
-static AudioState_t audio_state = {0};
-static TIM_HandleTypeDef *htim_audio_ptr = NULL;
+/* Game over sound, IMA-ADPCM at the engine rate (tools/audio_adpcm.py) */
+static AdpcmDecoder audio_decoder;
 /* ====================================================================== */
 
 /* USER CODE END Includes */
@@ -110,7 +107,7 @@ TIM_HandleTypeDef htim7;
 osThreadId_t defaultTaskHandle;
 const osThreadAttr_t defaultTask_attributes = {
     .name = "defaultTask",
-    .stack_size = 128 * 4,
+    .stack_size = 512 * 4,
     .priority = (osPriority_t)osPriorityNormal,
 };
 /* Definitions for GUI_Task */
@@ -165,12 +162,15 @@ uint8_t IOE_Read(uint8_t Addr, uint8_t Reg);
 uint16_t IOE_ReadMultiple(uint8_t Addr, uint8_t Reg, uint8_t *pBuffer, uint16_t Length);
 
 /* SimpleAudio function prototypes */
-int SimpleAudio_Init(TIM_HandleTypeDef *htim);
+int SimpleAudio_Init(void);
 int SimpleAudio_PlayGameOver(void);
 void SimpleAudio_Stop(void);
 int SimpleAudio_IsPlaying(void);
 void SimpleAudio_TimerCallback(TIM_HandleTypeDef *htim);
 
+/* Snake game output interface */
+void Snake_PlayBuzzer(int durationMs);
+
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -205,6 +205,8 @@ int main(void)
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
+  /* DWT cycle counter for render/DMA2D timing */
+  PerfCounter_Init();
 
   /* USER CODE END SysInit */
 
@@ -219,7 +221,7 @@ int main(void)
   MX_TIM7_Init();
 
   /* Initialize simple audio module */
-  SimpleAudio_Init(&htim7);
+  SimpleAudio_Init();
 
   /* Initialize Flash storage for highscore persistence */
   FlashStorage_Init();
@@ -229,6 +231,9 @@ int main(void)
   MX_TouchGFX_PreOSInit();
   /* USER CODE BEGIN 2 */
 
+  /* Latency reports go out on USART1 (ST-LINK virtual COM port) */
+  LatencyProbe_Init();
+
   /* ========== BURN AUDIO TO ISD1820 - RUN ONCE ========== */
   /* IMPORTANT:
    * 1. Connect: PE8 → 1kΩ resistor → ISD1820 MIC
@@ -573,7 +578,10 @@ static void MX_FMC_Init(void)
 {
 
   /* USER CODE BEGIN FMC_Init 0 */
-
+#if SNAKE_PARTIAL_FRAMEBUFFER
+  /* SRAM-only build: the SDRAM is neither clocked nor initialised */
+  return;
+#endif
   /* USER CODE END FMC_Init 0 */
 
   FMC_SDRAM_TimingTypeDef SdramTiming = {0};
@@ -819,8 +827,18 @@ void IOE_Init(void)
  */
 void IOE_ITConfig(void)
 {
-  // Dummy function called when initializing to stmpe811 to setup interupt for the i2c.
-  // The interupt is not used in our case, therefore nothing is done here.
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+  /* The STMPE811 pulls TP_INT low while an interrupt status bit is set */
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  GPIO_InitStruct.Pin = TP_INT_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+  HAL_GPIO_Init(TP_INT_GPIO_Port, &GPIO_InitStruct);
+
+  HAL_NVIC_SetPriority(EXTI15_10_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
 }
 
 /**
@@ -1066,6 +1084,20 @@ void LCD_Delay(uint32_t Delay)
   HAL_Delay(Delay);
 }
 
+/**
+ * @brief  EXTI line detection callback
+ * @param  GPIO_Pin: Pin of the interrupting line
+ */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+  if (GPIO_Pin == TP_INT_Pin)
+  {
+    TouchController_IRQHandler();
+    return;
+  }
+  ButtonInput_HandleEdge(GPIO_Pin);
+}
+
 /* USER CODE END 4 */
 
 /* USER CODE BEGIN Header_StartDefaultTask */
@@ -1080,62 +1112,45 @@ void StartDefaultTask(void *argument)
   /* USER CODE BEGIN 5 */
   /* Infinite loop */
 
-  /* Variables for highscore reset detection */
-  static uint32_t allButtonsPressedTime = 0;
-  const uint32_t RESET_HOLD_TIME_MS = 3000; /* Hold all buttons for 3 seconds to reset */
+  /* Second beep of the highscore reset confirmation, 0 = none scheduled */
+  uint32_t resetBeepTick = 0;
+  ButtonEvent event;
+
+  /* Buttons are sampled from the TIM6 interrupt from here on; the GUI exists, so they can be delivered */
+  ButtonInput_Init();
 
   for (;;)
   {
-    /* Read button states (buttons are active LOW with pull-up) */
-    /* Pressed = LOW (0), Not pressed = HIGH (1) */
-    int btnUp = (HAL_GPIO_ReadPin(BTN_UP_GPIO_Port, BTN_UP_Pin) == GPIO_PIN_RESET) ? 1 : 0;
-    int btnDown = (HAL_GPIO_ReadPin(BTN_DOWN_GPIO_Port, BTN_DOWN_Pin) == GPIO_PIN_RESET) ? 1 : 0;
-    int btnLeft = (HAL_GPIO_ReadPin(BTN_LEFT_GPIO_Port, BTN_LEFT_Pin) == GPIO_PIN_RESET) ? 1 : 0;
-    int btnRight = (HAL_GPIO_ReadPin(BTN_RIGHT_GPIO_Port, BTN_RIGHT_Pin) == GPIO_PIN_RESET) ? 1 : 0;
-
-    /* Check if all 4 buttons are pressed simultaneously to reset highscore */
-    if (btnUp && btnDown && btnLeft && btnRight)
+    while (ButtonInput_PopEvent(&event))
     {
-      if (allButtonsPressedTime == 0)
-      {
-        /* Start timing */
-        allButtonsPressedTime = HAL_GetTick();
-      }
-      else if ((HAL_GetTick() - allButtonsPressedTime) >= RESET_HOLD_TIME_MS)
+      if (event.type == BUTTON_EVENT_CHORD && event.id == BUTTON_CHORD_RESET)
       {
         /* All buttons held for 3 seconds - reset highscore */
         FlashStorage_EraseAll();
 
-        /* Play buzzer to confirm reset */
-        HAL_GPIO_WritePin(GPIOG, GPIO_PIN_13, GPIO_PIN_SET);
-        HAL_Delay(200);
-        HAL_GPIO_WritePin(GPIOG, GPIO_PIN_13, GPIO_PIN_RESET);
-        HAL_Delay(100);
-        HAL_GPIO_WritePin(GPIOG, GPIO_PIN_13, GPIO_PIN_SET);
-        HAL_Delay(200);
-        HAL_GPIO_WritePin(GPIOG, GPIO_PIN_13, GPIO_PIN_RESET);
-
-        /* Reset timer */
-        allButtonsPressedTime = 0;
-
-        /* Wait for buttons to be released */
-        while (HAL_GPIO_ReadPin(BTN_UP_GPIO_Port, BTN_UP_Pin) == GPIO_PIN_RESET ||
-               HAL_GPIO_ReadPin(BTN_DOWN_GPIO_Port, BTN_DOWN_Pin) == GPIO_PIN_RESET ||
-               HAL_GPIO_ReadPin(BTN_LEFT_GPIO_Port, BTN_LEFT_Pin) == GPIO_PIN_RESET ||
-               HAL_GPIO_ReadPin(BTN_RIGHT_GPIO_Port, BTN_RIGHT_Pin) == GPIO_PIN_RESET)
-        {
-          osDelay(50);
-        }
+        /* Double beep to confirm reset: 200 ms, 100 ms pause, 200 ms */
+        Snake_PlayBuzzer(200);
+        resetBeepTick = HAL_GetTick() + 300;
+      }
+      else if (event.type == BUTTON_EVENT_REPEAT)
+      {
+        /* Holding a single direction keeps pressing it */
+        Snake_InjectButtonPress(event.id);
       }
     }
-    else
+
+    if (resetBeepTick > 0 && HAL_GetTick() >= resetBeepTick)
     {
-      /* Reset timer if not all buttons pressed */
-      allButtonsPressedTime = 0;
+      Snake_PlayBuzzer(200);
+      resetBeepTick = 0;
     }
 
-    /* Update TouchGFX Model with button states */
-    Snake_UpdateButtonStates(btnUp, btnDown, btnLeft, btnRight);
+#if BUTTON_INPUT_POLLED
+    /* Update TouchGFX Model with the debounced button states */
+    uint8_t buttons = ButtonInput_GetState();
+    Snake_UpdateButtonStates((buttons >> BUTTON_UP) & 1, (buttons >> BUTTON_DOWN) & 1,
+                             (buttons >> BUTTON_LEFT) & 1, (buttons >> BUTTON_RIGHT) & 1);
+#endif
 
     /* Update buzzer state - turn off if duration elapsed */
     if (buzzerEndTick > 0 && HAL_GetTick() >= buzzerEndTick)
@@ -1144,10 +1159,13 @@ void StartDefaultTask(void *argument)
       buzzerEndTick = 0;
     }
 
+    /* Queue the latency summary once enough samples came in (sent by the USART1 interrupt) */
+    LatencyProbe_Report();
+
     /* ISD1820 PLAY pin is now controlled directly in Snake_PlayMusic() with HAL_Delay */
     /* No need for timer-based release anymore */
 
-    /* Delay for debouncing */
+    /* Event, buzzer and report period (and button delivery when BUTTON_INPUT_POLLED) */
     osDelay(20);
   }
   /* USER CODE END 5 */
@@ -1158,52 +1176,36 @@ void StartDefaultTask(void *argument)
 /**
  * @brief Initialize simple audio module
  */
-int SimpleAudio_Init(TIM_HandleTypeDef *htim)
+int SimpleAudio_Init(void)
 {
-  if (htim == NULL)
-    return -1;
-
-  htim_audio_ptr = htim;
-  audio_state.is_playing = 0;
-  audio_state.position = 0;
+  AudioEngine_Init();
 
   return 0;
 }
 
+/**
+ * @brief Audio engine source: decode the next samples of the game over sound
+ */
+static uint32_t SimpleAudio_Fill(int16_t *samples, uint32_t count)
+{
+  return Adpcm_Decode(&audio_decoder, samples, count);
+}
+
 /**
  * @brief Start playing game over audio
  */
 int SimpleAudio_PlayGameOver(void)
 {
-  if (audio_state.is_playing)
+  if (AudioEngine_IsPlaying())
   {
     return -1; /* Already playing */
   }
 
-  /* Setup audio state */
-  audio_state.data = gameOverAudioData;
-  audio_state.size = gameOverAudioSize;
-  audio_state.position = 0;
-  audio_state.sample_rate = gameOverAudioSampleRate;
-  audio_state.channels = gameOverAudioChannels;
-  audio_state.bits_per_sample = gameOverAudioBitsPerSample;
-
-  /* Downsample 44100 Hz -> 8000 Hz */
-  audio_state.sample_skip = audio_state.sample_rate / 8000;
-  if (audio_state.sample_skip < 1)
-    audio_state.sample_skip = 1;
-
-  audio_state.is_playing = 1;
-
-  /* Start timer interrupt at 8kHz */
-  if (htim_audio_ptr != NULL)
-  {
-    htim_audio_ptr->Instance->PSC = 89;  /* 90MHz / 90 = 1MHz */
-    htim_audio_ptr->Instance->ARR = 124; /* 1MHz / 125 = 8kHz */
-    HAL_TIM_Base_Start_IT(htim_audio_ptr);
-  }
+  /* Stored at the engine rate, no resampling at runtime */
+  Adpcm_Init(&audio_decoder, gameOverAudioData, gameOverAudioSamples);
 
-  return 0;
+  /* Stream at 8kHz (DMA, or TIM7 interrupts with AUDIO_PER_SAMPLE_ISR) */
+  return AudioEngine_Play(SimpleAudio_Fill);
 }
 
 /**
@@ -1211,16 +1213,8 @@ int SimpleAudio_PlayGameOver(void)
  */
 void SimpleAudio_Stop(void)
 {
-  if (htim_audio_ptr != NULL)
-  {
-    HAL_TIM_Base_Stop_IT(htim_audio_ptr);
-  }
-
-  audio_state.is_playing = 0;
-  audio_state.position = 0;
-
-  /* Turn off buzzer */
-  HAL_GPIO_WritePin(GPIOG, GPIO_PIN_13, GPIO_PIN_RESET);
+  /* Also turns off the buzzer */
+  AudioEngine_Stop();
 }
 
 /**
@@ -1228,53 +1222,18 @@ void SimpleAudio_Stop(void)
  */
 int SimpleAudio_IsPlaying(void)
 {
-  return audio_state.is_playing;
+  return AudioEngine_IsPlaying();
 }
 
 /**
- * @brief Timer callback for audio playback
+ * @brief Timer callback for audio playback (per-sample path only)
  */
 void SimpleAudio_TimerCallback(TIM_HandleTypeDef *htim)
 {
-  if (!audio_state.is_playing || htim != htim_audio_ptr)
-  {
-    return;
-  }
-
-  /* Check if we've reached the end */
-  if (audio_state.position >= audio_state.size)
-  {
-    SimpleAudio_Stop();
-    return;
-  }
-
-  /* Get current sample (16-bit) */
-  int16_t sample = 0;
-  if (audio_state.bits_per_sample == 16 && audio_state.position + 1 < audio_state.size)
-  {
-    /* Read 16-bit sample (little endian) */
-    sample = (int16_t)(audio_state.data[audio_state.position] |
-                       (audio_state.data[audio_state.position + 1] << 8));
-  }
-  else if (audio_state.position < audio_state.size)
+  if (htim->Instance == TIM7)
   {
-    /* 8-bit sample fallback */
-    sample = (int16_t)((audio_state.data[audio_state.position] - 128) << 8);
+    AudioEngine_SampleTick();
   }
-
-  /* Simple 1-bit DAC: Turn on buzzer if sample > 0, off if < 0 */
-  if (sample > 0)
-  {
-    HAL_GPIO_WritePin(GPIOG, GPIO_PIN_13, GPIO_PIN_SET);
-  }
-  else
-  {
-    HAL_GPIO_WritePin(GPIOG, GPIO_PIN_13, GPIO_PIN_RESET);
-  }
-
-  /* Advance position (with downsampling) */
-  uint32_t bytes_per_sample = audio_state.bits_per_sample / 8;
-  audio_state.position += bytes_per_sample * audio_state.sample_skip;
 }
 
 /* ====================================================================== */
@@ -1382,6 +1341,18 @@ void Snake_SaveHighScore(uint16_t score)
   FlashStorage_SaveHighScore(score);
 }
 
+/**
+ * @brief  Get CPU load and rendered frames since the previous call
+ * @param  cpuLoadPermille: Busy time in 1/1000 of the interval
+ * @param  framesRendered: Frames rendered by the GUI task
+ * @param  elapsedMs: Length of the interval in milliseconds
+ * @retval None
+ */
+void Snake_GetLoadStats(uint16_t *cpuLoadPermille, uint32_t *framesRendered, uint32_t *elapsedMs)
+{
+  PerfCounter_GetLoad(cpuLoadPermille, framesRendered, elapsedMs);
+}
+
 /**
  * @brief  Period elapsed callback in non blocking mode
  * @note   This function is called  when TIM6 interrupt took place, inside
@@ -1400,6 +1371,11 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
     HAL_IncTick();
   }
   /* USER CODE BEGIN Callback 1 */
+  if (htim->Instance == TIM6)
+  {
+    /* 1 kHz button sampling, debouncing and hold/chord timing */
+    ButtonInput_Tick();
+  }
 
   /* Handle audio playback timer - call SimpleAudio callback */
   SimpleAudio_TimerCallback(htim);
@@ -0,0 +1,106 @@
+/**
+ ******************************************************************************
+ * @file           : perf_counter.c
+ * @brief          : DWT cycle counter helpers for performance measurements
+ ******************************************************************************
+ */
+
+#include "perf_counter.h"
+#include "stm32f4xx_hal.h"
+
+static volatile uint32_t idle_cycles = 0;
+static volatile uint32_t idle_cycles_total = 0;
+static volatile uint32_t frames_rendered = 0;
+static uint32_t load_start_cycles = 0;
+static uint32_t load_start_tick = 0;
+
+/**
+ * @brief Enable trace and the DWT cycle counter
+ */
+void PerfCounter_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Convert SYSCLK cycles to microseconds
+ */
+uint32_t PerfCounter_CyclesToUs(uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000U);
+}
+
+/**
+ * @brief Sleep in WFI with interrupts masked, so the time spent in the waking
+ *        ISR is counted as busy and the accumulation cannot be preempted
+ */
+void PerfCounter_IdleSleep(void)
+{
+    uint32_t start;
+    uint32_t slept;
+
+    __disable_irq();
+    start = DWT->CYCCNT;
+    __DSB();
+    __WFI();
+    slept = DWT->CYCCNT - start;
+    idle_cycles += slept;
+    idle_cycles_total += slept;
+    __enable_irq();
+}
+
+/**
+ * @brief Count one rendered frame
+ */
+void PerfCounter_FrameRendered(void)
+{
+    frames_rendered++;
+}
+
+/**
+ * @brief Report and restart the load measurement interval
+ */
+void PerfCounter_GetLoad(uint16_t *load_permille, uint32_t *frames, uint32_t *elapsed_ms)
+{
+    uint32_t now_cycles;
+    uint32_t now_tick;
+    uint32_t counted;
+    uint32_t idle;
+    uint32_t busy;
+    uint64_t wall;
+    uint32_t load = 0;
+
+    __disable_irq();
+    now_cycles = DWT->CYCCNT;
+    now_tick = HAL_GetTick();
+    idle = idle_cycles;
+    idle_cycles = 0;
+    *frames = frames_rendered;
+    frames_rendered = 0;
+    __enable_irq();
+
+    *elapsed_ms = now_tick - load_start_tick;
+
+    /* The counter may stop in sleep, so busy time is what it counted minus the sleep it saw */
+    counted = now_cycles - load_start_cycles;
+    busy = (counted > idle) ? counted - idle : 0;
+    wall = (uint64_t)(*elapsed_ms) * (SystemCoreClock / 1000U);
+    if (wall > 0)
+    {
+        load = (uint32_t)(((uint64_t)busy * 1000U) / wall);
+    }
+    *load_permille = (uint16_t)((load > 1000U) ? 1000U : load);
+
+    load_start_cycles = now_cycles;
+    load_start_tick = now_tick;
+}
+
+/**
+ * @brief Idle cycles since boot, independent of the load reporting interval
+ */
+uint32_t PerfCounter_GetIdleCycles(void)
+{
+    return idle_cycles_total;
+}
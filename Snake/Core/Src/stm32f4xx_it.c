@@ -47,7 +47,11 @@
 
 /* Private function prototypes -----------------------------------------------*/
 /* USER CODE BEGIN PFP */
-
+extern int TileBatchDMA_IRQHandler(void);
+extern void BitmapPreloader_IRQHandler(void);
+extern void DisplaySpi_IRQHandler(void);
+extern void AudioEngine_DMAIRQHandler(void);
+extern void LatencyProbe_UARTIRQHandler(void);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -209,6 +213,11 @@ void LTDC_IRQHandler(void)
 void DMA2D_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA2D_IRQn 0 */
+  /* Batched board blits chain themselves here without going through the HAL */
+  if (TileBatchDMA_IRQHandler())
+  {
+    return;
+  }
 
   /* USER CODE END DMA2D_IRQn 0 */
   HAL_DMA2D_IRQHandler(&hdma2d);
@@ -219,4 +228,62 @@ void DMA2D_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+ * @brief This function handles EXTI line4 interrupt (BTN_UP).
+ */
+void EXTI4_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(BTN_UP_Pin);
+}
+
+/**
+ * @brief This function handles EXTI line[9:5] interrupts (BTN_DOWN, BTN_LEFT, BTN_RIGHT).
+ */
+void EXTI9_5_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(BTN_DOWN_Pin);
+  HAL_GPIO_EXTI_IRQHandler(BTN_LEFT_Pin);
+  HAL_GPIO_EXTI_IRQHandler(BTN_RIGHT_Pin);
+}
+
+/**
+ * @brief This function handles EXTI line[15:10] interrupts (STMPE811 touch controller).
+ */
+void EXTI15_10_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(TP_INT_Pin);
+}
+
+/**
+ * @brief This function handles DMA2 stream0 global interrupt (boot-time bitmap preload).
+ */
+void DMA2_Stream0_IRQHandler(void)
+{
+  BitmapPreloader_IRQHandler();
+}
+
+/**
+ * @brief This function handles DMA2 stream1 global interrupt (TIM8_UP, audio to the buzzer pin).
+ */
+void DMA2_Stream1_IRQHandler(void)
+{
+  AudioEngine_DMAIRQHandler();
+}
+
+/**
+ * @brief This function handles DMA2 stream4 global interrupt (SPI5 TX, partial framebuffer mode).
+ */
+void DMA2_Stream4_IRQHandler(void)
+{
+  DisplaySpi_IRQHandler();
+}
+
+/**
+ * @brief This function handles USART1 global interrupt (latency report).
+ */
+void USART1_IRQHandler(void)
+{
+  LatencyProbe_UARTIRQHandler();
+}
+
 /* USER CODE END 1 */
@@ -0,0 +1,45 @@
+#ifndef BENCHMARKPRESENTER_HPP
+#define BENCHMARKPRESENTER_HPP
+
+#include <gui/model/ModelListener.hpp>
+#include <mvp/Presenter.hpp>
+#include <stdint.h>
+
+using namespace touchgfx;
+
+class BenchmarkView;
+
+class BenchmarkPresenter : public touchgfx::Presenter, public ModelListener
+{
+public:
+    BenchmarkPresenter(BenchmarkView &v);
+
+    /**
+     * The activate function is called automatically when this screen is "switched in"
+     * (ie. made active). Initialization logic can be placed here.
+     */
+    virtual void activate();
+
+    /**
+     * The deactivate function is called automatically when this screen is "switched out"
+     * (ie. made inactive). Teardown functionality can be placed here.
+     */
+    virtual void deactivate();
+
+    virtual ~BenchmarkPresenter() {}
+
+    // Results of the last benchmark run, per difficulty
+    uint16_t getTickRate(Difficulty difficulty);
+    uint16_t getFps(Difficulty difficulty);
+    uint16_t getCpuLoad(Difficulty difficulty); // permille
+
+    // Any button leaves the report
+    virtual void buttonPressed(SnakeDirection dir, uint32_t timeMs);
+
+private:
+    BenchmarkPresenter();
+
+    BenchmarkView &view;
+};
+
+#endif // BENCHMARKPRESENTER_HPP
@@ -0,0 +1,50 @@
+#ifndef BENCHMARKVIEW_HPP
+#define BENCHMARKVIEW_HPP
+
+#include <mvp/View.hpp>
+#include <gui/benchmark_screen/BenchmarkPresenter.hpp>
+#include <gui/common/FrontendApplication.hpp>
+#include <touchgfx/widgets/Box.hpp>
+#include <touchgfx/widgets/TextAreaWithWildcard.hpp>
+
+// Report layout: one line of Small text per row
+#define BENCHMARK_LINE_COUNT 13
+#define BENCHMARK_LINE_LENGTH 40
+#define BENCHMARK_LINE_X 10
+#define BENCHMARK_LINE_Y 20
+#define BENCHMARK_LINE_SPACING 22
+
+/**
+ * Benchmark report, shown after the game screen has played itself through all
+ * difficulties. Lists the framebuffer configuration the firmware was built
+ * with, the tearing/latency result in single framebuffer mode, and the tick
+ * rate, frame rate and CPU load measured at each level.
+ * Not part of the designer project, so it is built in code.
+ */
+class BenchmarkView : public touchgfx::View<BenchmarkPresenter>
+{
+public:
+    BenchmarkView();
+    virtual ~BenchmarkView() {}
+    virtual void setupScreen();
+    virtual void tearDownScreen();
+
+    // Back to the menu
+    void close();
+
+protected:
+    FrontendApplication &application()
+    {
+        return *static_cast<FrontendApplication *>(touchgfx::Application::getInstance());
+    }
+
+    // Fill the report lines
+    void updateReport();
+
+private:
+    touchgfx::Box background;
+    touchgfx::TextAreaWithOneWildcard lines[BENCHMARK_LINE_COUNT];
+    touchgfx::Unicode::UnicodeChar lineBuffers[BENCHMARK_LINE_COUNT][BENCHMARK_LINE_LENGTH];
+};
+
+#endif // BENCHMARKVIEW_HPP
@@ -0,0 +1,38 @@
+#ifndef COUNTDOWNBAR_HPP
+#define COUNTDOWNBAR_HPP
+
+#include <touchgfx/widgets/Widget.hpp>
+#include <touchgfx/hal/Types.hpp>
+
+// Horizontal bar showing the time left of a countdown, shrinking from the right.
+// The fill is computed by SnakeScreen, which also reports the columns whose colour
+// changed, so a running countdown costs a few pixel columns per frame instead of
+// a full redraw. The bar does not invalidate: the caller decides where the change
+// goes (framebuffer or HUD layer).
+class CountdownBar : public touchgfx::Widget
+{
+public:
+    CountdownBar();
+
+    void setColors(touchgfx::colortype bar, touchgfx::colortype background)
+    {
+        barColor = bar;
+        backgroundColor = background;
+    }
+
+    // Number of filled columns from the left
+    void setFilledWidth(int16_t width) { filledWidth = width; }
+
+    // true if column x (relative to the bar) currently shows the bar colour
+    bool isColumnFilled(int16_t x) const { return x < filledWidth; }
+
+    virtual void draw(const touchgfx::Rect &invalidatedArea) const;
+    virtual touchgfx::Rect getSolidRect() const;
+
+private:
+    int16_t filledWidth;
+    touchgfx::colortype barColor;
+    touchgfx::colortype backgroundColor;
+};
+
+#endif // COUNTDOWNBAR_HPP
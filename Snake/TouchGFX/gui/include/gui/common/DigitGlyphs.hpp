@@ -0,0 +1,44 @@
+#ifndef DIGITGLYPHS_HPP
+#define DIGITGLYPHS_HPP
+
+#include <touchgfx/Bitmap.hpp>
+#include <touchgfx/hal/Types.hpp>
+#include <touchgfx/widgets/TextArea.hpp>
+
+// Digits 0-9 of a typography pre-rendered into RGB565 dynamic bitmaps.
+// A set is rendered once, on first use, and kept for the lifetime of the
+// application, so showing a number afterwards is plain fixed-width blits.
+class DigitGlyphs
+{
+public:
+    // Score on the game screen and scores on the game over screen
+    static const uint8_t MAX_SETS = 2;
+
+    // Dynamic bitmaps needed for all sets (reserve in Bitmap::setCache)
+    static const uint8_t BITMAP_COUNT = MAX_SETS * 10;
+
+    // Glyphs in the font and colour of source on the given background,
+    // 0 if they could not be rendered (no bitmap cache or cache full)
+    static const DigitGlyphs *get(const touchgfx::TextArea &source, touchgfx::colortype background);
+
+    touchgfx::BitmapId getGlyph(uint8_t digit) const { return glyphs[digit]; }
+    int16_t getWidth() const { return width; }
+    int16_t getHeight() const { return height; }
+
+private:
+    DigitGlyphs();
+
+    bool render(const touchgfx::TextArea &source, touchgfx::colortype background);
+
+    static DigitGlyphs sets[MAX_SETS];
+    static uint8_t setCount;
+
+    touchgfx::FontId fontId;
+    touchgfx::colortype color;
+    touchgfx::colortype backgroundColor;
+    touchgfx::BitmapId glyphs[10];
+    int16_t width;
+    int16_t height;
+};
+
+#endif // DIGITGLYPHS_HPP
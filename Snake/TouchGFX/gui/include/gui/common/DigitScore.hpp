@@ -0,0 +1,54 @@
+#ifndef DIGITSCORE_HPP
+#define DIGITSCORE_HPP
+
+#include <touchgfx/widgets/Widget.hpp>
+#include <gui/common/DigitGlyphs.hpp>
+
+// Number display built from pre-rendered digit glyphs (DigitGlyphs).
+// A new value needs no formatting or text layout: setValue() compares the
+// digits with the ones shown and reports only the cells that changed. It does
+// not invalidate: the caller decides where the change goes (framebuffer or HUD layer).
+class DigitScore : public touchgfx::Widget
+{
+public:
+    static const uint8_t MAX_DIGITS = 6;
+
+    enum Alignment
+    {
+        ALIGN_LEFT,
+        ALIGN_CENTER
+    };
+
+    DigitScore();
+
+    void setGlyphs(const DigitGlyphs *digitGlyphs, touchgfx::colortype background)
+    {
+        glyphs = digitGlyphs;
+        backgroundColor = background;
+    }
+    bool hasGlyphs() const { return glyphs != 0; }
+
+    void setAlignment(Alignment align) { alignment = align; }
+
+    // Show value; returns the changed area (relative to the widget, empty if nothing changed)
+    touchgfx::Rect setValue(uint32_t value);
+
+    // Copy area (relative to the widget) into an RGB565 buffer whose first pixel is the
+    // widget's top left corner, for targets that are not the framebuffer (e.g. the HUD layer)
+    void drawInto(uint16_t *buffer, uint16_t stride, const touchgfx::Rect &area) const;
+
+    virtual void draw(const touchgfx::Rect &invalidatedArea) const;
+    virtual touchgfx::Rect getSolidRect() const;
+
+private:
+    int16_t digitsX() const;
+    touchgfx::Rect cellRect(uint8_t slot) const;
+
+    const DigitGlyphs *glyphs;
+    touchgfx::colortype backgroundColor;
+    Alignment alignment;
+    uint8_t digits[MAX_DIGITS]; // Most significant first
+    uint8_t count;
+};
+
+#endif // DIGITSCORE_HPP
@@ -23,9 +23,15 @@ public:
     // Go to Screen3 (Game Over screen) - no transition
     void gotoScreen3ScreenNoTransition();
 
+    // Go to the benchmark report (user-defined screen) - no transition
+    void gotoBenchmarkScreenNoTransition();
+
 private:
     void gotoScreen3ScreenNoTransitionImpl();
     touchgfx::Callback<FrontendApplication> screen3TransitionCallback;
+
+    void gotoBenchmarkScreenNoTransitionImpl();
+    touchgfx::Callback<FrontendApplication> benchmarkTransitionCallback;
 };
 
 #endif // FRONTENDAPPLICATION_HPP
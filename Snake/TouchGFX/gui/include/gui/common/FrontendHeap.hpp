@@ -2,17 +2,19 @@
 #define FRONTENDHEAP_HPP
 
 #include <gui_generated/common/FrontendHeapBase.hpp>
+#include <gui/benchmark_screen/BenchmarkView.hpp>
+#include <gui/benchmark_screen/BenchmarkPresenter.hpp>
 
 class FrontendHeap : public FrontendHeapBase
 {
 public:
     /* List any user-defined view types here*/
-    typedef touchgfx::meta::TypeList< touchgfx::meta::Nil, //Replace this with first user-defined type
+    typedef touchgfx::meta::TypeList< BenchmarkView,
                             touchgfx::meta::Nil  //List must always end with meta::Nil !
                             > UserDefinedViewTypes;
 
     /* List any user-defined presenter types here*/
-    typedef touchgfx::meta::TypeList< touchgfx::meta::Nil, //Replace this with first user-defined type
+    typedef touchgfx::meta::TypeList< BenchmarkPresenter,
                             touchgfx::meta::Nil  //List must always end with meta::Nil !
                             > UserDefinedPresenterTypes;
 
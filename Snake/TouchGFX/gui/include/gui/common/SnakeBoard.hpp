@@ -0,0 +1,87 @@
+#ifndef SNAKEBOARD_HPP
+#define SNAKEBOARD_HPP
+
+#include <touchgfx/widgets/Widget.hpp>
+#include <touchgfx/Bitmap.hpp>
+#include <touchgfx/hal/Types.hpp>
+#include <gui/common/SnakeGame.hpp>
+
+#ifndef SIMULATOR
+#include <FrameBufferConfig.hpp>
+#endif
+
+// 1 = queue all cell blits of a draw call and chain them on the DMA2D (TileBatchDMA)
+// 0 = one TouchGFX blit per cell (the original Image-per-segment cost profile)
+// The command list addresses a full-screen framebuffer, so partial framebuffer blocks always use 0
+#ifndef SNAKE_BOARD_BATCHED
+#if SNAKE_PARTIAL_FRAMEBUFFER
+#define SNAKE_BOARD_BATCHED 0
+#else
+#define SNAKE_BOARD_BATCHED 1
+#endif
+#endif
+
+// 1 = batched path reads the shared-palette L8 sprites (tools/sprite_l8.py) through the DMA2D CLUT
+// 0 = batched path copies the RGB565 TouchGFX bitmaps
+#ifndef SNAKE_SPRITES_L8
+#define SNAKE_SPRITES_L8 1
+#endif
+
+// Single widget covering the game area that draws one sprite per grid cell
+class SnakeBoard : public touchgfx::Widget
+{
+public:
+    SnakeBoard();
+
+    // Set the sprite of a cell (BITMAP_INVALID = empty) and invalidate it. The caller only
+    // sets the cells that changed (see SnakeScreen)
+    void setCell(int16_t x, int16_t y, touchgfx::BitmapId id);
+
+    // Remove all sprites from the board
+    void clearAll();
+
+    // Background of empty cells. Once set the board is opaque: empty cells are cleared with
+    // one fill (solid) or one tile copy (pattern) each, and TouchGFX no longer redraws the
+    // widgets below the board. The tile is a CELL_SIZE x CELL_SIZE RGB565 bitmap repeated per cell.
+    void setBackground(touchgfx::colortype color);
+    void setBackgroundTile(touchgfx::BitmapId tile);
+
+    touchgfx::BitmapId getCell(int16_t x, int16_t y) const { return cells[cellIndex(x, y)]; }
+
+    // Select batched (DMA2D command list) or per-cell rendering at runtime
+    void setBatched(bool enable) { batched = enable; }
+    bool isBatched() const { return batched; }
+
+    virtual void draw(const touchgfx::Rect &invalidatedArea) const;
+    virtual touchgfx::Rect getSolidRect() const;
+
+private:
+    static uint16_t cellIndex(int16_t x, int16_t y) { return y * GRID_WIDTH + x; }
+
+    // Clear the empty cells intersecting area through the TouchGFX DMA queue
+    void clearPerCell(const touchgfx::Rect &area, int16_t firstX, int16_t lastX, int16_t firstY, int16_t lastY) const;
+
+    // Clear the empty cells intersecting area as one DMA2D command list (framebuffer already locked)
+    void clearBatched(uint16_t *frameBuffer, const touchgfx::Rect &area, int16_t firstX, int16_t lastX, int16_t firstY, int16_t lastY) const;
+
+    // Part of cell (x, y) inside area, empty if the cell has a sprite or there is no background
+    touchgfx::Rect emptyCellPart(const touchgfx::Rect &area, int16_t x, int16_t y) const;
+
+    // Draw the cells intersecting area (relative to the board) one TouchGFX blit at a time
+    void drawPerCell(const touchgfx::Rect &area, int16_t firstX, int16_t lastX, int16_t firstY, int16_t lastY) const;
+
+    // Draw the cells intersecting area as one DMA2D command list
+    void drawBatched(const touchgfx::Rect &area, int16_t firstX, int16_t lastX, int16_t firstY, int16_t lastY) const;
+
+    // Current sprite per cell (BITMAP_INVALID = empty)
+    touchgfx::BitmapId cells[GRID_WIDTH * GRID_HEIGHT];
+
+    bool batched;
+
+    // Background of empty cells (see setBackground)
+    bool hasBackground;
+    touchgfx::colortype backgroundColor;
+    touchgfx::BitmapId backgroundTile;
+};
+
+#endif // SNAKEBOARD_HPP
@@ -0,0 +1,28 @@
+#ifndef SNAKECELLS_HPP
+#define SNAKECELLS_HPP
+
+#include <gui/common/SnakeGame.hpp>
+
+// Sprite shapes of a snake segment. The bitmaps are stored in four orientations
+// (MID in two), each a quarter turn counter-clockwise from the previous one:
+// HEAD/TAIL point up, left, down, right; MID is vertical, horizontal;
+// TURN is ┌, └, ┘, ┐
+enum SnakeCellShape
+{
+    CELL_HEAD = 0,
+    CELL_TAIL,
+    CELL_MID,
+    CELL_TURN
+};
+
+struct SnakeCellSprite
+{
+    SnakeCellShape shape;
+    uint8_t rotation; // Quarter turns counter-clockwise (0-3, MID 0-1)
+};
+
+// Sprite for a segment of the snake (index 0 = head). No TouchGFX dependencies,
+// so Screen2View and the host renderer (tools/render_replay) draw the same cells.
+SnakeCellSprite SnakeCells_getSprite(const SnakeGame &game, uint8_t index);
+
+#endif // SNAKECELLS_HPP
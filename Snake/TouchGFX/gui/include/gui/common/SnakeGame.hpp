@@ -2,6 +2,7 @@
 #define SNAKEGAME_HPP
 
 #include <stdint.h>
+#include <gui/common/SnakeInterface.h>
 
 // Game constants
 #define CELL_SIZE 10                               // 10x10 pixel per cell
@@ -10,6 +11,7 @@
 #define GRID_WIDTH (GAME_AREA_WIDTH / CELL_SIZE)   // 24 cells
 #define GRID_HEIGHT (GAME_AREA_HEIGHT / CELL_SIZE) // 28 cells
 #define MAX_SNAKE_LENGTH 100                       // Maximum snake length
+#define DIRECTION_QUEUE_DEPTH 4                    // Turns buffered ahead of the snake
 
 // BigFood constants
 #define BIGFOOD_SIZE 20          // 20x20 pixels
@@ -57,6 +59,23 @@ struct Position
     }
 };
 
+// A turn requested by the player, applied at a later step
+struct DirectionEvent
+{
+    SnakeDirection direction;
+    uint32_t timeMs; // Snake_GetTickMs() clock: when the press started (the button edge)
+};
+
+// Turn queue counters since the last reset()
+struct DirectionQueueStats
+{
+    uint32_t queued;    // Turns accepted into the queue
+    uint32_t rejected;  // 180-degree turns and repeats of the last queued direction
+    uint32_t overflows; // Turns dropped because DIRECTION_QUEUE_DEPTH were waiting
+    uint8_t maxDepth;   // Most turns waiting at once
+    uint32_t maxWaitMs; // Longest time from a press to the step that applied it
+};
+
 // Snake game class
 class SnakeGame
 {
@@ -68,8 +87,19 @@ public:
     void reset();
     bool update(); // Returns false if game over
 
-    // Input
-    void setDirection(SnakeDirection dir);
+    // Input: queues a turn, update() applies one per step. Not thread safe:
+    // call from the task that runs update() (the GUI task); presses cross from
+    // the input interrupt through the Model's press ring. timeMs is when the
+    // press started, so the queue wait includes the time to reach the GUI.
+    // Returns false if the turn was rejected or did not fit into the queue
+    bool setDirection(SnakeDirection dir, uint32_t timeMs);
+    bool setDirection(SnakeDirection dir) { return setDirection(dir, Snake_GetTickMs()); }
+    // Drop the newest queued turn if it is dir (a button that turned out to
+    // start a chord); returns false if it was not queued or already applied
+    bool withdrawDirection(SnakeDirection dir);
+    uint8_t getQueuedDirections() const { return directionCount; }
+    const DirectionQueueStats &getDirectionQueueStats() const { return queueStats; }
+    bool didTurnLastStep() const { return turnedLastStep; } // The last update() applied a queued turn
 
     // Difficulty
     void setDifficulty(Difficulty diff);
@@ -110,6 +140,10 @@ public:
     SnakeDirection getCurrentDirection() const { return currentDirection; }
     SnakeDirection getSegmentDirection(uint8_t index) const;
 
+    // Simple autopilot for unattended benchmark runs: heads for the food and
+    // avoids its own body one move ahead
+    SnakeDirection getAutopilotDirection();
+
 private:
     void moveSnake();
     void growSnake();
@@ -139,7 +173,12 @@ private:
 
     // Game state
     SnakeDirection currentDirection;
-    SnakeDirection nextDirection; // Buffered input to prevent 180-degree turns
+    DirectionEvent directionQueue[DIRECTION_QUEUE_DEPTH]; // Ring of turns, oldest at directionHead
+    uint8_t directionHead;
+    uint8_t directionCount;
+    SnakeDirection queuedDirection; // Direction after the queued turns, for the 180-degree check
+    DirectionQueueStats queueStats;
+    bool turnedLastStep;
     uint16_t score;
     bool gameOver;
     Difficulty difficulty;
@@ -13,11 +13,41 @@ extern "C"
      * @param left  true if LEFT button is pressed (PD6)
      * @param right true if RIGHT button is pressed (PD7)
      *
-     * This function should be called periodically from main.c to update
-     * the button states in the TouchGFX Model.
+     * This function should be called from main.c whenever the levels may
+     * have changed; a level that went up is a press as of the call. It only
+     * updates atomics that the GUI task reads once per tick (the level word
+     * and an ordered press ring), so it is safe from any task or interrupt and never
+     * touches FrontendHeap (which touchgfx_init() constructs before the
+     * scheduler starts).
      */
     void Snake_UpdateButtonStates(int up, int down, int left, int right);
 
+    /**
+     * @brief Report a press that has no button level, e.g. a touch swipe
+     * @param direction SnakeDirection of the press (0=UP, 1=DOWN, 2=LEFT, 3=RIGHT)
+     *
+     * The GUI sees it like a button press on its next tick. Safe from any
+     * task or interrupt, like Snake_UpdateButtonStates().
+     */
+    void Snake_InjectButtonPress(int direction);
+
+    /**
+     * @brief Report a press together with the time of its first edge
+     * @param direction SnakeDirection of the press (0=UP, 1=DOWN, 2=LEFT, 3=RIGHT)
+     * @param timeMs    Edge time on the Snake_GetTickMs() clock
+     *
+     * For input that stamps its edges: report the presses oldest first, then
+     * the new levels with Snake_SetButtonLevels(), instead of calling
+     * Snake_UpdateButtonStates(). The GUI receives presses in this order.
+     * Safe from any task or interrupt, like Snake_UpdateButtonStates().
+     */
+    void Snake_ButtonPressed(int direction, uint32_t timeMs);
+
+    /**
+     * @brief Update the button levels only, see Snake_ButtonPressed()
+     */
+    void Snake_SetButtonLevels(int up, int down, int left, int right);
+
     /**
      * @brief Play buzzer sound
      * @param durationMs Duration in milliseconds (100=food, 300=bigfood, 1000=gameover)
@@ -85,6 +115,16 @@ extern "C"
      */
     void Snake_InitStorage(void);
 
+    /**
+     * @brief Get CPU load and rendered frames since the previous call
+     * @param cpuLoadPermille Busy time in 1/1000 of the interval (rest is WFI sleep)
+     * @param framesRendered  Frames the GUI actually rendered in the interval
+     * @param elapsedMs       Length of the interval in milliseconds
+     *
+     * The first call after a screen change starts a new interval.
+     */
+    void Snake_GetLoadStats(uint16_t *cpuLoadPermille, uint32_t *framesRendered, uint32_t *elapsedMs);
+
 #ifdef __cplusplus
 }
 #endif
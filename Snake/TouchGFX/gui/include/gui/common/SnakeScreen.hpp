@@ -0,0 +1,105 @@
+#ifndef SNAKESCREEN_HPP
+#define SNAKESCREEN_HPP
+
+#include <gui/common/SnakeGame.hpp>
+#include <gui/common/SnakeCells.hpp>
+
+// HUD strip below the playfield (box2 area)
+#define HUD_Y GAME_AREA_HEIGHT
+#define HUD_WIDTH GAME_AREA_WIDTH
+#define HUD_HEIGHT 40
+
+// BigFood countdown bar, right of the score (HUD-relative)
+#define BIGFOOD_BAR_X 110
+#define BIGFOOD_BAR_Y 16
+#define BIGFOOD_BAR_WIDTH 120
+#define BIGFOOD_BAR_HEIGHT 8
+
+// BigFood countdown bar colour (orange) on the black HUD background
+#define BIGFOOD_BAR_RED 255
+#define BIGFOOD_BAR_GREEN 160
+#define BIGFOOD_BAR_BLUE 0
+
+// Content of a grid cell: SNAKE_SCREEN_EMPTY or 1 + shape * 4 + rotation
+typedef uint8_t SnakeScreenCell;
+#define SNAKE_SCREEN_EMPTY 0
+
+inline SnakeCellSprite SnakeScreen_decodeCell(SnakeScreenCell cell)
+{
+    SnakeCellSprite sprite;
+    sprite.shape = static_cast<SnakeCellShape>((cell - 1) / 4);
+    sprite.rotation = (cell - 1) % 4;
+    return sprite;
+}
+
+// Rectangle in screen pixels
+struct SnakeScreenArea
+{
+    int16_t x;
+    int16_t y;
+    int16_t width;
+    int16_t height;
+};
+
+// Receives the changes found by SnakeScreen, each reported once
+class SnakeScreenListener
+{
+public:
+    virtual ~SnakeScreenListener() {}
+
+    // Grid cell (x, y) shows a different sprite (or none); redraw cellArea(x, y)
+    virtual void cellChanged(int16_t x, int16_t y, SnakeScreenCell cell) = 0;
+
+    // The food appeared or moved; redraw foodArea(from) if it was shown, and foodArea(to)
+    virtual void foodChanged(bool wasShown, Position from, Position to) = 0;
+
+    // BigFood appeared, moved or disappeared; redraw bigFoodArea() of the shown positions
+    virtual void bigFoodChanged(bool wasShown, Position from, bool shown, Position to) = 0;
+
+    // Countdown bar columns [first, first + count) changed colour (getBarFill() is the new fill)
+    virtual void barChanged(int16_t first, int16_t count) = 0;
+};
+
+// What the game screen shows for a game state, reduced to plain data, and the
+// changes from one update to the next. No TouchGFX dependencies: Screen2View
+// redraws exactly what this reports, and the host renderer (tools/render_replay)
+// composes and checks the same frames.
+class SnakeScreen
+{
+public:
+    SnakeScreen();
+
+    // Empty screen: no snake, no food, empty bar (a freshly set up Screen2View)
+    void reset();
+
+    // Snake cells, food and BigFood; only change when the game steps or resets
+    void updateBoard(const SnakeGame &game, SnakeScreenListener &listener);
+
+    // Countdown bar; runs in real time, so update it every tick
+    void updateBar(const SnakeGame &game, SnakeScreenListener &listener);
+
+    SnakeScreenCell getCell(int16_t x, int16_t y) const { return cells[y * GRID_WIDTH + x]; }
+    bool isFoodShown() const { return foodShown; }
+    Position getFood() const { return food; }
+    bool isBigFoodShown() const { return bigFoodShown; }
+    Position getBigFood() const { return bigFood; }
+    int16_t getBarFill() const { return barFill; }
+
+    // Screen areas of the shown items
+    static SnakeScreenArea cellArea(int16_t x, int16_t y);
+    static SnakeScreenArea foodArea(Position food);
+    static SnakeScreenArea bigFoodArea(Position bigFood);
+    static SnakeScreenArea barArea(int16_t first, int16_t count);
+
+private:
+    SnakeScreenCell cells[GRID_WIDTH * GRID_HEIGHT];
+    SnakeScreenCell next[GRID_WIDTH * GRID_HEIGHT];
+
+    bool foodShown;
+    Position food;
+    bool bigFoodShown;
+    Position bigFood;
+    int16_t barFill; // Filled bar columns
+};
+
+#endif // SNAKESCREEN_HPP
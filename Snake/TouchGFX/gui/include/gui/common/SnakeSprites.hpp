@@ -0,0 +1,55 @@
+#ifndef SNAKESPRITES_HPP
+#define SNAKESPRITES_HPP
+
+#include <touchgfx/Bitmap.hpp>
+#include <images/BitmapDatabase.hpp>
+#include <gui/common/SnakeSpritesL8.hpp>
+
+// The board sprites are not in the BitmapDatabase: only the canonical orientation
+// is stored in flash, as L8 in the sprite atlas (HEAD/TAIL = up, MID = vertical,
+// TURN = ┌). It is expanded to RGB565 and rotated into the bitmap cache at boot,
+// and the results get these ids, so they are used exactly like the generated
+// BITMAP_*_ID constants.
+extern touchgfx::BitmapId BITMAP_HEAD_ID;
+extern touchgfx::BitmapId BITMAP_TAIL_ID;
+extern touchgfx::BitmapId BITMAP_MID_ID;
+extern touchgfx::BitmapId BITMAP_TURN_ID;
+extern touchgfx::BitmapId BITMAP_HEAD1_ID; // 90° CCW (left)
+extern touchgfx::BitmapId BITMAP_HEAD2_ID; // 180° (down)
+extern touchgfx::BitmapId BITMAP_HEAD3_ID; // 270° CCW (right)
+extern touchgfx::BitmapId BITMAP_TAIL1_ID;
+extern touchgfx::BitmapId BITMAP_TAIL2_ID;
+extern touchgfx::BitmapId BITMAP_TAIL3_ID;
+extern touchgfx::BitmapId BITMAP_MID1_ID;  // horizontal
+extern touchgfx::BitmapId BITMAP_TURN1_ID; // └
+extern touchgfx::BitmapId BITMAP_TURN2_ID; // ┘
+extern touchgfx::BitmapId BITMAP_TURN3_ID; // ┐
+
+class SnakeSprites
+{
+public:
+    // Sprites created at runtime (dynamic bitmaps needed in the cache)
+    static const uint8_t EXPANDED_COUNT = SNAKE_SPRITE_BOARD_COUNT;
+    static const uint8_t ROTATED_COUNT = 10;
+    static const uint8_t BITMAP_COUNT = EXPANDED_COUNT + ROTATED_COUNT;
+
+    // Expand the stored sprites from the atlas and create the rotated ones.
+    // Call once after Bitmap::setCache().
+    // Returns false if the cache ran out; the missing ids stay BITMAP_INVALID.
+    static bool generateSprites();
+
+    // L8 copy of a sprite (stored or rotated at boot), or 0 if there is none
+    static const SnakeSpriteL8 *findL8(touchgfx::BitmapId id);
+
+    // RGB565 bytes created at boot, i.e. flash no longer spent on RGB565 copies
+    static uint32_t getGeneratedBytes() { return generatedBytes; }
+
+    // Time spent in generateSprites() (SYSCLK cycles, 0 in the simulator)
+    static uint32_t getGenerateCycles() { return generateCycles; }
+
+private:
+    static uint32_t generatedBytes;
+    static uint32_t generateCycles;
+};
+
+#endif // SNAKESPRITES_HPP
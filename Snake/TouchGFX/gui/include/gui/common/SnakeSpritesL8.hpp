@@ -0,0 +1,41 @@
+// Generated by tools/sprite_l8.py from TouchGFX/assets/sprites - do not edit
+#ifndef SNAKESPRITESL8_HPP
+#define SNAKESPRITESL8_HPP
+
+#include <touchgfx/hal/Types.hpp>
+#include <touchgfx/Bitmap.hpp>
+
+// Shared-palette 8-bit indexed copy of a TouchGFX sprite: a sub-rectangle of an atlas
+struct SnakeSpriteL8
+{
+    touchgfx::BitmapId bitmapId;
+    uint8_t width;
+    uint8_t height;
+    uint16_t stride;        // Atlas line length in pixels
+    const uint8_t *indices; // Top left pixel in the atlas
+};
+
+// Palette as ARGB8888 (DMA2D CLUT format), RGB565 expanded by bit replication
+#define SNAKE_SPRITE_PALETTE_SIZE 3
+extern const uint32_t snakeSpritePaletteL8[SNAKE_SPRITE_PALETTE_SIZE];
+
+// All stored sprites packed into one L8 image
+#define SNAKE_SPRITE_ATLAS_WIDTH 40
+#define SNAKE_SPRITE_ATLAS_HEIGHT 10
+extern const uint8_t snakeSpriteAtlasL8[SNAKE_SPRITE_ATLAS_WIDTH * SNAKE_SPRITE_ATLAS_HEIGHT];
+
+#define SNAKE_SPRITE_COUNT 4
+extern const SnakeSpriteL8 snakeSpritesL8[SNAKE_SPRITE_COUNT];
+
+// Table indices. The first SNAKE_SPRITE_BOARD_COUNT sprites are not in the
+// BitmapDatabase: their bitmapId is BITMAP_INVALID and SnakeSprites creates the bitmaps
+#define SNAKE_SPRITE_HEAD 0
+#define SNAKE_SPRITE_TAIL 1
+#define SNAKE_SPRITE_MID 2
+#define SNAKE_SPRITE_TURN 3
+#define SNAKE_SPRITE_BOARD_COUNT 4
+
+// L8 copy of a sprite, or 0 if the bitmap has none
+const SnakeSpriteL8 *SnakeSpritesL8_find(touchgfx::BitmapId id);
+
+#endif // SNAKESPRITESL8_HPP
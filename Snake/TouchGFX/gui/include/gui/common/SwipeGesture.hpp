@@ -0,0 +1,35 @@
+#ifndef SWIPEGESTURE_HPP
+#define SWIPEGESTURE_HPP
+
+#include <gui/common/SnakeGame.hpp>
+
+// Turns a stream of touch samples into swipes along one axis, mapped to
+// SnakeDirection in screen coordinates. A swipe fires as soon as the finger
+// has moved SWIPE_MIN_DISTANCE along a clearly dominant axis, without waiting
+// for the release, and the stroke is re-anchored there, so one drag can chain
+// several turns. Movement slower than SWIPE_MAX_MS per swipe is ignored.
+// No TouchGFX dependencies.
+class SwipeGesture
+{
+public:
+    static const int16_t SWIPE_MIN_DISTANCE = 24; // Pixels along the swipe axis
+    static const uint32_t SWIPE_MAX_MS = 400;     // Longest time to cover that distance
+
+    SwipeGesture();
+
+    // Feed a touch sample; returns true and sets dir when a swipe completed
+    bool addSample(int16_t x, int16_t y, uint32_t timeMs, SnakeDirection &dir);
+
+    // Finger lifted: the next sample starts a new stroke
+    void release() { tracking = false; }
+
+private:
+    void anchor(int16_t x, int16_t y, uint32_t timeMs);
+
+    bool tracking;
+    int16_t startX;
+    int16_t startY;
+    uint32_t startMs;
+};
+
+#endif // SWIPEGESTURE_HPP
@@ -21,10 +21,26 @@ public:
     // Snake game instance (shared across screens)
     SnakeGame &getSnakeGame() { return snakeGame; }
 
-    // Button state polling (called from main.c via extern "C")
-    void updateButtonStates(bool up, bool down, bool left, bool right);
-
-    // Get current button states
+    // Button levels from the input side (main.c via extern "C", the EXTI
+    // handler or the simulator keyboard); levels that went up are pressed as
+    // of now. Safe from any task or interrupt: it only touches atomics, never
+    // the Model instance or FrontendHeap. One level source per build
+    static void updateButtonStates(bool up, bool down, bool left, bool right);
+
+    // For input that knows when a press started (the EXTI edge stamps):
+    // pressButton() for each press, oldest first, then setButtonLevels() with
+    // the new levels. Same context rules as updateButtonStates()
+    static void pressButton(SnakeDirection dir, uint32_t timeMs);
+    static void setButtonLevels(bool up, bool down, bool left, bool right);
+
+    // A press without a level (touch swipe), as of now. Same context rules as
+    // updateButtonStates()
+    static void injectButtonPress(SnakeDirection dir);
+
+    // Presses lost because the GUI task fell behind by a whole ring of them
+    static uint32_t getDroppedPresses();
+
+    // Button states as of the last tick
     bool isButtonUpPressed() const { return buttonUp; }
     bool isButtonDownPressed() const { return buttonDown; }
     bool isButtonLeftPressed() const { return buttonLeft; }
@@ -38,6 +54,20 @@ public:
     // Load high score from Flash storage (called at startup)
     void loadHighScoreFromFlash();
 
+    // CPU load / frame rate report per difficulty, accumulated over all games
+    void recordLoadSample(Difficulty difficulty, uint16_t cpuLoadPermille, uint32_t frames, uint32_t ticks, uint32_t elapsedMs);
+    uint16_t getAverageCpuLoad(Difficulty difficulty) const; // permille of the time not spent in WFI
+    uint16_t getAverageFps(Difficulty difficulty) const;     // frames actually rendered per second
+    uint16_t getAverageTickRate(Difficulty difficulty) const; // GUI ticks per second (60 unless frames overrun)
+    void resetLoadReport();
+
+    // Benchmark: the game screen plays itself through every difficulty for
+    // BENCHMARK_SECONDS_PER_LEVEL seconds each and then shows the report
+    static const uint8_t BENCHMARK_SECONDS_PER_LEVEL = 5;
+    void startBenchmark();
+    bool isBenchmarkRunning() const { return benchmarkRunning; }
+    bool advanceBenchmark(); // Called once per second; returns false when the last level is done
+
 protected:
     ModelListener *modelListener;
 
@@ -50,7 +80,7 @@ private:
     bool buttonLeft;
     bool buttonRight;
 
-    // Previous button states for edge detection
+    // Previous button states for chord detection
     bool prevButtonUp;
     bool prevButtonDown;
     bool prevButtonLeft;
@@ -59,6 +89,21 @@ private:
     // Score tracking
     uint16_t highScore;
     uint16_t lastScore;
+
+    // Load report, indexed by Difficulty
+    struct LoadReport
+    {
+        uint32_t busyMs;
+        uint32_t elapsedMs;
+        uint32_t frames;
+        uint32_t ticks;
+    };
+    LoadReport loadReport[NIGHTMARE + 1];
+
+    // Benchmark state
+    bool benchmarkRunning;
+    uint8_t benchmarkSeconds;
+    Difficulty benchmarkSavedDifficulty;
 };
 
 #endif // MODEL_HPP
@@ -16,8 +16,17 @@ public:
         model = m;
     }
 
-    // Called when a button is pressed (edge detection)
-    virtual void buttonPressed(SnakeDirection dir) {}
+    // Called when a button is pressed, in the order of the presses; timeMs is
+    // when the press started (Snake_GetTickMs() clock, the edge for the buttons)
+    virtual void buttonPressed(SnakeDirection dir, uint32_t timeMs) {}
+
+    // Called when LEFT and RIGHT are pressed together. Presses of the chord
+    // that arrive in the tick it completes are not reported; one pressed in an
+    // earlier tick already was (see SnakeGame::withdrawDirection())
+    virtual void buttonChordPressed() {}
+
+    // Called when UP and DOWN are pressed together, same rules
+    virtual void buttonUpDownChordPressed() {}
 
 protected:
     Model *model;
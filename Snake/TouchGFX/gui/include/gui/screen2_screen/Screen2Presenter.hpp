@@ -34,8 +34,21 @@ public:
     // Save score to model
     void saveScore(uint16_t score);
 
+    // Add a CPU load sample to the report of the current difficulty
+    void recordLoadSample(uint16_t cpuLoadPermille, uint32_t frames, uint32_t ticks, uint32_t elapsedMs);
+
+    // Benchmark run (started from the game over screen)
+    bool isBenchmarkRunning() const;
+    bool advanceBenchmark();
+
     // Override button pressed callback from ModelListener
-    virtual void buttonPressed(SnakeDirection dir);
+    virtual void buttonPressed(SnakeDirection dir, uint32_t timeMs);
+
+    // LEFT + RIGHT toggles the frame time overlay
+    virtual void buttonChordPressed();
+
+    // UP + DOWN toggles the latency test
+    virtual void buttonUpDownChordPressed();
 
 private:
     Screen2Presenter();
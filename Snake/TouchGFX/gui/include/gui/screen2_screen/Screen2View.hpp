@@ -4,17 +4,36 @@
 #include <gui_generated/screen2_screen/Screen2ViewBase.hpp>
 #include <gui/screen2_screen/Screen2Presenter.hpp>
 #include <gui/common/SnakeGame.hpp>
+#include <gui/common/SnakeBoard.hpp>
+#include <gui/common/SnakeCells.hpp>
+#include <gui/common/SnakeScreen.hpp>
+#include <gui/common/CountdownBar.hpp>
+#include <gui/common/DigitScore.hpp>
 #include <touchgfx/widgets/Image.hpp>
+#include <touchgfx/widgets/Box.hpp>
 #include <touchgfx/containers/Container.hpp>
+#include <touchgfx/widgets/TextAreaWithWildcard.hpp>
 
-// Maximum snake segments we can display
-#define MAX_DISPLAY_SEGMENTS 100
+// 1 = time score updates through the text area and the digit glyphs at screen setup (target only)
+#ifndef SCORE_BENCHMARK
+#define SCORE_BENCHMARK 0
+#endif
+
+// CPU load is sampled about once per second (60 ticks at 60 FPS)
+#define LOAD_SAMPLE_TICKS 60
+
+// Frame time overlay: four Small text lines over the HUD strip, refreshed twice a second
+#define STATS_LINE_COUNT 4
+#define STATS_LINE_LENGTH 40
+#define STATS_LINE_HEIGHT 10
+#define STATS_REFRESH_TICKS 30
 
 // External C functions for audio output
 extern "C" void Snake_PlayBuzzer(int durationMs);
 extern "C" void Snake_PlayMusic(void);
+extern "C" void Snake_GetLoadStats(uint16_t *cpuLoadPermille, uint32_t *framesRendered, uint32_t *elapsedMs);
 
-class Screen2View : public Screen2ViewBase
+class Screen2View : public Screen2ViewBase, public SnakeScreenListener
 {
 public:
     Screen2View();
@@ -26,42 +45,72 @@ public:
     virtual void handleTickEvent();
 
     // Called when button is pressed (from presenter)
-    void onButtonPressed(SnakeDirection dir);
+    void onButtonPressed(SnakeDirection dir, uint32_t timeMs);
 
-protected:
-    // Update snake display based on game state
-    void updateSnakeDisplay();
+    // A chord of first and second completed: the first button, reported as a
+    // press a tick earlier, must not steer if its turn is still queued
+    void withdrawChordTurn(SnakeDirection first, SnakeDirection second);
+
+    // Show or hide the frame time overlay in place of the HUD contents
+    void toggleStatsOverlay();
+
+    // Latency test (UP + DOWN, target only): the autopilot steers through
+    // injected presses and the overlay shows the input to photon latency
+    void toggleLatencyTest();
 
-    // Update food display
-    void updateFoodDisplay();
+    // SnakeScreenListener: redraw what changed on the board and in the countdown bar
+    virtual void cellChanged(int16_t x, int16_t y, SnakeScreenCell cell);
+    virtual void foodChanged(bool wasShown, Position from, Position to);
+    virtual void bigFoodChanged(bool wasShown, Position from, bool shown, Position to);
+    virtual void barChanged(int16_t first, int16_t count);
 
-    // Update BigFood display
-    void updateBigFoodDisplay();
+protected:
+    // Update snake, food and BigFood display (invalidates only what changed, see SnakeScreen)
+    void updateBoardDisplay();
 
-    // Update score display
+    // Update score display (redraws the HUD only when the score changed)
     void updateScoreDisplay();
 
+    // Update the BigFood countdown bar (touches only the columns that changed)
+    void updateBigFoodTimer();
+
+    // Copy the changed score digits into the HUD layer back buffer
+    void patchHudScore(const touchgfx::Rect &changed);
+
+    // Average cost of a score update: text area + HUD render vs. digit glyphs
+    void benchmarkScore();
+
+    // Add the load of the last second to the report of the current difficulty
+    void sampleLoad();
+
     // Handle sound events
     void handleSoundEvent();
 
-    // Convert grid position to pixel position
-    int16_t gridToPixelX(int16_t gridX) { return gridX * CELL_SIZE; }
-    int16_t gridToPixelY(int16_t gridY) { return gridY * CELL_SIZE; }
+    // Move the score into the HUD container and put it on its own LTDC layer
+    void setupHud();
+
+    // Render the HUD into the layer back buffer and show it
+    void renderHud();
+
+    // True when the HUD is shown by the layer: hud is then not on the screen and
+    // changes are rendered into the layer buffers instead of being invalidated
+    bool hudOnLayer() const;
 
-    // Check if segment is a turn segment and get directions
-    bool isTurnSegment(uint8_t index, SnakeDirection &fromDir, SnakeDirection &toDir);
+    // Game logic of one tick (timed separately from drawing by the frame time overlay)
+    void stepGame();
 
-    // Get bitmap ID for head based on direction
-    uint16_t getHeadBitmapId(SnakeDirection dir);
+    // Format the frame time overlay lines and show them
+    void updateStatsOverlay();
 
-    // Get bitmap ID for tail based on direction
-    uint16_t getTailBitmapId(SnakeDirection dir);
+    // Format the latency test summary into the overlay lines
+    void formatLatencyOverlay();
 
-    // Get bitmap ID for mid segment based on direction
-    uint16_t getMidBitmapId(SnakeDirection dir);
+    // Convert grid position to pixel position
+    int16_t gridToPixelX(int16_t gridX) { return gridX * CELL_SIZE; }
+    int16_t gridToPixelY(int16_t gridY) { return gridY * CELL_SIZE; }
 
-    // Get bitmap ID for turn segment based on from/to directions
-    uint16_t getTurnBitmapId(SnakeDirection fromDir, SnakeDirection toDir);
+    // Bitmap for a snake cell sprite
+    uint16_t getCellBitmapId(SnakeCellSprite sprite);
 
 private:
     // Game reference
@@ -70,16 +119,40 @@ private:
     // Tick counter for game speed control
     uint32_t tickCounter;
 
-    // Snake body images (dynamically managed)
-    touchgfx::Image snakeSegments[MAX_DISPLAY_SEGMENTS];
-    uint8_t currentSegmentCount;
+    // Tick counter for CPU load sampling
+    uint16_t loadSampleTicks;
 
-    // Container for snake segments
-    touchgfx::Container snakeContainer;
+    // What is currently on screen, so unchanged state is not invalidated again.
+    // The board and the bar are shared with the host renderer (tools/render_replay)
+    SnakeScreen screen;
+    uint16_t shownScore;
+
+    // Game board drawing the snake sprites cell by cell
+    SnakeBoard snakeBoard;
 
     // BigFood image
     touchgfx::Image bigFoodImage;
 
+    // HUD (score); on target rendered into LTDC layer 2, not into the playfield framebuffer
+    touchgfx::Container hud;
+    touchgfx::Box hudBackground;
+    CountdownBar bigFoodTimer;
+    DigitScore scoreDigits;
+    touchgfx::BitmapId hudBitmaps[2];
+
+    // Frame time overlay (LEFT + RIGHT), drawn in the HUD strip so it never invalidates the playfield
+    touchgfx::Container statsOverlay;
+    touchgfx::TextAreaWithOneWildcard statsLines[STATS_LINE_COUNT];
+    touchgfx::Unicode::UnicodeChar statsBuffers[STATS_LINE_COUNT][STATS_LINE_LENGTH];
+    uint8_t statsRefreshTicks;
+
+    // Latency test running (the overlay shows latency instead of frame times)
+    bool latencyTest;
+
+    // Tick of the current step at which the latency test presses, picked at
+    // random so presses arrive at any phase of the step like a player's
+    uint32_t latencyPressTick;
+
     // Score text buffer
     touchgfx::Unicode::UnicodeChar scoreBuffer[10];
 
@@ -32,6 +32,9 @@ public:
     uint16_t getLastScore();
     uint16_t getHighScore();
 
+    // DOWN starts the benchmark: the game plays itself through every difficulty
+    virtual void buttonPressed(SnakeDirection dir, uint32_t timeMs);
+
 private:
     Screen3Presenter();
 
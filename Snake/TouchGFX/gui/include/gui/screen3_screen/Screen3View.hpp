@@ -3,6 +3,7 @@
 
 #include <gui_generated/screen3_screen/Screen3ViewBase.hpp>
 #include <gui/screen3_screen/Screen3Presenter.hpp>
+#include <gui/common/DigitScore.hpp>
 
 class Screen3View : public Screen3ViewBase
 {
@@ -12,14 +13,24 @@ public:
     virtual void setupScreen();
     virtual void tearDownScreen();
 
+    // Switch to the game screen for a benchmark run
+    void startBenchmark();
+
 protected:
     // Update score displays
     void updateScoreDisplay();
 
+    // Show a score with digit glyphs in place of its text area (if they can be rendered)
+    void setupDigits(DigitScore &digits, touchgfx::TextAreaWithOneWildcard &text);
+
 private:
     // Score buffers for wildcard text
     touchgfx::Unicode::UnicodeChar scoreBuffer[10];
     touchgfx::Unicode::UnicodeChar highScoreBuffer[10];
+
+    // Glyph based score displays
+    DigitScore scoreDigits;
+    DigitScore highScoreDigits;
 };
 
 #endif // SCREEN3VIEW_HPP
@@ -0,0 +1,35 @@
+#include <gui/benchmark_screen/BenchmarkView.hpp>
+#include <gui/benchmark_screen/BenchmarkPresenter.hpp>
+
+BenchmarkPresenter::BenchmarkPresenter(BenchmarkView &v)
+    : view(v)
+{
+}
+
+void BenchmarkPresenter::activate()
+{
+}
+
+void BenchmarkPresenter::deactivate()
+{
+}
+
+uint16_t BenchmarkPresenter::getTickRate(Difficulty difficulty)
+{
+    return model->getAverageTickRate(difficulty);
+}
+
+uint16_t BenchmarkPresenter::getFps(Difficulty difficulty)
+{
+    return model->getAverageFps(difficulty);
+}
+
+uint16_t BenchmarkPresenter::getCpuLoad(Difficulty difficulty)
+{
+    return model->getAverageCpuLoad(difficulty);
+}
+
+void BenchmarkPresenter::buttonPressed(SnakeDirection dir, uint32_t timeMs)
+{
+    view.close();
+}
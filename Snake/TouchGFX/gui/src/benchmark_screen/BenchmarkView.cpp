@@ -0,0 +1,115 @@
+#include <gui/benchmark_screen/BenchmarkView.hpp>
+#include <texts/TextKeysAndLanguages.hpp>
+#include <touchgfx/Color.hpp>
+#include <touchgfx/Unicode.hpp>
+#include <touchgfx/hal/HAL.hpp>
+
+#ifndef SIMULATOR
+#include <FrameBufferConfig.hpp>
+#include <BeamRaceMonitor.hpp>
+#include <TileBatchDMA.hpp>
+#include "stm32f4xx_hal.h"
+#endif
+
+namespace
+{
+const char *const difficultyNames[NIGHTMARE + 1] = {"EASY", "NORMAL", "HARD", "INSANE", "NIGHTMARE"};
+} // namespace
+
+BenchmarkView::BenchmarkView()
+{
+    for (int i = 0; i < BENCHMARK_LINE_COUNT; i++)
+    {
+        lineBuffers[i][0] = 0;
+    }
+}
+
+void BenchmarkView::setupScreen()
+{
+    background.setPosition(0, 0, HAL::DISPLAY_WIDTH, HAL::DISPLAY_HEIGHT);
+    background.setColor(touchgfx::Color::getColorFromRGB(0, 0, 0));
+    add(background);
+
+    for (int i = 0; i < BENCHMARK_LINE_COUNT; i++)
+    {
+        lines[i].setPosition(BENCHMARK_LINE_X, BENCHMARK_LINE_Y + i * BENCHMARK_LINE_SPACING,
+                             HAL::DISPLAY_WIDTH - 2 * BENCHMARK_LINE_X, BENCHMARK_LINE_SPACING);
+        lines[i].setColor(touchgfx::Color::getColorFromRGB(255, 255, 255));
+        lines[i].setTypedText(touchgfx::TypedText(T_BENCHMARKLINE));
+        lines[i].setWildcard(lineBuffers[i]);
+        add(lines[i]);
+    }
+
+    updateReport();
+}
+
+void BenchmarkView::tearDownScreen()
+{
+}
+
+void BenchmarkView::close()
+{
+    application().gotoScreen1ScreenNoTransition();
+}
+
+void BenchmarkView::updateReport()
+{
+    int line = 0;
+
+    touchgfx::Unicode::strncpy(lineBuffers[line++], "BENCHMARK", BENCHMARK_LINE_LENGTH);
+
+#ifndef SIMULATOR
+    touchgfx::Unicode::snprintf(lineBuffers[line++], BENCHMARK_LINE_LENGTH,
+                                FrameBufferConfig::IN_SDRAM ? "FRAMEBUFFER: %u B SDRAM" : "FRAMEBUFFER: %u B SRAM",
+                                (unsigned int)FrameBufferConfig::FRAMEBUFFER_BYTES);
+    touchgfx::Unicode::snprintf(lineBuffers[line++], BENCHMARK_LINE_LENGTH, "BITMAP CACHE: %u B",
+                                (unsigned int)FrameBufferConfig::BITMAP_CACHE_BYTES);
+#if SNAKE_SINGLE_FRAMEBUFFER
+    // Single framebuffer: areas scanned out while drawn, and worst frame start to photon time
+    const BeamRaceMonitor::Stats &beam = BeamRaceMonitor::getInstance().getStats();
+    touchgfx::Unicode::snprintf(lineBuffers[line++], BENCHMARK_LINE_LENGTH, "TEARS: %u/%u MAX LATENCY: %u US",
+                                (unsigned int)beam.tears, (unsigned int)beam.areas,
+                                (unsigned int)(beam.maxLatencyCycles / (SystemCoreClock / 1000000)));
+#else
+    line++;
+#endif
+#else
+    touchgfx::Unicode::strncpy(lineBuffers[line++], "FRAMEBUFFER: SIMULATOR", BENCHMARK_LINE_LENGTH);
+    line += 2;
+#endif
+
+    touchgfx::Unicode::strncpy(lineBuffers[line++], "LEVEL: TPS FPS CPU", BENCHMARK_LINE_LENGTH);
+    for (int d = EASY; d <= NIGHTMARE; d++)
+    {
+        Difficulty difficulty = static_cast<Difficulty>(d);
+        uint16_t load = presenter->getCpuLoad(difficulty);
+        uint16_t length = touchgfx::Unicode::strncpy(lineBuffers[line], difficultyNames[d], BENCHMARK_LINE_LENGTH);
+        touchgfx::Unicode::snprintf(lineBuffers[line] + length, BENCHMARK_LINE_LENGTH - length, ": %u %u %u.%u%%",
+                                    presenter->getTickRate(difficulty), presenter->getFps(difficulty),
+                                    load / 10, load % 10);
+        line++;
+    }
+
+#ifndef SIMULATOR
+    // Empty board cells cleared per game step and their DMA2D/blit time
+    const TileBatchDMA::Stats &tiles = TileBatchDMA::getInstance().getStats();
+    uint32_t steps = tiles.clearFrames ? tiles.clearFrames : 1;
+    touchgfx::Unicode::snprintf(lineBuffers[line++], BENCHMARK_LINE_LENGTH, "CELL CLEARS: %u/STEP %u US/STEP",
+                                (unsigned int)(tiles.clearsTotal / steps),
+                                (unsigned int)(tiles.clearCyclesTotal / steps / (SystemCoreClock / 1000000)));
+
+    // Batched DMA2D throughput (sprites and clears) in pixels per microsecond
+    uint32_t pixelsPer10Us = tiles.busyCyclesTotal ? (uint32_t)((uint64_t)tiles.pixelsTotal * (SystemCoreClock / 100000) / tiles.busyCyclesTotal) : 0;
+    touchgfx::Unicode::snprintf(lineBuffers[line++], BENCHMARK_LINE_LENGTH, "DMA2D BLITS: %u.%u MPX/S",
+                                (unsigned int)(pixelsPer10Us / 10), (unsigned int)(pixelsPer10Us % 10));
+#else
+    line += 2;
+#endif
+
+    touchgfx::Unicode::strncpy(lineBuffers[line++], "PRESS ANY BUTTON", BENCHMARK_LINE_LENGTH);
+
+    for (int i = 0; i < BENCHMARK_LINE_COUNT; i++)
+    {
+        lines[i].invalidate();
+    }
+}
@@ -0,0 +1,35 @@
+#include <gui/common/CountdownBar.hpp>
+#include <touchgfx/hal/HAL.hpp>
+#include <touchgfx/lcd/LCD.hpp>
+
+using namespace touchgfx;
+
+CountdownBar::CountdownBar()
+    : filledWidth(0), barColor(0), backgroundColor(0)
+{
+}
+
+void CountdownBar::draw(const Rect &invalidatedArea) const
+{
+    Rect filled(0, 0, filledWidth, getHeight());
+    Rect empty(filledWidth, 0, getWidth() - filledWidth, getHeight());
+
+    filled &= invalidatedArea;
+    empty &= invalidatedArea;
+
+    if (!filled.isEmpty())
+    {
+        translateRectToAbsolute(filled);
+        HAL::lcd().fillRect(filled, barColor, 255);
+    }
+    if (!empty.isEmpty())
+    {
+        translateRectToAbsolute(empty);
+        HAL::lcd().fillRect(empty, backgroundColor, 255);
+    }
+}
+
+Rect CountdownBar::getSolidRect() const
+{
+    return Rect(0, 0, getWidth(), getHeight());
+}
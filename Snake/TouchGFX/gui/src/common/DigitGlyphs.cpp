@@ -0,0 +1,92 @@
+#include <gui/common/DigitGlyphs.hpp>
+#include <touchgfx/containers/Container.hpp>
+#include <touchgfx/widgets/Box.hpp>
+#include <touchgfx/widgets/TextAreaWithWildcard.hpp>
+#include <touchgfx/Unicode.hpp>
+
+using namespace touchgfx;
+
+DigitGlyphs DigitGlyphs::sets[DigitGlyphs::MAX_SETS];
+uint8_t DigitGlyphs::setCount = 0;
+
+DigitGlyphs::DigitGlyphs()
+    : fontId(0), color(0), backgroundColor(0), width(0), height(0)
+{
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        glyphs[i] = BITMAP_INVALID;
+    }
+}
+
+const DigitGlyphs *DigitGlyphs::get(const TextArea &source, colortype background)
+{
+    FontId font = source.getTypedText().getFontId();
+
+    for (uint8_t i = 0; i < setCount; i++)
+    {
+        if (sets[i].fontId == font && sets[i].color == source.getColor() && sets[i].backgroundColor == background)
+        {
+            return &sets[i];
+        }
+    }
+
+    if (setCount >= MAX_SETS || !sets[setCount].render(source, background))
+    {
+        return 0;
+    }
+    return &sets[setCount++];
+}
+
+bool DigitGlyphs::render(const TextArea &source, colortype background)
+{
+    Container canvas;
+    Box box;
+    TextAreaWithOneWildcard text;
+    Unicode::UnicodeChar digit[2] = {'0', 0};
+
+    text.setTypedText(source.getTypedText());
+    text.setColor(source.getColor());
+    text.setWildcard(digit);
+
+    // Fixed-width cells: the widest digit decides
+    width = 0;
+    for (uint8_t d = 0; d < 10; d++)
+    {
+        digit[0] = '0' + d;
+        int16_t w = text.getTextWidth();
+        if (w > width)
+        {
+            width = w;
+        }
+    }
+    height = text.getTextHeight();
+
+    canvas.setPosition(0, 0, width, height);
+    box.setPosition(0, 0, width, height);
+    box.setColor(background);
+    text.setPosition(0, 0, width, height);
+    canvas.add(box);
+    canvas.add(text);
+
+    for (uint8_t d = 0; d < 10; d++)
+    {
+        glyphs[d] = Bitmap::dynamicBitmapCreate(width, height, Bitmap::RGB565);
+        if (glyphs[d] == BITMAP_INVALID)
+        {
+            while (d > 0)
+            {
+                Bitmap::dynamicBitmapDelete(glyphs[--d]);
+                glyphs[d] = BITMAP_INVALID;
+            }
+            return false;
+        }
+
+        digit[0] = '0' + d;
+        canvas.drawToDynamicBitmap(glyphs[d]);
+    }
+
+    fontId = source.getTypedText().getFontId();
+    color = source.getColor();
+    backgroundColor = background;
+    return true;
+}
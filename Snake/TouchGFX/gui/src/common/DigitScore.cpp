@@ -0,0 +1,163 @@
+#include <gui/common/DigitScore.hpp>
+#include <touchgfx/hal/HAL.hpp>
+#include <touchgfx/lcd/LCD.hpp>
+#include <touchgfx/Color.hpp>
+#include <string.h>
+
+using namespace touchgfx;
+
+DigitScore::DigitScore()
+    : glyphs(0), backgroundColor(0), alignment(ALIGN_LEFT), count(0)
+{
+}
+
+int16_t DigitScore::digitsX() const
+{
+    if (alignment == ALIGN_CENTER)
+    {
+        return (getWidth() - count * glyphs->getWidth()) / 2;
+    }
+    return 0;
+}
+
+Rect DigitScore::cellRect(uint8_t slot) const
+{
+    return Rect(digitsX() + slot * glyphs->getWidth(), 0, glyphs->getWidth(), glyphs->getHeight());
+}
+
+Rect DigitScore::setValue(uint32_t value)
+{
+    if (!glyphs)
+    {
+        return Rect();
+    }
+
+    uint8_t newDigits[MAX_DIGITS];
+    uint8_t newCount = 0;
+    uint8_t reversed[MAX_DIGITS];
+
+    do
+    {
+        reversed[newCount++] = value % 10;
+        value /= 10;
+    } while (value > 0 && newCount < MAX_DIGITS);
+
+    for (uint8_t i = 0; i < newCount; i++)
+    {
+        newDigits[i] = reversed[newCount - 1 - i];
+    }
+
+    Rect changed;
+    if (newCount != count)
+    {
+        // Number got longer (or shorter): the cells move, redraw the whole widget
+        changed = Rect(0, 0, getWidth(), getHeight());
+    }
+    else
+    {
+        for (uint8_t i = 0; i < count; i++)
+        {
+            if (newDigits[i] != digits[i])
+            {
+                changed.expandToFit(cellRect(i));
+            }
+        }
+    }
+
+    memcpy(digits, newDigits, newCount);
+    count = newCount;
+    return changed;
+}
+
+void DigitScore::draw(const Rect &invalidatedArea) const
+{
+    Rect background[3];
+
+    if (!glyphs)
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        Rect cell = cellRect(i);
+        Rect part = cell & invalidatedArea;
+        if (part.isEmpty())
+        {
+            continue;
+        }
+
+        // drawPartialBitmap takes the visible part relative to the bitmap
+        Rect absolute = cell;
+        translateRectToAbsolute(absolute);
+        part.x -= cell.x;
+        part.y -= cell.y;
+        HAL::lcd().drawPartialBitmap(Bitmap(glyphs->getGlyph(digits[i])), absolute.x, absolute.y, part, 255);
+    }
+
+    // Background left, right and below the digits
+    int16_t x = digitsX();
+    int16_t digitsWidth = count * glyphs->getWidth();
+    background[0] = Rect(0, 0, x, getHeight());
+    background[1] = Rect(x + digitsWidth, 0, getWidth() - x - digitsWidth, getHeight());
+    background[2] = Rect(x, glyphs->getHeight(), digitsWidth, getHeight() - glyphs->getHeight());
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        Rect part = background[i] & invalidatedArea;
+        if (!part.isEmpty())
+        {
+            translateRectToAbsolute(part);
+            HAL::lcd().fillRect(part, backgroundColor, 255);
+        }
+    }
+}
+
+void DigitScore::drawInto(uint16_t *buffer, uint16_t stride, const Rect &area) const
+{
+    if (!glyphs)
+    {
+        return;
+    }
+
+    Rect clipped = area & Rect(0, 0, getWidth(), getHeight());
+    int16_t x0 = digitsX();
+    int16_t glyphWidth = glyphs->getWidth();
+    int16_t glyphHeight = glyphs->getHeight();
+    uint8_t r = Color::getRed(backgroundColor);
+    uint8_t g = Color::getGreen(backgroundColor);
+    uint8_t b = Color::getBlue(backgroundColor);
+    uint16_t background565 = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+
+    for (int16_t y = clipped.y; y < clipped.bottom(); y++)
+    {
+        uint16_t *row = buffer + y * stride;
+        int16_t x = clipped.x;
+
+        while (x < clipped.right())
+        {
+            int16_t slot = (x - x0) / glyphWidth;
+            if (x < x0 || slot >= count || y >= glyphHeight)
+            {
+                row[x++] = background565;
+                continue;
+            }
+
+            // Copy the rest of this glyph row in one go
+            int16_t glyphX = x - x0 - slot * glyphWidth;
+            int16_t run = glyphWidth - glyphX;
+            if (x + run > clipped.right())
+            {
+                run = clipped.right() - x;
+            }
+            const uint16_t *glyph = reinterpret_cast<const uint16_t *>(Bitmap(glyphs->getGlyph(digits[slot])).getData());
+            memcpy(row + x, glyph + y * glyphWidth + glyphX, run * sizeof(uint16_t));
+            x += run;
+        }
+    }
+}
+
+Rect DigitScore::getSolidRect() const
+{
+    return Rect(0, 0, getWidth(), getHeight());
+}
@@ -3,10 +3,13 @@
 #include <touchgfx/transitions/NoTransition.hpp>
 #include <gui/screen3_screen/Screen3View.hpp>
 #include <gui/screen3_screen/Screen3Presenter.hpp>
+#include <gui/benchmark_screen/BenchmarkView.hpp>
+#include <gui/benchmark_screen/BenchmarkPresenter.hpp>
 
 FrontendApplication::FrontendApplication(Model &m, FrontendHeap &heap)
     : FrontendApplicationBase(m, heap),
-      screen3TransitionCallback(this, &FrontendApplication::gotoScreen3ScreenNoTransitionImpl)
+      screen3TransitionCallback(this, &FrontendApplication::gotoScreen3ScreenNoTransitionImpl),
+      benchmarkTransitionCallback(this, &FrontendApplication::gotoBenchmarkScreenNoTransitionImpl)
 {
 }
 
@@ -19,3 +22,13 @@ void FrontendApplication::gotoScreen3ScreenNoTransitionImpl()
 {
     touchgfx::makeTransition<Screen3View, Screen3Presenter, touchgfx::NoTransition, Model>(&currentScreen, &currentPresenter, frontendHeap, &currentTransition, &model);
 }
+
+void FrontendApplication::gotoBenchmarkScreenNoTransition()
+{
+    pendingScreenTransitionCallback = &benchmarkTransitionCallback;
+}
+
+void FrontendApplication::gotoBenchmarkScreenNoTransitionImpl()
+{
+    touchgfx::makeTransition<BenchmarkView, BenchmarkPresenter, touchgfx::NoTransition, Model>(&currentScreen, &currentPresenter, frontendHeap, &currentTransition, &model);
+}
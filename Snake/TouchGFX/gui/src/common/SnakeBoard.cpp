@@ -0,0 +1,356 @@
+#include <gui/common/SnakeBoard.hpp>
+#include <touchgfx/hal/HAL.hpp>
+#include <touchgfx/lcd/LCD.hpp>
+#include <touchgfx/Color.hpp>
+
+#ifndef SIMULATOR
+#include <TileBatchDMA.hpp>
+#include <BitmapPreloader.hpp>
+#include "perf_counter.h"
+#endif
+
+#if SNAKE_SPRITES_L8
+#include <gui/common/SnakeSprites.hpp>
+#endif
+
+using namespace touchgfx;
+
+SnakeBoard::SnakeBoard()
+    : batched(SNAKE_BOARD_BATCHED != 0), hasBackground(false), backgroundColor(0), backgroundTile(BITMAP_INVALID)
+{
+    setPosition(0, 0, GAME_AREA_WIDTH, GAME_AREA_HEIGHT);
+
+#if SNAKE_SPRITES_L8 && !defined(SIMULATOR)
+    // Shared sprite palette, loaded into the DMA2D CLUT once and kept there
+    TileBatchDMA::getInstance().setClut(snakeSpritePaletteL8, SNAKE_SPRITE_PALETTE_SIZE);
+#endif
+
+    for (uint16_t i = 0; i < GRID_WIDTH * GRID_HEIGHT; i++)
+    {
+        cells[i] = BITMAP_INVALID;
+    }
+}
+
+void SnakeBoard::setCell(int16_t x, int16_t y, BitmapId id)
+{
+    if (x < 0 || x >= GRID_WIDTH || y < 0 || y >= GRID_HEIGHT)
+    {
+        return;
+    }
+
+    cells[cellIndex(x, y)] = id;
+
+    Rect cell(x * CELL_SIZE, y * CELL_SIZE, CELL_SIZE, CELL_SIZE);
+    invalidateRect(cell);
+}
+
+void SnakeBoard::clearAll()
+{
+    for (uint16_t i = 0; i < GRID_WIDTH * GRID_HEIGHT; i++)
+    {
+        cells[i] = BITMAP_INVALID;
+    }
+    invalidate();
+}
+
+void SnakeBoard::setBackground(colortype color)
+{
+    hasBackground = true;
+    backgroundColor = color;
+    backgroundTile = BITMAP_INVALID;
+    invalidate();
+}
+
+void SnakeBoard::setBackgroundTile(BitmapId tile)
+{
+    hasBackground = true;
+    backgroundTile = tile;
+    invalidate();
+}
+
+Rect SnakeBoard::getSolidRect() const
+{
+    // Without a background, empty cells show the widgets underneath
+    return hasBackground ? Rect(0, 0, getWidth(), getHeight()) : Rect();
+}
+
+Rect SnakeBoard::emptyCellPart(const Rect &area, int16_t x, int16_t y) const
+{
+    if (!hasBackground || cells[cellIndex(x, y)] != BITMAP_INVALID)
+    {
+        return Rect();
+    }
+
+    Rect cell(x * CELL_SIZE, y * CELL_SIZE, CELL_SIZE, CELL_SIZE);
+    return cell & area;
+}
+
+void SnakeBoard::draw(const Rect &invalidatedArea) const
+{
+    if (invalidatedArea.isEmpty())
+    {
+        return;
+    }
+
+    int16_t firstX = invalidatedArea.x / CELL_SIZE;
+    int16_t firstY = invalidatedArea.y / CELL_SIZE;
+    int16_t lastX = (invalidatedArea.right() - 1) / CELL_SIZE;
+    int16_t lastY = (invalidatedArea.bottom() - 1) / CELL_SIZE;
+
+    if (lastX >= GRID_WIDTH)
+        lastX = GRID_WIDTH - 1;
+    if (lastY >= GRID_HEIGHT)
+        lastY = GRID_HEIGHT - 1;
+
+#ifndef SIMULATOR
+    if (batched)
+    {
+        drawBatched(invalidatedArea, firstX, lastX, firstY, lastY);
+        return;
+    }
+#endif
+
+    if (hasBackground)
+    {
+        clearPerCell(invalidatedArea, firstX, lastX, firstY, lastY);
+    }
+    drawPerCell(invalidatedArea, firstX, lastX, firstY, lastY);
+}
+
+void SnakeBoard::clearPerCell(const Rect &area, int16_t firstX, int16_t lastX, int16_t firstY, int16_t lastY) const
+{
+    Rect absolute = getAbsoluteRect();
+    uint16_t clears = 0;
+
+#ifndef SIMULATOR
+    uint32_t startCycles = PerfCounter_GetCycles();
+#endif
+
+    for (int16_t y = firstY; y <= lastY; y++)
+    {
+        for (int16_t x = firstX; x <= lastX; x++)
+        {
+            Rect part = emptyCellPart(area, x, y);
+            if (part.isEmpty())
+            {
+                continue;
+            }
+
+            if (backgroundTile != BITMAP_INVALID)
+            {
+                Rect source(part.x - x * CELL_SIZE, part.y - y * CELL_SIZE, part.width, part.height);
+                HAL::lcd().drawPartialBitmap(Bitmap(backgroundTile), absolute.x + x * CELL_SIZE, absolute.y + y * CELL_SIZE, source, 255);
+            }
+            else
+            {
+                part.x += absolute.x;
+                part.y += absolute.y;
+                HAL::lcd().fillRect(part, backgroundColor, 255);
+            }
+            clears++;
+        }
+    }
+
+#ifndef SIMULATOR
+    if (clears != 0)
+    {
+        HAL::getInstance()->flushDMA();
+        TileBatchDMA::getInstance().noteClears(clears, PerfCounter_GetCycles() - startCycles);
+    }
+#else
+    (void)clears;
+#endif
+}
+
+void SnakeBoard::drawPerCell(const Rect &area, int16_t firstX, int16_t lastX, int16_t firstY, int16_t lastY) const
+{
+    Rect absolute = getAbsoluteRect();
+    uint16_t blits = 0;
+
+#ifndef SIMULATOR
+    uint32_t startCycles = PerfCounter_GetCycles();
+#endif
+
+    for (int16_t y = firstY; y <= lastY; y++)
+    {
+        for (int16_t x = firstX; x <= lastX; x++)
+        {
+            BitmapId id = cells[cellIndex(x, y)];
+            if (id == BITMAP_INVALID)
+            {
+                continue;
+            }
+
+            Rect cell(x * CELL_SIZE, y * CELL_SIZE, CELL_SIZE, CELL_SIZE);
+            Rect part = cell & area;
+            if (part.isEmpty())
+            {
+                continue;
+            }
+
+            // Visible part of the sprite, relative to the sprite itself
+            part.x -= cell.x;
+            part.y -= cell.y;
+            HAL::lcd().drawPartialBitmap(Bitmap(id), absolute.x + cell.x, absolute.y + cell.y, part, 255);
+            blits++;
+        }
+    }
+
+#ifndef SIMULATOR
+    // Wait for the queued blits so the timing covers the same work as the batched path
+    HAL::getInstance()->flushDMA();
+    TileBatchDMA::getInstance().noteDirectBlits(blits, PerfCounter_GetCycles() - startCycles);
+#else
+    (void)blits;
+#endif
+}
+
+#ifndef SIMULATOR
+void SnakeBoard::drawBatched(const Rect &area, int16_t firstX, int16_t lastX, int16_t firstY, int16_t lastY) const
+{
+    Rect absolute = getAbsoluteRect();
+    TileBatchDMA &batch = TileBatchDMA::getInstance();
+    const BitmapPreloader &preloader = BitmapPreloader::getInstance();
+    const uint16_t stride = HAL::FRAME_BUFFER_WIDTH;
+
+    uint16_t *frameBuffer = static_cast<uint16_t *>(HAL::getInstance()->lockFrameBuffer());
+
+    if (hasBackground)
+    {
+        clearBatched(frameBuffer, area, firstX, lastX, firstY, lastY);
+    }
+
+    for (int16_t y = firstY; y <= lastY; y++)
+    {
+        for (int16_t x = firstX; x <= lastX; x++)
+        {
+            BitmapId id = cells[cellIndex(x, y)];
+            if (id == BITMAP_INVALID)
+            {
+                continue;
+            }
+
+            Rect cell(x * CELL_SIZE, y * CELL_SIZE, CELL_SIZE, CELL_SIZE);
+            Rect part = cell & area;
+            if (part.isEmpty())
+            {
+                continue;
+            }
+
+            if (batch.getQueuedCount() >= TileBatchDMA::MAX_COMMANDS)
+            {
+                // Batch full: run what we have and start a new one
+                batch.execute();
+            }
+
+            uint16_t *dst = frameBuffer + (absolute.y + part.y) * stride + (absolute.x + part.x);
+
+#if SNAKE_SPRITES_L8
+            const SnakeSpriteL8 *sprite = SnakeSprites::findL8(id);
+            if (sprite)
+            {
+                // SDRAM copy once the boot-time preload has finished
+                const uint8_t *indices = static_cast<const uint8_t *>(preloader.resolve(sprite->indices));
+                const uint8_t *src = indices + (part.y - cell.y) * sprite->stride + (part.x - cell.x);
+                batch.queueCopyL8(src, sprite->stride, dst, stride, part.width, part.height);
+                continue;
+            }
+#endif
+
+            Bitmap bitmap(id);
+            if (bitmap.getFormat() != Bitmap::RGB565)
+            {
+                // Only opaque RGB565 sprites can be copied without blending
+                Rect source(part.x - cell.x, part.y - cell.y, part.width, part.height);
+                HAL::lcd().drawPartialBitmap(bitmap, absolute.x + cell.x, absolute.y + cell.y, source, 255);
+                continue;
+            }
+
+            const uint16_t *src = static_cast<const uint16_t *>(preloader.resolve(bitmap.getData())) +
+                                  (part.y - cell.y) * bitmap.getWidth() + (part.x - cell.x);
+            batch.queueCopy(src, bitmap.getWidth(), dst, stride, part.width, part.height);
+        }
+    }
+
+    batch.execute();
+
+    HAL::getInstance()->unlockFrameBuffer();
+}
+
+void SnakeBoard::clearBatched(uint16_t *frameBuffer, const Rect &area, int16_t firstX, int16_t lastX, int16_t firstY, int16_t lastY) const
+{
+    Rect absolute = getAbsoluteRect();
+    TileBatchDMA &batch = TileBatchDMA::getInstance();
+    const uint16_t stride = HAL::FRAME_BUFFER_WIDTH;
+
+    const uint16_t *tile = 0;
+    uint16_t tileStride = 0;
+    if (backgroundTile != BITMAP_INVALID)
+    {
+        Bitmap bitmap(backgroundTile);
+        if (bitmap.getFormat() != Bitmap::RGB565)
+        {
+            // Only opaque RGB565 tiles can be copied without blending
+            clearPerCell(area, firstX, lastX, firstY, lastY);
+            return;
+        }
+        tile = static_cast<const uint16_t *>(BitmapPreloader::getInstance().resolve(bitmap.getData()));
+        tileStride = bitmap.getWidth();
+    }
+
+    uint8_t r = Color::getRed(backgroundColor);
+    uint8_t g = Color::getGreen(backgroundColor);
+    uint8_t b = Color::getBlue(backgroundColor);
+    uint16_t background565 = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+
+    // Clears run as their own batch so their DMA2D time can be told apart from the sprites
+    uint16_t clears = 0;
+    uint32_t cycles = 0;
+
+    for (int16_t y = firstY; y <= lastY; y++)
+    {
+        for (int16_t x = firstX; x <= lastX; x++)
+        {
+            Rect part = emptyCellPart(area, x, y);
+            if (part.isEmpty())
+            {
+                continue;
+            }
+
+            if (batch.getQueuedCount() >= TileBatchDMA::MAX_COMMANDS)
+            {
+                batch.execute();
+                cycles += batch.getLastBatchCycles();
+            }
+
+            uint16_t *dst = frameBuffer + (absolute.y + part.y) * stride + (absolute.x + part.x);
+            if (tile)
+            {
+                const uint16_t *src = tile + (part.y - y * CELL_SIZE) * tileStride + (part.x - x * CELL_SIZE);
+                batch.queueCopy(src, tileStride, dst, stride, part.width, part.height);
+            }
+            else
+            {
+                batch.queueFill(background565, dst, stride, part.width, part.height);
+            }
+            clears++;
+        }
+    }
+
+    if (batch.getQueuedCount() != 0)
+    {
+        batch.execute();
+        cycles += batch.getLastBatchCycles();
+    }
+
+    if (clears != 0)
+    {
+        batch.noteClears(clears, cycles);
+    }
+}
+#else
+void SnakeBoard::drawBatched(const Rect &area, int16_t firstX, int16_t lastX, int16_t firstY, int16_t lastY) const
+{
+    drawPerCell(area, firstX, lastX, firstY, lastY);
+}
+#endif
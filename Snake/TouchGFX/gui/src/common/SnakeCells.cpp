@@ -0,0 +1,155 @@
+#include <gui/common/SnakeCells.hpp>
+
+namespace
+{
+// Quarter turns counter-clockwise from "up"
+uint8_t directionRotation(SnakeDirection dir)
+{
+    switch (dir)
+    {
+    case SNAKE_DIR_LEFT:
+        return 1;
+    case SNAKE_DIR_DOWN:
+        return 2;
+    case SNAKE_DIR_RIGHT:
+        return 3;
+    case SNAKE_DIR_UP:
+    default:
+        return 0;
+    }
+}
+
+// Check if segment is a turn segment and get directions
+bool isTurnSegment(const SnakeGame &game, uint8_t index, SnakeDirection &fromDir, SnakeDirection &toDir)
+{
+    if (index == 0 || index >= game.getSnakeLength() - 1)
+    {
+        return false; // Head and tail are not turn segments
+    }
+
+    // Get positions of previous (towards head), current, and next (towards tail) segments
+    Position prev = game.getSnakeSegment(index - 1); // towards head
+    Position curr = game.getSnakeSegment(index);
+    Position next = game.getSnakeSegment(index + 1); // towards tail
+
+    // Calculate direction from current to prev (towards head)
+    int16_t dx1 = prev.x - curr.x;
+    int16_t dy1 = prev.y - curr.y;
+
+    // Handle wrap-around
+    if (dx1 > 1)
+        dx1 = -1;
+    if (dx1 < -1)
+        dx1 = 1;
+    if (dy1 > 1)
+        dy1 = -1;
+    if (dy1 < -1)
+        dy1 = 1;
+
+    // Calculate direction from next to current (from tail towards this segment)
+    int16_t dx2 = curr.x - next.x;
+    int16_t dy2 = curr.y - next.y;
+
+    // Handle wrap-around
+    if (dx2 > 1)
+        dx2 = -1;
+    if (dx2 < -1)
+        dx2 = 1;
+    if (dy2 > 1)
+        dy2 = -1;
+    if (dy2 < -1)
+        dy2 = 1;
+
+    // toDir = direction this segment is "exiting" (towards head)
+    if (dx1 > 0)
+        toDir = SNAKE_DIR_RIGHT;
+    else if (dx1 < 0)
+        toDir = SNAKE_DIR_LEFT;
+    else if (dy1 > 0)
+        toDir = SNAKE_DIR_DOWN;
+    else if (dy1 < 0)
+        toDir = SNAKE_DIR_UP;
+    else
+        return false;
+
+    // fromDir = direction this segment is "entering" (from tail)
+    if (dx2 > 0)
+        fromDir = SNAKE_DIR_RIGHT;
+    else if (dx2 < 0)
+        fromDir = SNAKE_DIR_LEFT;
+    else if (dy2 > 0)
+        fromDir = SNAKE_DIR_DOWN;
+    else if (dy2 < 0)
+        fromDir = SNAKE_DIR_UP;
+    else
+        return false;
+
+    // It's a turn if directions are perpendicular
+    bool fromHorizontal = (fromDir == SNAKE_DIR_LEFT || fromDir == SNAKE_DIR_RIGHT);
+    bool toHorizontal = (toDir == SNAKE_DIR_LEFT || toDir == SNAKE_DIR_RIGHT);
+
+    return fromHorizontal != toHorizontal;
+}
+
+uint8_t turnRotation(SnakeDirection fromDir, SnakeDirection toDir)
+{
+    // TURN (┌): coming from UP going RIGHT, or coming from LEFT going DOWN
+    // TURN1 (└): coming from DOWN going RIGHT, or coming from LEFT going UP
+    // TURN2 (┘): coming from DOWN going LEFT, or coming from RIGHT going UP
+    // TURN3 (┐): coming from UP going LEFT, or coming from RIGHT going DOWN
+    if ((fromDir == SNAKE_DIR_DOWN && toDir == SNAKE_DIR_RIGHT) ||
+        (fromDir == SNAKE_DIR_LEFT && toDir == SNAKE_DIR_UP))
+    {
+        return 1;
+    }
+    if ((fromDir == SNAKE_DIR_DOWN && toDir == SNAKE_DIR_LEFT) ||
+        (fromDir == SNAKE_DIR_RIGHT && toDir == SNAKE_DIR_UP))
+    {
+        return 2;
+    }
+    if ((fromDir == SNAKE_DIR_UP && toDir == SNAKE_DIR_LEFT) ||
+        (fromDir == SNAKE_DIR_RIGHT && toDir == SNAKE_DIR_DOWN))
+    {
+        return 3;
+    }
+    return 0;
+}
+} // namespace
+
+SnakeCellSprite SnakeCells_getSprite(const SnakeGame &game, uint8_t index)
+{
+    SnakeCellSprite sprite;
+    uint8_t snakeLen = game.getSnakeLength();
+
+    if (index == 0)
+    {
+        // Head - use current direction
+        sprite.shape = CELL_HEAD;
+        sprite.rotation = directionRotation(game.getCurrentDirection());
+    }
+    else if (index == snakeLen - 1)
+    {
+        // Tail - use segment direction
+        sprite.shape = CELL_TAIL;
+        sprite.rotation = directionRotation(game.getSegmentDirection(index));
+    }
+    else
+    {
+        // Body segment - check if it's a turn
+        SnakeDirection fromDir, toDir;
+        if (isTurnSegment(game, index, fromDir, toDir))
+        {
+            sprite.shape = CELL_TURN;
+            sprite.rotation = turnRotation(fromDir, toDir);
+        }
+        else
+        {
+            // Straight segment: vertical or horizontal
+            SnakeDirection segDir = game.getSegmentDirection(index);
+            sprite.shape = CELL_MID;
+            sprite.rotation = (segDir == SNAKE_DIR_LEFT || segDir == SNAKE_DIR_RIGHT) ? 1 : 0;
+        }
+    }
+
+    return sprite;
+}
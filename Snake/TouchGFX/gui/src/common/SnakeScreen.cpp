@@ -0,0 +1,114 @@
+#include <gui/common/SnakeScreen.hpp>
+#include <string.h>
+
+SnakeScreen::SnakeScreen()
+{
+    reset();
+}
+
+void SnakeScreen::reset()
+{
+    memset(cells, SNAKE_SCREEN_EMPTY, sizeof(cells));
+    foodShown = false;
+    food.x = 0;
+    food.y = 0;
+    bigFoodShown = false;
+    bigFood.x = 0;
+    bigFood.y = 0;
+    barFill = 0;
+}
+
+void SnakeScreen::updateBoard(const SnakeGame &game, SnakeScreenListener &listener)
+{
+    // Build the new board, then report only the cells whose sprite changed
+    // (typically new head, old head and old/new tail)
+    memset(next, SNAKE_SCREEN_EMPTY, sizeof(next));
+    for (uint8_t i = 0; i < game.getSnakeLength(); i++)
+    {
+        Position pos = game.getSnakeSegment(i);
+        SnakeCellSprite sprite = SnakeCells_getSprite(game, i);
+        next[pos.y * GRID_WIDTH + pos.x] = 1 + sprite.shape * 4 + sprite.rotation;
+    }
+
+    for (int16_t y = 0; y < GRID_HEIGHT; y++)
+    {
+        for (int16_t x = 0; x < GRID_WIDTH; x++)
+        {
+            uint16_t i = y * GRID_WIDTH + x;
+            if (next[i] != cells[i])
+            {
+                cells[i] = next[i];
+                listener.cellChanged(x, y, cells[i]);
+            }
+        }
+    }
+
+    // Food only moves when it is eaten
+    Position foodPos = game.getFoodPosition();
+    if (!foodShown || !(foodPos == food))
+    {
+        bool wasShown = foodShown;
+        Position from = food;
+        foodShown = true;
+        food = foodPos;
+        listener.foodChanged(wasShown, from, food);
+    }
+
+    bool active = game.isBigFoodActive();
+    Position bigFoodPos = game.getBigFoodPosition();
+    if (active != bigFoodShown || (active && !(bigFoodPos == bigFood)))
+    {
+        bool wasShown = bigFoodShown;
+        Position from = bigFood;
+        bigFoodShown = active;
+        if (active)
+        {
+            bigFood = bigFoodPos;
+        }
+        listener.bigFoodChanged(wasShown, from, bigFoodShown, bigFood);
+    }
+}
+
+void SnakeScreen::updateBar(const SnakeGame &game, SnakeScreenListener &listener)
+{
+    uint32_t timeLeftMs = game.isBigFoodActive() ? game.getBigFoodTimeLeftMs() : 0;
+    if (timeLeftMs > BIGFOOD_DURATION_MS)
+    {
+        timeLeftMs = BIGFOOD_DURATION_MS;
+    }
+
+    int16_t fill = (int16_t)((uint32_t)BIGFOOD_BAR_WIDTH * timeLeftMs / BIGFOOD_DURATION_MS);
+    if (fill == barFill)
+    {
+        return;
+    }
+
+    // Only the columns between the old and the new end of the bar change colour
+    int16_t first = fill < barFill ? fill : barFill;
+    int16_t count = fill < barFill ? barFill - fill : fill - barFill;
+    barFill = fill;
+    listener.barChanged(first, count);
+}
+
+SnakeScreenArea SnakeScreen::cellArea(int16_t x, int16_t y)
+{
+    SnakeScreenArea area = {(int16_t)(x * CELL_SIZE), (int16_t)(y * CELL_SIZE), CELL_SIZE, CELL_SIZE};
+    return area;
+}
+
+SnakeScreenArea SnakeScreen::foodArea(Position food)
+{
+    return cellArea(food.x, food.y);
+}
+
+SnakeScreenArea SnakeScreen::bigFoodArea(Position bigFood)
+{
+    SnakeScreenArea area = {(int16_t)(bigFood.x * CELL_SIZE), (int16_t)(bigFood.y * CELL_SIZE), BIGFOOD_SIZE, BIGFOOD_SIZE};
+    return area;
+}
+
+SnakeScreenArea SnakeScreen::barArea(int16_t first, int16_t count)
+{
+    SnakeScreenArea area = {(int16_t)(BIGFOOD_BAR_X + first), (int16_t)(HUD_Y + BIGFOOD_BAR_Y), count, BIGFOOD_BAR_HEIGHT};
+    return area;
+}
@@ -0,0 +1,232 @@
+#include <gui/common/SnakeSprites.hpp>
+#include <gui/common/SnakeGame.hpp>
+
+#ifndef SIMULATOR
+#include "perf_counter.h"
+#include <FrameBufferConfig.hpp>
+#endif
+
+using namespace touchgfx;
+
+BitmapId BITMAP_HEAD_ID = BITMAP_INVALID;
+BitmapId BITMAP_TAIL_ID = BITMAP_INVALID;
+BitmapId BITMAP_MID_ID = BITMAP_INVALID;
+BitmapId BITMAP_TURN_ID = BITMAP_INVALID;
+BitmapId BITMAP_HEAD1_ID = BITMAP_INVALID;
+BitmapId BITMAP_HEAD2_ID = BITMAP_INVALID;
+BitmapId BITMAP_HEAD3_ID = BITMAP_INVALID;
+BitmapId BITMAP_TAIL1_ID = BITMAP_INVALID;
+BitmapId BITMAP_TAIL2_ID = BITMAP_INVALID;
+BitmapId BITMAP_TAIL3_ID = BITMAP_INVALID;
+BitmapId BITMAP_MID1_ID = BITMAP_INVALID;
+BitmapId BITMAP_TURN1_ID = BITMAP_INVALID;
+BitmapId BITMAP_TURN2_ID = BITMAP_INVALID;
+BitmapId BITMAP_TURN3_ID = BITMAP_INVALID;
+
+uint32_t SnakeSprites::generatedBytes = 0;
+uint32_t SnakeSprites::generateCycles = 0;
+
+namespace
+{
+struct ExpandedSprite
+{
+    BitmapId *id;  // Id to fill in
+    uint8_t index; // Entry in snakeSpritesL8
+};
+
+const ExpandedSprite expandedSprites[SnakeSprites::EXPANDED_COUNT] = {
+    {&BITMAP_HEAD_ID, SNAKE_SPRITE_HEAD},
+    {&BITMAP_TAIL_ID, SNAKE_SPRITE_TAIL},
+    {&BITMAP_MID_ID, SNAKE_SPRITE_MID},
+    {&BITMAP_TURN_ID, SNAKE_SPRITE_TURN},
+};
+
+struct RotatedSprite
+{
+    BitmapId *id;           // Id to fill in
+    const BitmapId *source; // Canonical sprite (expanded first)
+    uint8_t quarterTurns;   // Counter-clockwise quarter turns
+};
+
+const RotatedSprite rotatedSprites[SnakeSprites::ROTATED_COUNT] = {
+    {&BITMAP_HEAD1_ID, &BITMAP_HEAD_ID, 1},
+    {&BITMAP_HEAD2_ID, &BITMAP_HEAD_ID, 2},
+    {&BITMAP_HEAD3_ID, &BITMAP_HEAD_ID, 3},
+    {&BITMAP_TAIL1_ID, &BITMAP_TAIL_ID, 1},
+    {&BITMAP_TAIL2_ID, &BITMAP_TAIL_ID, 2},
+    {&BITMAP_TAIL3_ID, &BITMAP_TAIL_ID, 3},
+    {&BITMAP_MID1_ID, &BITMAP_MID_ID, 1},
+    {&BITMAP_TURN1_ID, &BITMAP_TURN_ID, 1},
+    {&BITMAP_TURN2_ID, &BITMAP_TURN_ID, 2},
+    {&BITMAP_TURN3_ID, &BITMAP_TURN_ID, 3},
+};
+
+#if !SNAKE_PARTIAL_FRAMEBUFFER
+// Rotated L8 copies, next to the framebuffers in SDRAM
+const uint16_t ROTATED_L8_MAX_PIXELS = CELL_SIZE * CELL_SIZE;
+LOCATION_PRAGMA_NOLOAD("TouchGFX_Framebuffer")
+uint8_t rotatedL8Data[SnakeSprites::ROTATED_COUNT][ROTATED_L8_MAX_PIXELS] LOCATION_ATTRIBUTE_NOLOAD("TouchGFX_Framebuffer");
+SnakeSpriteL8 rotatedL8[SnakeSprites::ROTATED_COUNT];
+#endif
+uint8_t rotatedL8Count = 0;
+
+// RGB565 copy of an L8 sprite. The palette holds RGB565 colours expanded by bit
+// replication, so taking the top bits of each channel gives them back exactly.
+void expand(const SnakeSpriteL8 &sprite, uint16_t *dst)
+{
+    for (uint16_t y = 0; y < sprite.height; y++)
+    {
+        const uint8_t *src = sprite.indices + y * sprite.stride;
+        for (uint16_t x = 0; x < sprite.width; x++)
+        {
+            uint32_t argb = snakeSpritePaletteL8[src[x]];
+            *dst++ = ((argb >> 8) & 0xF800) | ((argb >> 5) & 0x07E0) | ((argb >> 3) & 0x001F);
+        }
+    }
+}
+
+// Rotate a width x height image (srcStride pixels per source line) counter-clockwise
+// by quarterTurns * 90 degrees into a packed destination
+template <typename T>
+void rotate(const T *src, uint16_t srcStride, T *dst, uint16_t width, uint16_t height, uint8_t quarterTurns)
+{
+    uint16_t dstWidth = (quarterTurns & 1) ? height : width;
+    uint16_t dstHeight = (quarterTurns & 1) ? width : height;
+
+    for (uint16_t y = 0; y < dstHeight; y++)
+    {
+        for (uint16_t x = 0; x < dstWidth; x++)
+        {
+            uint16_t sx, sy;
+            switch (quarterTurns & 3)
+            {
+            case 1:
+                sx = width - 1 - y;
+                sy = x;
+                break;
+            case 2:
+                sx = width - 1 - x;
+                sy = height - 1 - y;
+                break;
+            case 3:
+                sx = y;
+                sy = height - 1 - x;
+                break;
+            default:
+                sx = x;
+                sy = y;
+                break;
+            }
+            dst[y * dstWidth + x] = src[sy * srcStride + sx];
+        }
+    }
+}
+} // namespace
+
+bool SnakeSprites::generateSprites()
+{
+#ifndef SIMULATOR
+    uint32_t startCycles = PerfCounter_GetCycles();
+#endif
+    bool ok = true;
+
+    generatedBytes = 0;
+    rotatedL8Count = 0;
+
+    for (uint8_t i = 0; i < EXPANDED_COUNT; i++)
+    {
+        const SnakeSpriteL8 &sprite = snakeSpritesL8[expandedSprites[i].index];
+        BitmapId id = Bitmap::dynamicBitmapCreate(sprite.width, sprite.height, Bitmap::RGB565);
+        if (id == BITMAP_INVALID)
+        {
+            ok = false;
+            continue;
+        }
+
+        expand(sprite, reinterpret_cast<uint16_t *>(Bitmap::dynamicBitmapGetAddress(id)));
+        *expandedSprites[i].id = id;
+        generatedBytes += sprite.width * sprite.height * 2;
+    }
+
+    for (uint8_t i = 0; i < ROTATED_COUNT; i++)
+    {
+        const RotatedSprite &r = rotatedSprites[i];
+        if (*r.source == BITMAP_INVALID)
+        {
+            ok = false;
+            continue;
+        }
+
+        Bitmap source(*r.source);
+        uint16_t width = source.getWidth();
+        uint16_t height = source.getHeight();
+        uint16_t dstWidth = (r.quarterTurns & 1) ? height : width;
+        uint16_t dstHeight = (r.quarterTurns & 1) ? width : height;
+
+        if (source.getFormat() != Bitmap::RGB565)
+        {
+            ok = false;
+            continue;
+        }
+
+        BitmapId id = Bitmap::dynamicBitmapCreate(dstWidth, dstHeight, Bitmap::RGB565);
+        if (id == BITMAP_INVALID)
+        {
+            ok = false;
+            continue;
+        }
+
+        rotate(reinterpret_cast<const uint16_t *>(source.getData()), width,
+               reinterpret_cast<uint16_t *>(Bitmap::dynamicBitmapGetAddress(id)),
+               width, height, r.quarterTurns);
+        *r.id = id;
+        generatedBytes += dstWidth * dstHeight * 2;
+
+#if !SNAKE_PARTIAL_FRAMEBUFFER
+        // Matching L8 copy for the batched board path (not used without SDRAM)
+        const SnakeSpriteL8 *sourceL8 = findL8(*r.source);
+        if (sourceL8 && sourceL8->width * sourceL8->height <= ROTATED_L8_MAX_PIXELS)
+        {
+            // Read from the flash atlas, stored packed (the rotated copies are not part of it)
+            rotate(sourceL8->indices, sourceL8->stride, rotatedL8Data[rotatedL8Count], sourceL8->width, sourceL8->height, r.quarterTurns);
+            SnakeSpriteL8 &l8 = rotatedL8[rotatedL8Count];
+            l8.bitmapId = id;
+            l8.width = dstWidth;
+            l8.height = dstHeight;
+            l8.stride = dstWidth;
+            l8.indices = rotatedL8Data[rotatedL8Count];
+            rotatedL8Count++;
+        }
+#endif
+    }
+
+#ifndef SIMULATOR
+    generateCycles = PerfCounter_GetCycles() - startCycles;
+#endif
+    return ok;
+}
+
+const SnakeSpriteL8 *SnakeSprites::findL8(BitmapId id)
+{
+    if (id == BITMAP_INVALID)
+    {
+        return 0;
+    }
+    for (uint8_t i = 0; i < EXPANDED_COUNT; i++)
+    {
+        if (*expandedSprites[i].id == id)
+        {
+            return &snakeSpritesL8[expandedSprites[i].index];
+        }
+    }
+#if !SNAKE_PARTIAL_FRAMEBUFFER
+    for (uint8_t i = 0; i < rotatedL8Count; i++)
+    {
+        if (rotatedL8[i].bitmapId == id)
+        {
+            return &rotatedL8[i];
+        }
+    }
+#endif
+    return SnakeSpritesL8_find(id);
+}
@@ -0,0 +1,38 @@
+// Generated by tools/sprite_l8.py from TouchGFX/assets/sprites - do not edit
+#include <gui/common/SnakeSpritesL8.hpp>
+#include <images/BitmapDatabase.hpp>
+
+const uint32_t snakeSpritePaletteL8[SNAKE_SPRITE_PALETTE_SIZE] = {
+    0xFFFF0000, 0xFF000000, 0xFFFFFFFF,
+};
+
+// Layout (x, y, width, height):
+//   Head       0   0  10  10
+//   Tail      10   0  10  10
+//   Mid       20   0  10  10
+//   Turn      30   0  10  10
+const uint8_t snakeSpriteAtlasL8[SNAKE_SPRITE_ATLAS_WIDTH * SNAKE_SPRITE_ATLAS_HEIGHT] = {
+    1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 0, 0, 2, 0, 0, 2, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1,
+    1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1,
+};
+
+const SnakeSpriteL8 snakeSpritesL8[SNAKE_SPRITE_COUNT] = {
+    {touchgfx::BITMAP_INVALID, 10, 10, SNAKE_SPRITE_ATLAS_WIDTH, snakeSpriteAtlasL8 + 0}, // Head
+    {touchgfx::BITMAP_INVALID, 10, 10, SNAKE_SPRITE_ATLAS_WIDTH, snakeSpriteAtlasL8 + 10}, // Tail
+    {touchgfx::BITMAP_INVALID, 10, 10, SNAKE_SPRITE_ATLAS_WIDTH, snakeSpriteAtlasL8 + 20}, // Mid
+    {touchgfx::BITMAP_INVALID, 10, 10, SNAKE_SPRITE_ATLAS_WIDTH, snakeSpriteAtlasL8 + 30}, // Turn
+};
+
+const SnakeSpriteL8 *SnakeSpritesL8_find(touchgfx::BitmapId)
+{
+    // Only board sprites, which are looked up by SnakeSprites::findL8()
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include <gui/common/SwipeGesture.hpp>
+
+SwipeGesture::SwipeGesture()
+    : tracking(false), startX(0), startY(0), startMs(0)
+{
+}
+
+void SwipeGesture::anchor(int16_t x, int16_t y, uint32_t timeMs)
+{
+    tracking = true;
+    startX = x;
+    startY = y;
+    startMs = timeMs;
+}
+
+bool SwipeGesture::addSample(int16_t x, int16_t y, uint32_t timeMs, SnakeDirection &dir)
+{
+    if (!tracking || timeMs - startMs > SWIPE_MAX_MS)
+    {
+        // New stroke, or too slow to be a swipe: measure from here
+        anchor(x, y, timeMs);
+        return false;
+    }
+
+    int16_t dx = x - startX;
+    int16_t dy = y - startY;
+    int16_t adx = dx < 0 ? -dx : dx;
+    int16_t ady = dy < 0 ? -dy : dy;
+
+    // The swipe axis must be at least twice the other one; diagonals keep waiting
+    if (adx >= SWIPE_MIN_DISTANCE && adx >= 2 * ady)
+    {
+        dir = dx > 0 ? SNAKE_DIR_RIGHT : SNAKE_DIR_LEFT;
+    }
+    else if (ady >= SWIPE_MIN_DISTANCE && ady >= 2 * adx)
+    {
+        dir = dy > 0 ? SNAKE_DIR_DOWN : SNAKE_DIR_UP;
+    }
+    else
+    {
+        return false;
+    }
+
+    anchor(x, y, timeMs);
+    return true;
+}
@@ -1,492 +1,301 @@
 #include <gui/model/Model.hpp>
 #include <gui/model/ModelListener.hpp>
 #include <gui/common/SnakeGame.hpp>
-#include <gui/common/FrontendHeap.hpp>
 #include <gui/common/SnakeInterface.h>
+#include <atomic>
 
-// =====================================================
-// SnakeGame Implementation (merged from SnakeGame.cpp)
-// =====================================================
-
-SnakeGame::SnakeGame()
-    : snakeLength(3), currentDirection(SNAKE_DIR_UP), nextDirection(SNAKE_DIR_UP), score(0), gameOver(false), difficulty(NORMAL), randomState(12345), bigFoodActive(false), bigFoodStartTime(0), foodEatenCount(0), pendingSound(SOUND_NONE)
-{
-    init();
-}
-
-void SnakeGame::init()
+namespace
 {
-    reset();
-}
-
-void SnakeGame::reset()
+// Button levels from the input side, one word so a tick never sees half an
+// update (bit n = SnakeDirection n)
+std::atomic<uint32_t> buttonLevels(0);
+
+// Presses from the input side in arrival order, each with the time of its
+// first edge, so a tap shorter than a frame still arrives and two presses in
+// one frame keep their order. Any task or interrupt may push (reserve a
+// position, fill the slot, publish it); only Model::tick() pops. A press is
+// pushed before its level is stored, so a tick that sees the level also finds
+// the press.
+struct ButtonPress
 {
-    // Initialize snake in center of game area
-    snakeLength = 3;
-
-    // Head position (center of grid)
-    snake[0].x = GRID_WIDTH / 2;
-    snake[0].y = GRID_HEIGHT / 2;
-
-    // Body segments (below head - snake starts moving up)
-    snake[1].x = GRID_WIDTH / 2;
-    snake[1].y = GRID_HEIGHT / 2 + 1;
-
-    // Tail
-    snake[2].x = GRID_WIDTH / 2;
-    snake[2].y = GRID_HEIGHT / 2 + 2;
-
-    currentDirection = SNAKE_DIR_UP;
-    nextDirection = SNAKE_DIR_UP;
-    score = 0;
-    gameOver = false;
-
-    // Reset BigFood state
-    bigFoodActive = false;
-    bigFoodStartTime = 0;
-    foodEatenCount = 0;
-    pendingSound = SOUND_NONE;
-
-    // Spawn initial food
-    spawnFood();
-}
+    uint8_t direction;
+    uint32_t timeMs; // Snake_GetTickMs() clock
+};
 
-bool SnakeGame::update()
+struct PressSlot
 {
-    if (gameOver)
-    {
-        return false;
-    }
-
-    // Apply buffered direction
-    currentDirection = nextDirection;
+    std::atomic<uint32_t> published; // Position + 1 once press is filled in
+    ButtonPress press;
+};
 
-    // Move snake
-    moveSnake();
+const uint32_t PRESS_RING_SIZE = 8;
 
-    // Update BigFood timer
-    updateBigFood();
-
-    // Check for BigFood collision first (higher priority)
-    if (bigFoodActive)
-    {
-        // BigFood is 2x2 cells, check if head overlaps
-        if (snake[0].x >= bigFood.x && snake[0].x < bigFood.x + 2 &&
-            snake[0].y >= bigFood.y && snake[0].y < bigFood.y + 2)
-        {
-            growSnake();
-            // Score: 500 * (5000 - t) / 5000, where t is ms elapsed
-            uint32_t elapsedMs = getBigFoodElapsedMs();
-            if (elapsedMs > BIGFOOD_DURATION_MS)
-                elapsedMs = BIGFOOD_DURATION_MS;
-            uint32_t bigFoodScore = (BIGFOOD_MAX_SCORE * (BIGFOOD_DURATION_MS - elapsedMs)) / BIGFOOD_DURATION_MS;
-            score += (uint16_t)bigFoodScore;
-
-            bigFoodActive = false;
-            bigFoodStartTime = 0;
-            pendingSound = SOUND_EAT_BIGFOOD;
-        }
-    }
+PressSlot pressRing[PRESS_RING_SIZE];
+std::atomic<uint32_t> pressWrite(0);
+std::atomic<uint32_t> pressRead(0);
+std::atomic<uint32_t> pressOverflows(0);
 
-    // Check for normal food collision
-    if (snake[0] == food)
+void pushPress(SnakeDirection dir, uint32_t timeMs)
+{
+    // Retry if another producer took the position in between (LDREX/STREX on the target)
+    uint32_t position = pressWrite.load(std::memory_order_relaxed);
+    do
     {
-        growSnake();
-        // Score based on difficulty: EASY=1, NORMAL=3, HARD=5, INSANE=8, NIGHTMARE=12
-        switch (difficulty)
+        if (position - pressRead.load(std::memory_order_acquire) >= PRESS_RING_SIZE)
         {
-        case EASY:
-            score += 1;
-            break;
-        case NORMAL:
-            score += 3;
-            break;
-        case HARD:
-            score += 5;
-            break;
-        case INSANE:
-            score += 8;
-            break;
-        case NIGHTMARE:
-            score += 12;
-            break;
+            pressOverflows.fetch_add(1, std::memory_order_relaxed);
+            return;
         }
-        spawnFood();
-        pendingSound = SOUND_EAT_FOOD;
+    } while (!pressWrite.compare_exchange_weak(position, position + 1, std::memory_order_relaxed, std::memory_order_relaxed));
 
-        // Check if BigFood should appear
-        foodEatenCount++;
-        if (foodEatenCount >= BIGFOOD_APPEAR_AFTER && !bigFoodActive)
-        {
-            spawnBigFood();
-            foodEatenCount = 0;
-        }
-    }
+    PressSlot &slot = pressRing[position % PRESS_RING_SIZE];
+    slot.press.direction = (uint8_t)dir;
+    slot.press.timeMs = timeMs;
+    slot.published.store(position + 1, std::memory_order_release);
+}
 
-    // Check for wall or self collision
-    if (checkCollision())
+bool popPress(ButtonPress &press)
+{
+    // A reserved but not yet published slot stops the pop, so the order is kept
+    uint32_t position = pressRead.load(std::memory_order_relaxed);
+    PressSlot &slot = pressRing[position % PRESS_RING_SIZE];
+    if (slot.published.load(std::memory_order_acquire) != position + 1)
     {
-        gameOver = true;
-        pendingSound = SOUND_GAME_OVER;
         return false;
     }
-
+    press = slot.press;
+    pressRead.store(position + 1, std::memory_order_release);
     return true;
 }
 
-void SnakeGame::setDirection(SnakeDirection dir)
+uint32_t packLevels(bool up, bool down, bool left, bool right)
 {
-    // Prevent 180-degree turns
-    if ((currentDirection == SNAKE_DIR_UP && dir == SNAKE_DIR_DOWN) ||
-        (currentDirection == SNAKE_DIR_DOWN && dir == SNAKE_DIR_UP) ||
-        (currentDirection == SNAKE_DIR_LEFT && dir == SNAKE_DIR_RIGHT) ||
-        (currentDirection == SNAKE_DIR_RIGHT && dir == SNAKE_DIR_LEFT))
-    {
-        return;
-    }
-
-    nextDirection = dir;
+    return (up ? 1u << SNAKE_DIR_UP : 0) | (down ? 1u << SNAKE_DIR_DOWN : 0) |
+           (left ? 1u << SNAKE_DIR_LEFT : 0) | (right ? 1u << SNAKE_DIR_RIGHT : 0);
 }
+} // namespace
 
-void SnakeGame::setDifficulty(Difficulty diff)
-{
-    difficulty = diff;
-}
+// =====================================================
+// SnakeInterface Implementation (C interface for main.c)
+// =====================================================
 
-void SnakeGame::cycleDifficulty()
+extern "C"
 {
-    switch (difficulty)
+    void Snake_UpdateButtonStates(int up, int down, int left, int right)
     {
-    case EASY:
-        difficulty = NORMAL;
-        break;
-    case NORMAL:
-        difficulty = HARD;
-        break;
-    case HARD:
-        difficulty = INSANE;
-        break;
-    case INSANE:
-        difficulty = NIGHTMARE;
-        break;
-    case NIGHTMARE:
-        difficulty = EASY;
-        break;
+        Model::updateButtonStates(up != 0, down != 0, left != 0, right != 0);
     }
-}
 
-uint32_t SnakeGame::getTickInterval() const
-{
-    // TouchGFX typically runs at 60 FPS, so tick() is called every ~16.67ms
-    // We need to return the interval in number of ticks
-    // Easy: 1 cell/sec = 1000ms interval = 60 ticks
-    // Normal: 3 cells/sec = 333ms interval = 20 ticks
-    // Hard: 5 cells/sec = 200ms interval = 12 ticks
-    // Insane: 8 cells/sec = 125ms interval = 7.5 ticks
-    // Nightmare: 12 cells/sec = 83ms interval = 5 ticks
-    switch (difficulty)
+    void Snake_InjectButtonPress(int direction)
     {
-    case EASY:
-        return 60; // 1 move per second
-    case NORMAL:
-        return 20; // 3 moves per second
-    case HARD:
-        return 12; // 5 moves per second
-    case INSANE:
-        return 7; // 8 moves per second
-    case NIGHTMARE:
-        return 5; // 12 moves per second
-    default:
-        return 20;
+        Model::injectButtonPress((SnakeDirection)direction);
     }
-}
 
-void SnakeGame::moveSnake()
-{
-    // Store previous position of each segment
-    Position prevPos = snake[0];
-    Position currentPos;
-
-    // Move head based on direction
-    switch (currentDirection)
+    void Snake_ButtonPressed(int direction, uint32_t timeMs)
     {
-    case SNAKE_DIR_UP:
-        snake[0].y--;
-        break;
-    case SNAKE_DIR_DOWN:
-        snake[0].y++;
-        break;
-    case SNAKE_DIR_LEFT:
-        snake[0].x--;
-        break;
-    case SNAKE_DIR_RIGHT:
-        snake[0].x++;
-        break;
+        Model::pressButton((SnakeDirection)direction, timeMs);
     }
 
-    // Wrap around when hitting walls (teleport to opposite side)
-    if (snake[0].x < 0)
-        snake[0].x = GRID_WIDTH - 1;
-    else if (snake[0].x >= GRID_WIDTH)
-        snake[0].x = 0;
-
-    if (snake[0].y < 0)
-        snake[0].y = GRID_HEIGHT - 1;
-    else if (snake[0].y >= GRID_HEIGHT)
-        snake[0].y = 0;
-
-    // Move body segments to follow
-    for (uint8_t i = 1; i < snakeLength; i++)
+    void Snake_SetButtonLevels(int up, int down, int left, int right)
     {
-        currentPos = snake[i];
-        snake[i] = prevPos;
-        prevPos = currentPos;
+        Model::setButtonLevels(up != 0, down != 0, left != 0, right != 0);
     }
 }
 
-void SnakeGame::growSnake()
-{
-    if (snakeLength < MAX_SNAKE_LENGTH)
-    {
-        // Add new segment at the end (will be placed correctly on next move)
-        snake[snakeLength] = snake[snakeLength - 1];
-        snakeLength++;
-    }
-}
+// =====================================================
+// Model Implementation
+// =====================================================
 
-void SnakeGame::spawnFood()
+Model::Model()
+    : modelListener(0), buttonUp(false), buttonDown(false), buttonLeft(false), buttonRight(false), prevButtonUp(false), prevButtonDown(false), prevButtonLeft(false), prevButtonRight(false), highScore(0), lastScore(0), benchmarkRunning(false), benchmarkSeconds(0), benchmarkSavedDifficulty(EASY)
 {
-    Position newPos;
-
-    // Simple linear congruential generator for randomness
-    do
-    {
-        randomState = randomState * 1103515245 + 12345;
-        newPos.x = (randomState >> 16) % GRID_WIDTH;
+    resetLoadReport();
 
-        randomState = randomState * 1103515245 + 12345;
-        newPos.y = (randomState >> 16) % GRID_HEIGHT;
-    } while (isPositionOnSnake(newPos) || isPositionOnBigFood(newPos));
-
-    food = newPos;
+    // Load high score from Flash storage at startup
+    loadHighScoreFromFlash();
 }
 
-void SnakeGame::spawnBigFood()
+void Model::tick()
 {
-    Position newPos;
+    // Levels before presses: every press behind a level seen here is already in the ring
+    uint32_t levels = buttonLevels.load(std::memory_order_acquire);
+
+    buttonUp = (levels & (1u << SNAKE_DIR_UP)) != 0;
+    buttonDown = (levels & (1u << SNAKE_DIR_DOWN)) != 0;
+    buttonLeft = (levels & (1u << SNAKE_DIR_LEFT)) != 0;
+    buttonRight = (levels & (1u << SNAKE_DIR_RIGHT)) != 0;
+
+    // Chords fire once, when the second button goes down
+    bool leftRightChord = buttonLeft && buttonRight && !(prevButtonLeft && prevButtonRight);
+    bool upDownChord = buttonUp && buttonDown && !(prevButtonUp && prevButtonDown);
+
+    // Notify listener about button presses, in the order they arrived. Presses
+    // of a chord completed in this tick are the chord, not turns
+    ButtonPress press;
+    while (popPress(press))
+    {
+        bool horizontal = press.direction == SNAKE_DIR_LEFT || press.direction == SNAKE_DIR_RIGHT;
+        if ((leftRightChord && horizontal) || (upDownChord && !horizontal))
+        {
+            continue;
+        }
+        if (modelListener)
+        {
+            modelListener->buttonPressed((SnakeDirection)press.direction, press.timeMs);
+        }
+    }
 
-    // BigFood is 2x2 cells (20x20 pixels)
-    // Make sure it fits within the grid
-    do
+    if (modelListener)
     {
-        randomState = randomState * 1103515245 + 12345;
-        newPos.x = (randomState >> 16) % (GRID_WIDTH - 1); // -1 because 2 cells wide
+        // LEFT + RIGHT chord
+        if (leftRightChord)
+        {
+            modelListener->buttonChordPressed();
+        }
 
-        randomState = randomState * 1103515245 + 12345;
-        newPos.y = (randomState >> 16) % (GRID_HEIGHT - 1); // -1 because 2 cells tall
-    } while (isPositionOnSnake(newPos) ||
-             (newPos.x == food.x && newPos.y == food.y));
+        // UP + DOWN chord
+        if (upDownChord)
+        {
+            modelListener->buttonUpDownChordPressed();
+        }
+    }
 
-    bigFood = newPos;
-    bigFoodActive = true;
-    bigFoodStartTime = Snake_GetTickMs(); // Record start time in ms
+    // Update previous states for the chords
+    prevButtonUp = buttonUp;
+    prevButtonDown = buttonDown;
+    prevButtonLeft = buttonLeft;
+    prevButtonRight = buttonRight;
 }
 
-void SnakeGame::updateBigFood()
+void Model::updateButtonStates(bool up, bool down, bool left, bool right)
 {
-    if (bigFoodActive)
+    uint32_t levels = packLevels(up, down, left, right);
+
+    // Rising levels are presses as of now, in SnakeDirection order when simultaneous
+    uint32_t rising = levels & ~buttonLevels.load(std::memory_order_relaxed);
+    uint32_t now = Snake_GetTickMs();
+    for (int dir = SNAKE_DIR_UP; dir <= SNAKE_DIR_RIGHT; dir++)
     {
-        uint32_t elapsedMs = Snake_GetTickMs() - bigFoodStartTime;
-        if (elapsedMs >= BIGFOOD_DURATION_MS)
+        if (rising & (1u << dir))
         {
-            // BigFood expired after 5000ms
-            bigFoodActive = false;
-            bigFoodStartTime = 0;
+            pushPress((SnakeDirection)dir, now);
         }
     }
+    buttonLevels.store(levels, std::memory_order_release);
 }
 
-uint32_t SnakeGame::getBigFoodTimeLeftMs() const
+void Model::setButtonLevels(bool up, bool down, bool left, bool right)
 {
-    if (!bigFoodActive)
-        return 0;
-    uint32_t elapsedMs = Snake_GetTickMs() - bigFoodStartTime;
-    if (elapsedMs >= BIGFOOD_DURATION_MS)
-        return 0;
-    return BIGFOOD_DURATION_MS - elapsedMs;
+    buttonLevels.store(packLevels(up, down, left, right), std::memory_order_release);
 }
 
-uint32_t SnakeGame::getBigFoodElapsedMs() const
+void Model::pressButton(SnakeDirection dir, uint32_t timeMs)
 {
-    if (!bigFoodActive)
-        return BIGFOOD_DURATION_MS;
-    return Snake_GetTickMs() - bigFoodStartTime;
+    if (dir < SNAKE_DIR_UP || dir > SNAKE_DIR_RIGHT)
+    {
+        return;
+    }
+    pushPress(dir, timeMs);
 }
 
-bool SnakeGame::isPositionOnBigFood(Position pos)
+void Model::injectButtonPress(SnakeDirection dir)
 {
-    if (!bigFoodActive)
-        return false;
-
-    // BigFood occupies 2x2 cells
-    return (pos.x >= bigFood.x && pos.x < bigFood.x + 2 &&
-            pos.y >= bigFood.y && pos.y < bigFood.y + 2);
+    pressButton(dir, Snake_GetTickMs());
 }
 
-bool SnakeGame::checkCollision()
+uint32_t Model::getDroppedPresses()
 {
-    // Wall collision is now handled by wrap-around in moveSnake()
-    // Only check self collision (head with body)
-    for (uint8_t i = 1; i < snakeLength; i++)
-    {
-        if (snake[0] == snake[i])
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return pressOverflows.load(std::memory_order_relaxed);
 }
 
-bool SnakeGame::isPositionOnSnake(Position pos)
+void Model::saveGameScore(uint16_t score)
 {
-    for (uint8_t i = 0; i < snakeLength; i++)
+    lastScore = score;
+    if (score > highScore)
     {
-        if (snake[i] == pos)
-        {
-            return true;
-        }
+        highScore = score;
+        // Save new high score to Flash storage (persists across resets)
+        Snake_SaveHighScore(score);
     }
-    return false;
 }
 
-SnakeDirection SnakeGame::getSegmentDirection(uint8_t index) const
+void Model::loadHighScoreFromFlash()
 {
-    if (index >= snakeLength - 1)
-    {
-        // For the last segment (tail), use direction from previous segment
-        if (snakeLength >= 2)
-        {
-            int16_t dx = snake[snakeLength - 2].x - snake[snakeLength - 1].x;
-            int16_t dy = snake[snakeLength - 2].y - snake[snakeLength - 1].y;
-
-            if (dx > 0)
-                return SNAKE_DIR_RIGHT;
-            if (dx < 0)
-                return SNAKE_DIR_LEFT;
-            if (dy > 0)
-                return SNAKE_DIR_DOWN;
-            if (dy < 0)
-                return SNAKE_DIR_UP;
-        }
-        return currentDirection;
-    }
-
-    // Direction is determined by next segment position
-    int16_t dx = snake[index].x - snake[index + 1].x;
-    int16_t dy = snake[index].y - snake[index + 1].y;
-
-    if (dx > 0)
-        return SNAKE_DIR_RIGHT;
-    if (dx < 0)
-        return SNAKE_DIR_LEFT;
-    if (dy > 0)
-        return SNAKE_DIR_DOWN;
-    if (dy < 0)
-        return SNAKE_DIR_UP;
-
-    return currentDirection;
+    // Load high score from Flash storage
+    highScore = Snake_LoadHighScore();
 }
 
-uint32_t SnakeGame::getRandomSeed()
+void Model::recordLoadSample(Difficulty difficulty, uint16_t cpuLoadPermille, uint32_t frames, uint32_t ticks, uint32_t elapsedMs)
 {
-    // In a real embedded system, you might use a timer or other hardware RNG
-    // For now, just increment the state
-    randomState++;
-    return randomState;
+    LoadReport &report = loadReport[difficulty];
+    report.busyMs += (uint32_t)cpuLoadPermille * elapsedMs / 1000;
+    report.elapsedMs += elapsedMs;
+    report.frames += frames;
+    report.ticks += ticks;
 }
 
-// =====================================================
-// SnakeInterface Implementation (C interface for main.c)
-// =====================================================
-
-extern "C"
+void Model::resetLoadReport()
 {
-    void Snake_UpdateButtonStates(int up, int down, int left, int right)
+    for (int i = 0; i <= NIGHTMARE; i++)
     {
-        // Get the model instance from FrontendHeap and update button states
-        FrontendHeap &heap = FrontendHeap::getInstance();
-        heap.model.updateButtonStates(
-            up != 0,
-            down != 0,
-            left != 0,
-            right != 0);
+        loadReport[i].busyMs = 0;
+        loadReport[i].elapsedMs = 0;
+        loadReport[i].frames = 0;
+        loadReport[i].ticks = 0;
     }
 }
 
-// =====================================================
-// Model Implementation
-// =====================================================
-
-Model::Model()
-    : modelListener(0), buttonUp(false), buttonDown(false), buttonLeft(false), buttonRight(false), prevButtonUp(false), prevButtonDown(false), prevButtonLeft(false), prevButtonRight(false), highScore(0), lastScore(0)
+uint16_t Model::getAverageCpuLoad(Difficulty difficulty) const
 {
-    // Load high score from Flash storage at startup
-    loadHighScoreFromFlash();
+    const LoadReport &report = loadReport[difficulty];
+    if (report.elapsedMs == 0)
+        return 0;
+    return (uint16_t)((uint64_t)report.busyMs * 1000 / report.elapsedMs);
 }
 
-void Model::tick()
+uint16_t Model::getAverageFps(Difficulty difficulty) const
 {
-    // Notify listener about button state changes (edge detection)
-    if (modelListener)
-    {
-        // Check for new button presses (rising edge: was not pressed, now pressed)
-        if (buttonUp && !prevButtonUp)
-        {
-            modelListener->buttonPressed(SNAKE_DIR_UP);
-        }
-        if (buttonDown && !prevButtonDown)
-        {
-            modelListener->buttonPressed(SNAKE_DIR_DOWN);
-        }
-        if (buttonLeft && !prevButtonLeft)
-        {
-            modelListener->buttonPressed(SNAKE_DIR_LEFT);
-        }
-        if (buttonRight && !prevButtonRight)
-        {
-            modelListener->buttonPressed(SNAKE_DIR_RIGHT);
-        }
-    }
+    const LoadReport &report = loadReport[difficulty];
+    if (report.elapsedMs == 0)
+        return 0;
+    return (uint16_t)((uint64_t)report.frames * 1000 / report.elapsedMs);
+}
 
-    // Update previous states
-    prevButtonUp = buttonUp;
-    prevButtonDown = buttonDown;
-    prevButtonLeft = buttonLeft;
-    prevButtonRight = buttonRight;
+uint16_t Model::getAverageTickRate(Difficulty difficulty) const
+{
+    const LoadReport &report = loadReport[difficulty];
+    if (report.elapsedMs == 0)
+        return 0;
+    return (uint16_t)((uint64_t)report.ticks * 1000 / report.elapsedMs);
 }
 
-void Model::updateButtonStates(bool up, bool down, bool left, bool right)
+void Model::startBenchmark()
 {
-    buttonUp = up;
-    buttonDown = down;
-    buttonLeft = left;
-    buttonRight = right;
+    // The report then only contains benchmark samples
+    resetLoadReport();
+    benchmarkSavedDifficulty = snakeGame.getDifficulty();
+    snakeGame.setDifficulty(EASY);
+    benchmarkSeconds = 0;
+    benchmarkRunning = true;
 }
 
-void Model::saveGameScore(uint16_t score)
+bool Model::advanceBenchmark()
 {
-    lastScore = score;
-    if (score > highScore)
+    if (!benchmarkRunning)
+        return false;
+
+    if (++benchmarkSeconds < BENCHMARK_SECONDS_PER_LEVEL)
+        return true;
+
+    benchmarkSeconds = 0;
+    if (snakeGame.getDifficulty() == NIGHTMARE)
     {
-        highScore = score;
-        // Save new high score to Flash storage (persists across resets)
-        Snake_SaveHighScore(score);
+        // Done: give the player back the difficulty chosen in the menu
+        benchmarkRunning = false;
+        snakeGame.setDifficulty(benchmarkSavedDifficulty);
+        return false;
     }
-}
 
-void Model::loadHighScoreFromFlash()
-{
-    // Load high score from Flash storage
-    highScore = Snake_LoadHighScore();
+    snakeGame.cycleDifficulty();
+    return true;
 }
@@ -24,8 +24,35 @@ void Screen2Presenter::saveScore(uint16_t score)
     model->saveGameScore(score);
 }
 
-void Screen2Presenter::buttonPressed(SnakeDirection dir)
+void Screen2Presenter::recordLoadSample(uint16_t cpuLoadPermille, uint32_t frames, uint32_t ticks, uint32_t elapsedMs)
+{
+    model->recordLoadSample(model->getSnakeGame().getDifficulty(), cpuLoadPermille, frames, ticks, elapsedMs);
+}
+
+bool Screen2Presenter::isBenchmarkRunning() const
+{
+    return model->isBenchmarkRunning();
+}
+
+bool Screen2Presenter::advanceBenchmark()
+{
+    return model->advanceBenchmark();
+}
+
+void Screen2Presenter::buttonPressed(SnakeDirection dir, uint32_t timeMs)
 {
     // Forward button press to view
-    view.onButtonPressed(dir);
+    view.onButtonPressed(dir, timeMs);
+}
+
+void Screen2Presenter::buttonChordPressed()
+{
+    view.withdrawChordTurn(SNAKE_DIR_LEFT, SNAKE_DIR_RIGHT);
+    view.toggleStatsOverlay();
+}
+
+void Screen2Presenter::buttonUpDownChordPressed()
+{
+    view.withdrawChordTurn(SNAKE_DIR_UP, SNAKE_DIR_DOWN);
+    view.toggleLatencyTest();
 }
@@ -1,10 +1,58 @@
 #include <gui/screen2_screen/Screen2View.hpp>
 #include <images/BitmapDatabase.hpp>
+#include <gui/common/SnakeSprites.hpp>
 #include <touchgfx/Color.hpp>
+#include <texts/TextKeysAndLanguages.hpp>
+
+#ifndef SIMULATOR
+#include <HudLayer.hpp>
+#include <FrameStats.hpp>
+#include <BitmapPreloader.hpp>
+#include "perf_counter.h"
+#include "button_input.h"
+#include "latency_probe.h"
+#endif
+
+namespace
+{
+#ifndef SIMULATOR
+inline uint16_t toRGB565(uint8_t red, uint8_t green, uint8_t blue)
+{
+    return ((red & 0xF8) << 8) | ((green & 0xFC) << 3) | (blue >> 3);
+}
+#endif
+
+// Food bitmap to draw: its SDRAM copy once the boot-time preload has finished
+touchgfx::Bitmap foodBitmap(touchgfx::BitmapId id)
+{
+#ifndef SIMULATOR
+    return touchgfx::Bitmap(BitmapPreloader::getInstance().resolveBitmap(id));
+#else
+    return touchgfx::Bitmap(id);
+#endif
+}
+} // namespace
+
+#if SCORE_BENCHMARK && !defined(SIMULATOR)
+// Average SYSCLK cycles per score update, read with the debugger
+struct ScoreBenchmark
+{
+    uint32_t textAreaCycles;
+    uint32_t glyphCycles;
+} scoreBenchmark;
+#endif
 
 Screen2View::Screen2View()
-    : game(0), tickCounter(0), currentSegmentCount(0), gameStarted(false), gameOverDelay(0)
+    : game(0), tickCounter(0), loadSampleTicks(0), shownScore(0), statsRefreshTicks(0), latencyTest(false), latencyPressTick(0), gameStarted(false), gameOverDelay(0)
 {
+    hudBitmaps[0] = touchgfx::BITMAP_INVALID;
+    hudBitmaps[1] = touchgfx::BITMAP_INVALID;
+
+    for (int i = 0; i < STATS_LINE_COUNT; i++)
+    {
+        statsBuffers[i][0] = 0;
+    }
+
     // Initialize score buffer
     scoreBuffer[0] = '0';
     scoreBuffer[1] = 0;
@@ -20,22 +68,21 @@ void Screen2View::setupScreen()
     // Reset game when entering screen
     game->reset();
 
-    // Setup snake container
-    snakeContainer.setPosition(0, 0, GAME_AREA_WIDTH, GAME_AREA_HEIGHT);
-    add(snakeContainer);
+    // Setup snake board (covers the game area). It clears empty cells to the box1 colour
+    // itself, so TouchGFX never redraws box1 when the tail leaves a cell
+    snakeBoard.clearAll();
+    snakeBoard.setBackground(box1.getColor());
+    add(snakeBoard);
 
-    // Hide the default images placed in designer (we'll manage them dynamically)
-    image1.setVisible(false);
-    image2.setVisible(false);
-    image3.setVisible(false);
-    image4.setVisible(false);
+    // The opaque board hides what is below it: food and the separator line go on top
+    // (food never shares a cell with the snake)
+    remove(image4);
+    add(image4);
+    remove(line1);
+    add(line1);
 
-    // Initialize snake segment images
-    for (int i = 0; i < MAX_DISPLAY_SEGMENTS; i++)
-    {
-        snakeSegments[i].setVisible(false);
-        snakeContainer.add(snakeSegments[i]);
-    }
+    // Hide the food image placed in designer (we'll manage it dynamically)
+    image4.setVisible(false);
 
     // Initialize BigFood image
     bigFoodImage.setVisible(false);
@@ -48,21 +95,131 @@ void Screen2View::setupScreen()
     touchgfx::Unicode::snprintf(scoreBuffer, 10, "%d", 0);
     textArea1.setWildcard(scoreBuffer);
 
-    // Initial display update
-    updateSnakeDisplay();
-    updateFoodDisplay();
-    updateBigFoodDisplay();
+    setupHud();
+    benchmarkScore();
+
+    // Initial display update (the board is empty and image4 and bigFoodImage are hidden)
+    shownScore = 0xFFFF;
+    screen.reset();
+    updateBoardDisplay();
     updateScoreDisplay();
 
     tickCounter = 0;
     gameStarted = true;
     gameOverDelay = 0;
+
+    // Start a new load measurement interval (discards the time spent on other screens)
+    uint16_t load;
+    uint32_t frames, elapsedMs;
+    Snake_GetLoadStats(&load, &frames, &elapsedMs);
+    loadSampleTicks = 0;
 }
 
 void Screen2View::tearDownScreen()
 {
     Screen2ViewBase::tearDownScreen();
     gameStarted = false;
+
+#ifndef SIMULATOR
+    // Other screens use the full layer 1 framebuffer
+    HudLayer::getInstance().hide();
+    for (int i = 0; i < 2; i++)
+    {
+        if (hudBitmaps[i] != touchgfx::BITMAP_INVALID)
+        {
+            touchgfx::Bitmap::dynamicBitmapDelete(hudBitmaps[i]);
+            hudBitmaps[i] = touchgfx::BITMAP_INVALID;
+        }
+    }
+#endif
+}
+
+void Screen2View::setupHud()
+{
+    hud.setPosition(0, HUD_Y, HUD_WIDTH, HUD_HEIGHT);
+    hudBackground.setPosition(0, 0, HUD_WIDTH, HUD_HEIGHT);
+    hudBackground.setColor(touchgfx::Color::getColorFromRGB(0, 0, 0));
+    hud.add(hudBackground);
+
+    // Score text moves from the screen into the HUD (coordinates become HUD-relative)
+    remove(textArea1);
+    textArea1.setXY(textArea1.getX(), textArea1.getY() - HUD_Y);
+    hud.add(textArea1);
+
+    // Score digits are rendered once and then blitted; the text area stays as fallback
+    const DigitGlyphs *glyphs = DigitGlyphs::get(textArea1, touchgfx::Color::getColorFromRGB(0, 0, 0));
+    if (glyphs)
+    {
+        scoreDigits.setGlyphs(glyphs, touchgfx::Color::getColorFromRGB(0, 0, 0));
+        scoreDigits.setPosition(textArea1.getX(), textArea1.getY(), textArea1.getWidth(), textArea1.getHeight());
+        textArea1.setVisible(false);
+        hud.add(scoreDigits);
+    }
+
+    bigFoodTimer.setPosition(BIGFOOD_BAR_X, BIGFOOD_BAR_Y, BIGFOOD_BAR_WIDTH, BIGFOOD_BAR_HEIGHT);
+    bigFoodTimer.setFilledWidth(0);
+    bigFoodTimer.setColors(touchgfx::Color::getColorFromRGB(BIGFOOD_BAR_RED, BIGFOOD_BAR_GREEN, BIGFOOD_BAR_BLUE),
+                           touchgfx::Color::getColorFromRGB(0, 0, 0));
+    hud.add(bigFoodTimer);
+
+    // Frame time overlay, hidden until toggled
+    statsOverlay.setPosition(0, 0, HUD_WIDTH, HUD_HEIGHT);
+    for (int i = 0; i < STATS_LINE_COUNT; i++)
+    {
+        statsLines[i].setPosition(4, i * STATS_LINE_HEIGHT, HUD_WIDTH - 8, STATS_LINE_HEIGHT);
+        statsLines[i].setColor(touchgfx::Color::getColorFromRGB(0, 255, 0));
+        statsLines[i].setTypedText(touchgfx::TypedText(T_STATSLINE));
+        statsLines[i].setWildcard(statsBuffers[i]);
+        statsOverlay.add(statsLines[i]);
+    }
+    statsOverlay.setVisible(false);
+    hud.add(statsOverlay);
+
+#ifndef SIMULATOR
+    if (HudLayer::isAvailable())
+    {
+        hudBitmaps[0] = touchgfx::Bitmap::dynamicBitmapCreate(HUD_WIDTH, HUD_HEIGHT, touchgfx::Bitmap::RGB565);
+        hudBitmaps[1] = touchgfx::Bitmap::dynamicBitmapCreate(HUD_WIDTH, HUD_HEIGHT, touchgfx::Bitmap::RGB565);
+    }
+
+    if (hudBitmaps[0] != touchgfx::BITMAP_INVALID && hudBitmaps[1] != touchgfx::BITMAP_INVALID)
+    {
+        // Later updates are patched into the back buffer only, so both start out complete
+        hud.drawToDynamicBitmap(hudBitmaps[0]);
+        hud.drawToDynamicBitmap(hudBitmaps[1]);
+        HudLayer::getInstance().show(reinterpret_cast<uint16_t *>(touchgfx::Bitmap::dynamicBitmapGetAddress(hudBitmaps[0])),
+                                     reinterpret_cast<uint16_t *>(touchgfx::Bitmap::dynamicBitmapGetAddress(hudBitmaps[1])));
+        return;
+    }
+#endif
+
+    // No layer available: draw the HUD in the framebuffer like the rest of the screen
+    add(hud);
+}
+
+bool Screen2View::hudOnLayer() const
+{
+#ifndef SIMULATOR
+    return HudLayer::getInstance().isVisible();
+#else
+    return false;
+#endif
+}
+
+void Screen2View::renderHud()
+{
+#ifndef SIMULATOR
+    HudLayer &layer = HudLayer::getInstance();
+    if (!layer.isVisible())
+    {
+        return;
+    }
+
+    // The layer copies the new strip into the other buffer once that is no longer scanned
+    hud.drawToDynamicBitmap(hudBitmaps[layer.getBackBuffer()]);
+    layer.invalidate();
+    layer.present();
+#endif
 }
 
 void Screen2View::handleTickEvent()
@@ -72,9 +229,51 @@ void Screen2View::handleTickEvent()
         return;
     }
 
+#ifndef SIMULATOR
+    FrameStats::getInstance().logicStart();
+    stepGame();
+    FrameStats::getInstance().logicEnd();
+
+    // Show the score and bar patches of this tick together
+    HudLayer::getInstance().present();
+#else
+    stepGame();
+#endif
+
+    if (statsOverlay.isVisible() && ++statsRefreshTicks >= STATS_REFRESH_TICKS)
+    {
+        statsRefreshTicks = 0;
+        updateStatsOverlay();
+    }
+}
+
+void Screen2View::stepGame()
+{
     // Handle sound events
     handleSoundEvent();
 
+    if (++loadSampleTicks >= LOAD_SAMPLE_TICKS)
+    {
+        loadSampleTicks = 0;
+        sampleLoad();
+
+        if (presenter->isBenchmarkRunning() && !presenter->advanceBenchmark())
+        {
+            application().gotoBenchmarkScreenNoTransition();
+            return;
+        }
+    }
+
+    // Benchmark and latency test keep playing: restart immediately instead of showing the game over screen
+    if (game->isGameOver() && (presenter->isBenchmarkRunning() || latencyTest))
+    {
+        game->reset();
+        updateBoardDisplay();
+        updateScoreDisplay();
+        tickCounter = 0;
+        return;
+    }
+
     // Handle game over state - delay before transitioning
     if (game->isGameOver())
     {
@@ -92,32 +291,73 @@ void Screen2View::handleTickEvent()
 
     tickCounter++;
 
-    // Update BigFood display every tick (for timer countdown visual)
-    updateBigFoodDisplay();
+    // Countdown runs in real time, not in game steps
+    updateBigFoodTimer();
+
+#ifndef SIMULATOR
+    // Steer like the benchmark, but through the input path so the turn is measured
+    if (latencyTest && tickCounter == latencyPressTick)
+    {
+        SnakeDirection dir = game->getAutopilotDirection();
+        if (dir != game->getCurrentDirection())
+        {
+            LatencyProbe_Inject((uint8_t)dir);
+        }
+    }
+#endif
 
     // Check if it's time to update game based on difficulty
     if (tickCounter >= game->getTickInterval())
     {
         tickCounter = 0;
 
+        if (presenter->isBenchmarkRunning())
+        {
+            game->setDirection(game->getAutopilotDirection());
+        }
+
         // Update game logic
         bool continueGame = game->update();
 
+#ifndef SIMULATOR
+        if (game->didTurnLastStep())
+        {
+            LatencyProbe_Applied((uint16_t)gridToPixelY(game->getSnakeHead().y), (uint8_t)game->getCurrentDirection());
+        }
+
+        // Next press somewhere within the coming step (1 .. interval)
+        latencyPressTick = 1 + PerfCounter_GetCycles() % game->getTickInterval();
+#endif
+
         if (continueGame)
         {
-            // Update display
-            updateSnakeDisplay();
-            updateFoodDisplay();
-            updateBigFoodDisplay();
+            // Update display; each call only invalidates what actually changed
+            updateBoardDisplay();
             updateScoreDisplay();
         }
         // If game over, the next tick will handle the transition
     }
 }
 
+void Screen2View::sampleLoad()
+{
+    uint16_t load;
+    uint32_t frames, elapsedMs;
+
+    Snake_GetLoadStats(&load, &frames, &elapsedMs);
+    presenter->recordLoadSample(load, frames, LOAD_SAMPLE_TICKS, elapsedMs);
+}
+
 void Screen2View::handleSoundEvent()
 {
     SoundEvent event = game->getSoundEvent();
+
+    // The game over music blocks the GUI task, which would spoil the measurement
+    if (presenter->isBenchmarkRunning())
+    {
+        return;
+    }
+
     switch (event)
     {
     case SOUND_EAT_FOOD:
@@ -135,263 +375,250 @@ void Screen2View::handleSoundEvent()
     }
 }
 
-void Screen2View::onButtonPressed(SnakeDirection dir)
+void Screen2View::toggleStatsOverlay()
 {
-    if (game && !game->isGameOver())
-    {
-        game->setDirection(dir);
-    }
-}
+    bool show = !statsOverlay.isVisible();
 
-bool Screen2View::isTurnSegment(uint8_t index, SnakeDirection &fromDir, SnakeDirection &toDir)
-{
-    if (index == 0 || index >= game->getSnakeLength() - 1)
-    {
-        return false; // Head and tail are not turn segments
-    }
-
-    // Get positions of previous (towards head), current, and next (towards tail) segments
-    Position prev = game->getSnakeSegment(index - 1); // towards head
-    Position curr = game->getSnakeSegment(index);
-    Position next = game->getSnakeSegment(index + 1); // towards tail
-
-    // Calculate direction from current to prev (towards head)
-    int16_t dx1 = prev.x - curr.x;
-    int16_t dy1 = prev.y - curr.y;
-
-    // Handle wrap-around
-    if (dx1 > 1)
-        dx1 = -1;
-    if (dx1 < -1)
-        dx1 = 1;
-    if (dy1 > 1)
-        dy1 = -1;
-    if (dy1 < -1)
-        dy1 = 1;
-
-    // Calculate direction from next to current (from tail towards this segment)
-    int16_t dx2 = curr.x - next.x;
-    int16_t dy2 = curr.y - next.y;
-
-    // Handle wrap-around
-    if (dx2 > 1)
-        dx2 = -1;
-    if (dx2 < -1)
-        dx2 = 1;
-    if (dy2 > 1)
-        dy2 = -1;
-    if (dy2 < -1)
-        dy2 = 1;
-
-    // toDir = direction this segment is "exiting" (towards head)
-    if (dx1 > 0)
-        toDir = SNAKE_DIR_RIGHT;
-    else if (dx1 < 0)
-        toDir = SNAKE_DIR_LEFT;
-    else if (dy1 > 0)
-        toDir = SNAKE_DIR_DOWN;
-    else if (dy1 < 0)
-        toDir = SNAKE_DIR_UP;
-    else
-        return false;
-
-    // fromDir = direction this segment is "entering" (from tail)
-    if (dx2 > 0)
-        fromDir = SNAKE_DIR_RIGHT;
-    else if (dx2 < 0)
-        fromDir = SNAKE_DIR_LEFT;
-    else if (dy2 > 0)
-        fromDir = SNAKE_DIR_DOWN;
-    else if (dy2 < 0)
-        fromDir = SNAKE_DIR_UP;
+    // The overlay takes the place of the score and the countdown bar
+    statsOverlay.setVisible(show);
+    bigFoodTimer.setVisible(!show);
+    if (scoreDigits.hasGlyphs())
+        scoreDigits.setVisible(!show);
     else
-        return false;
+        textArea1.setVisible(!show);
 
-    // It's a turn if directions are perpendicular
-    bool fromHorizontal = (fromDir == SNAKE_DIR_LEFT || fromDir == SNAKE_DIR_RIGHT);
-    bool toHorizontal = (toDir == SNAKE_DIR_LEFT || toDir == SNAKE_DIR_RIGHT);
+    if (show)
+    {
+        statsRefreshTicks = 0;
+        updateStatsOverlay();
+    }
 
-    return fromHorizontal != toHorizontal;
+    // Score and bar changes were not patched into the layer while the overlay was shown
+    if (hudOnLayer())
+        renderHud();
+    else
+        hud.invalidate();
 }
 
-uint16_t Screen2View::getHeadBitmapId(SnakeDirection dir)
+void Screen2View::toggleLatencyTest()
 {
-    // HEAD = up (original), HEAD1 = 90° CCW = left, HEAD2 = 180° = down, HEAD3 = 270° CCW = right
-    switch (dir)
-    {
-    case SNAKE_DIR_UP:
-        return BITMAP_HEAD_ID;
-    case SNAKE_DIR_LEFT:
-        return BITMAP_HEAD1_ID;
-    case SNAKE_DIR_DOWN:
-        return BITMAP_HEAD2_ID;
-    case SNAKE_DIR_RIGHT:
-        return BITMAP_HEAD3_ID;
-    default:
-        return BITMAP_HEAD_ID;
+#ifndef SIMULATOR
+    if (presenter->isBenchmarkRunning())
+    {
+        return;
     }
-}
 
-uint16_t Screen2View::getTailBitmapId(SnakeDirection dir)
-{
-    // TAIL = up (original), TAIL1 = 90° CCW = left, TAIL2 = 180° = down, TAIL3 = 270° CCW = right
-    switch (dir)
-    {
-    case SNAKE_DIR_UP:
-        return BITMAP_TAIL_ID;
-    case SNAKE_DIR_LEFT:
-        return BITMAP_TAIL1_ID;
-    case SNAKE_DIR_DOWN:
-        return BITMAP_TAIL2_ID;
-    case SNAKE_DIR_RIGHT:
-        return BITMAP_TAIL3_ID;
-    default:
-        return BITMAP_TAIL_ID;
+    latencyTest = !latencyTest;
+    if (latencyTest)
+    {
+        LatencyProbe_Reset();
     }
-}
 
-uint16_t Screen2View::getMidBitmapId(SnakeDirection dir)
-{
-    // MID = vertical (original), MID1 = horizontal (90° CCW)
-    if (dir == SNAKE_DIR_LEFT || dir == SNAKE_DIR_RIGHT)
+    // The results are shown in the overlay
+    if (latencyTest != statsOverlay.isVisible())
     {
-        return BITMAP_MID1_ID;
+        toggleStatsOverlay();
     }
-    return BITMAP_MID_ID;
+    else if (latencyTest)
+    {
+        updateStatsOverlay();
+    }
+#endif
 }
 
-uint16_t Screen2View::getTurnBitmapId(SnakeDirection fromDir, SnakeDirection toDir)
+void Screen2View::updateStatsOverlay()
 {
-    // TURN (┌): coming from UP going RIGHT, or coming from LEFT going DOWN
-    // TURN1 (└): coming from DOWN going RIGHT, or coming from LEFT going UP
-    // TURN2 (┘): coming from DOWN going LEFT, or coming from RIGHT going UP
-    // TURN3 (┐): coming from UP going LEFT, or coming from RIGHT going DOWN
-
-    // TURN (┌)
-    if ((fromDir == SNAKE_DIR_UP && toDir == SNAKE_DIR_RIGHT) ||
-        (fromDir == SNAKE_DIR_LEFT && toDir == SNAKE_DIR_DOWN))
+#ifndef SIMULATOR
+    if (latencyTest)
     {
-        return BITMAP_TURN_ID;
+        formatLatencyOverlay();
     }
-    // TURN1 (└)
-    else if ((fromDir == SNAKE_DIR_DOWN && toDir == SNAKE_DIR_RIGHT) ||
-             (fromDir == SNAKE_DIR_LEFT && toDir == SNAKE_DIR_UP))
+    else
     {
-        return BITMAP_TURN1_ID;
+        static const char *const names[STATS_LINE_COUNT] = {"LOGIC", "DRAW", "DMA2D", "VSYNC"};
+        static const FrameStats::Metric metrics[STATS_LINE_COUNT] = {FrameStats::LOGIC, FrameStats::DRAW, FrameStats::DMA2D, FrameStats::VSYNC_WAIT};
+        const FrameStats &stats = FrameStats::getInstance();
+
+        // Microseconds: min avg max p99 over the last frames
+        for (int i = 0; i < STATS_LINE_COUNT; i++)
+        {
+            FrameStats::Summary s = stats.getSummary(metrics[i]);
+            uint16_t length = touchgfx::Unicode::strncpy(statsBuffers[i], names[i], STATS_LINE_LENGTH);
+            touchgfx::Unicode::snprintf(statsBuffers[i] + length, STATS_LINE_LENGTH - length, " %u %u %u P99 %u",
+                                        (unsigned int)s.min, (unsigned int)s.avg, (unsigned int)s.max, (unsigned int)s.p99);
+        }
+
+        // Idle share goes behind the shortest line
+        FrameStats::Summary idle = stats.getSummary(FrameStats::IDLE);
+        uint16_t length = touchgfx::Unicode::strlen(statsBuffers[0]);
+        touchgfx::Unicode::snprintf(statsBuffers[0] + length, STATS_LINE_LENGTH - length, " IDLE %u%%", (unsigned int)(idle.avg / 10));
+
+        // Average press to setDirection() latency behind the vsync wait
+        const ButtonLatencyStats *keys = ButtonInput_GetLatencyStats();
+        if (keys->samples > 0)
+        {
+            length = touchgfx::Unicode::strlen(statsBuffers[3]);
+            touchgfx::Unicode::snprintf(statsBuffers[3] + length, STATS_LINE_LENGTH - length, " KEY %u MS",
+                                        (unsigned int)(keys->totalUs / keys->samples / 1000));
+        }
     }
-    // TURN2 (┘)
-    else if ((fromDir == SNAKE_DIR_DOWN && toDir == SNAKE_DIR_LEFT) ||
-             (fromDir == SNAKE_DIR_RIGHT && toDir == SNAKE_DIR_UP))
+#else
+    touchgfx::Unicode::strncpy(statsBuffers[0], "NO DWT IN SIMULATOR", STATS_LINE_LENGTH);
+#endif
+
+    if (hudOnLayer())
     {
-        return BITMAP_TURN2_ID;
+        renderHud();
+        return;
     }
-    // TURN3 (┐)
-    else if ((fromDir == SNAKE_DIR_UP && toDir == SNAKE_DIR_LEFT) ||
-             (fromDir == SNAKE_DIR_RIGHT && toDir == SNAKE_DIR_DOWN))
+    for (int i = 0; i < STATS_LINE_COUNT; i++)
     {
-        return BITMAP_TURN3_ID;
+        statsLines[i].invalidate();
     }
-
-    return BITMAP_TURN_ID;
 }
 
-void Screen2View::updateSnakeDisplay()
+void Screen2View::formatLatencyOverlay()
 {
-    if (!game)
-        return;
-
-    uint8_t snakeLen = game->getSnakeLength();
+#ifndef SIMULATOR
+    static const char *const names[LATENCY_STAGE_COUNT] = {"INPUT", "RENDER", "SCANOUT"};
+    LatencySummary summary;
+    LatencyProbe_GetSummary(&summary);
 
-    // Hide previously shown segments that are no longer needed
-    for (uint8_t i = snakeLen; i < currentSegmentCount; i++)
+    // Milliseconds with one decimal: average and maximum over the last samples
+    for (int i = 0; i < LATENCY_STAGE_COUNT; i++)
     {
-        snakeSegments[i].setVisible(false);
+        uint16_t length = touchgfx::Unicode::strncpy(statsBuffers[i], names[i], STATS_LINE_LENGTH);
+        touchgfx::Unicode::snprintf(statsBuffers[i] + length, STATS_LINE_LENGTH - length, " %u.%u MAX %u.%u MS",
+                                    (unsigned int)(summary.avgUs[i] / 1000), (unsigned int)(summary.avgUs[i] / 100 % 10),
+                                    (unsigned int)(summary.maxUs[i] / 1000), (unsigned int)(summary.maxUs[i] / 100 % 10));
     }
+    uint16_t length = touchgfx::Unicode::strlen(statsBuffers[0]);
+    touchgfx::Unicode::snprintf(statsBuffers[0] + length, STATS_LINE_LENGTH - length, " N %u", (unsigned int)summary.samples);
 
-    // Update each snake segment
-    for (uint8_t i = 0; i < snakeLen && i < MAX_DISPLAY_SEGMENTS; i++)
+    // Display latency histogram, one digit per bin scaled to the fullest bin
+    uint32_t fullest = 1;
+    for (unsigned int i = 0; i < LATENCY_HISTOGRAM_BINS; i++)
     {
-        Position pos = game->getSnakeSegment(i);
-
-        // Set position
-        int16_t pixelX = gridToPixelX(pos.x);
-        int16_t pixelY = gridToPixelY(pos.y);
-        snakeSegments[i].setXY(pixelX, pixelY);
-
-        // Determine which bitmap to use
-        uint16_t bitmapId;
-
-        if (i == 0)
+        if (summary.histogram[i] > fullest)
         {
-            // Head - use current direction
-            bitmapId = getHeadBitmapId(game->getCurrentDirection());
+            fullest = summary.histogram[i];
         }
-        else if (i == snakeLen - 1)
-        {
-            // Tail - use segment direction
-            SnakeDirection tailDir = game->getSegmentDirection(i);
-            bitmapId = getTailBitmapId(tailDir);
-        }
-        else
+    }
+    touchgfx::Unicode::snprintf(statsBuffers[3], STATS_LINE_LENGTH, "%u MS/BIN ", (unsigned int)LATENCY_BIN_MS);
+    length = touchgfx::Unicode::strlen(statsBuffers[3]);
+    for (unsigned int i = 0; i < LATENCY_HISTOGRAM_BINS && length < STATS_LINE_LENGTH - 1; i++)
+    {
+        statsBuffers[3][length++] = '0' + (touchgfx::Unicode::UnicodeChar)((summary.histogram[i] * 9 + fullest - 1) / fullest);
+    }
+    statsBuffers[3][length] = 0;
+#endif
+}
+
+void Screen2View::onButtonPressed(SnakeDirection dir, uint32_t timeMs)
+{
+    if (game && !game->isGameOver() && !presenter->isBenchmarkRunning())
+    {
+        bool accepted = game->setDirection(dir, timeMs);
+#ifndef SIMULATOR
+        ButtonInput_PressHandled((uint8_t)dir);
+        if (!accepted)
         {
-            // Body segment - check if it's a turn
-            SnakeDirection fromDir, toDir;
-            if (isTurnSegment(i, fromDir, toDir))
-            {
-                bitmapId = getTurnBitmapId(fromDir, toDir);
-            }
-            else
-            {
-                // Straight segment
-                SnakeDirection segDir = game->getSegmentDirection(i);
-                bitmapId = getMidBitmapId(segDir);
-            }
+            LatencyProbe_Rejected((uint8_t)dir);
         }
+#else
+        (void)accepted;
+#endif
+    }
+}
+
+void Screen2View::withdrawChordTurn(SnakeDirection first, SnakeDirection second)
+{
+    // Same conditions under which onButtonPressed() queued it
+    if (!game || game->isGameOver() || presenter->isBenchmarkRunning())
+        return;
 
-        // Apply bitmap
-        snakeSegments[i].setBitmap(touchgfx::Bitmap(bitmapId));
-        snakeSegments[i].setVisible(true);
-        snakeSegments[i].invalidate();
+    SnakeDirection withdrawn = first;
+    if (!game->withdrawDirection(first))
+    {
+        withdrawn = second;
+        if (!game->withdrawDirection(second))
+            return;
     }
+#ifndef SIMULATOR
+    LatencyProbe_Rejected((uint8_t)withdrawn);
+#else
+    (void)withdrawn;
+#endif
+}
 
-    currentSegmentCount = snakeLen;
-    snakeContainer.invalidate();
+uint16_t Screen2View::getCellBitmapId(SnakeCellSprite sprite)
+{
+    // Bitmaps in order of counter-clockwise quarter turns (see SnakeCellShape).
+    // The board sprite IDs are runtime globals (assigned at boot, see SnakeSprites),
+    // so they are read on every call instead of being cached in static tables.
+    switch (sprite.shape)
+    {
+    case CELL_HEAD:
+    {
+        const uint16_t heads[4] = {BITMAP_HEAD_ID, BITMAP_HEAD1_ID, BITMAP_HEAD2_ID, BITMAP_HEAD3_ID};
+        return heads[sprite.rotation & 3];
+    }
+    case CELL_TAIL:
+    {
+        const uint16_t tails[4] = {BITMAP_TAIL_ID, BITMAP_TAIL1_ID, BITMAP_TAIL2_ID, BITMAP_TAIL3_ID};
+        return tails[sprite.rotation & 3];
+    }
+    case CELL_MID:
+        return (sprite.rotation & 1) ? BITMAP_MID1_ID : BITMAP_MID_ID;
+    case CELL_TURN:
+    default:
+    {
+        const uint16_t turns[4] = {BITMAP_TURN_ID, BITMAP_TURN1_ID, BITMAP_TURN2_ID, BITMAP_TURN3_ID};
+        return turns[sprite.rotation & 3];
+    }
+    }
 }
 
-void Screen2View::updateFoodDisplay()
+void Screen2View::updateBoardDisplay()
 {
     if (!game)
         return;
 
-    Position foodPos = game->getFoodPosition();
+    screen.updateBoard(*game, *this);
+}
 
-    // Use image4 for food (from the base class)
-    image4.setXY(gridToPixelX(foodPos.x), gridToPixelY(foodPos.y));
-    image4.setBitmap(touchgfx::Bitmap(BITMAP_FOOD_ID));
+void Screen2View::cellChanged(int16_t x, int16_t y, SnakeScreenCell cell)
+{
+    // Sprite choice is shared with the host renderer (tools/render_replay)
+    uint16_t bitmapId = cell == SNAKE_SCREEN_EMPTY ? touchgfx::BITMAP_INVALID : getCellBitmapId(SnakeScreen_decodeCell(cell));
+    snakeBoard.setCell(x, y, bitmapId);
+}
+
+void Screen2View::foodChanged(bool wasShown, Position from, Position to)
+{
+    // Use image4 for food (from the base class); redraw the old and the new position
+    (void)from;
+    if (wasShown)
+        image4.invalidate();
+    image4.setXY(gridToPixelX(to.x), gridToPixelY(to.y));
+    image4.setBitmap(foodBitmap(BITMAP_FOOD_ID));
     image4.setVisible(true);
     image4.invalidate();
 }
 
-void Screen2View::updateBigFoodDisplay()
+void Screen2View::bigFoodChanged(bool wasShown, Position from, bool shown, Position to)
 {
-    if (!game)
+    // BigFood is 20x20 pixels (2x2 cells); eaten or expired BigFood is erased once
+    (void)from;
+    if (wasShown)
+        bigFoodImage.invalidate();
+    bigFoodImage.setVisible(shown);
+    if (!shown)
         return;
 
-    if (game->isBigFoodActive())
-    {
-        Position bigFoodPos = game->getBigFoodPosition();
-
-        // BigFood is 20x20 pixels (2x2 cells)
-        bigFoodImage.setXY(gridToPixelX(bigFoodPos.x), gridToPixelY(bigFoodPos.y));
-        bigFoodImage.setBitmap(touchgfx::Bitmap(BITMAP_BIGFOOD_ID));
-        bigFoodImage.setVisible(true);
-        bigFoodImage.invalidate();
-    }
-    else
-    {
-        bigFoodImage.setVisible(false);
-        bigFoodImage.invalidate();
-    }
+    bigFoodImage.setXY(gridToPixelX(to.x), gridToPixelY(to.y));
+    bigFoodImage.setBitmap(foodBitmap(BITMAP_BIGFOOD_ID));
+    bigFoodImage.invalidate();
 }
 
 void Screen2View::updateScoreDisplay()
@@ -400,11 +627,106 @@ void Screen2View::updateScoreDisplay()
         return;
 
     uint16_t score = game->getScore();
+    if (score == shownScore)
+        return;
+    shownScore = score;
+
+    if (scoreDigits.hasGlyphs())
+    {
+        // Only the digits that changed are redrawn, no formatting or text layout
+        touchgfx::Rect changed = scoreDigits.setValue(score);
+        if (hudOnLayer())
+            patchHudScore(changed);
+        else
+            scoreDigits.invalidateRect(changed);
+        return;
+    }
 
     // Convert score to unicode string
     touchgfx::Unicode::snprintf(scoreBuffer, 10, "%d", score);
 
     // Update the text area with wildcard
     textArea1.setWildcard(scoreBuffer);
-    textArea1.invalidate();
+    if (hudOnLayer())
+        renderHud();
+    else
+        textArea1.invalidate();
+}
+
+void Screen2View::updateBigFoodTimer()
+{
+    if (!game)
+        return;
+
+    screen.updateBar(*game, *this);
+}
+
+void Screen2View::barChanged(int16_t first, int16_t count)
+{
+    bigFoodTimer.setFilledWidth(screen.getBarFill());
+    if (!hudOnLayer())
+    {
+        bigFoodTimer.invalidateRect(touchgfx::Rect(first, 0, count, BIGFOOD_BAR_HEIGHT));
+        return;
+    }
+
+#ifndef SIMULATOR
+    // On the HUD layer patch the changed columns into the back buffer instead of re-rendering the strip
+    HudLayer &layer = HudLayer::getInstance();
+    if (layer.isVisible() && !statsOverlay.isVisible())
+    {
+        uint16_t color = bigFoodTimer.isColumnFilled(first) ? toRGB565(BIGFOOD_BAR_RED, BIGFOOD_BAR_GREEN, BIGFOOD_BAR_BLUE) : toRGB565(0, 0, 0);
+        layer.fillRect(BIGFOOD_BAR_X + first, BIGFOOD_BAR_Y, count, BIGFOOD_BAR_HEIGHT, color);
+    }
+#endif
+}
+
+void Screen2View::patchHudScore(const touchgfx::Rect &changed)
+{
+#ifndef SIMULATOR
+    HudLayer &layer = HudLayer::getInstance();
+    if (changed.isEmpty() || !layer.isVisible() || statsOverlay.isVisible())
+        return;
+
+    // Back buffer only; it is shown at the end of the tick
+    uint16_t *buffer = reinterpret_cast<uint16_t *>(touchgfx::Bitmap::dynamicBitmapGetAddress(hudBitmaps[layer.getBackBuffer()]));
+    scoreDigits.drawInto(buffer + scoreDigits.getY() * HUD_WIDTH + scoreDigits.getX(), HUD_WIDTH, changed);
+    layer.invalidate(scoreDigits.getX() + changed.x, scoreDigits.getY() + changed.y, changed.width, changed.height);
+#endif
+}
+
+void Screen2View::benchmarkScore()
+{
+#if SCORE_BENCHMARK && !defined(SIMULATOR)
+    const uint16_t RUNS = 100;
+    HudLayer &layer = HudLayer::getInstance();
+    if (!layer.isVisible() || !scoreDigits.hasGlyphs())
+        return;
+
+    // Scores as they grow in a NORMAL game, so most updates change one or two digits
+    touchgfx::BitmapId back = hudBitmaps[layer.getBackBuffer()];
+    textArea1.setVisible(true);
+    scoreDigits.setVisible(false);
+    uint32_t start = PerfCounter_GetCycles();
+    for (uint16_t i = 1; i <= RUNS; i++)
+    {
+        touchgfx::Unicode::snprintf(scoreBuffer, 10, "%d", i * 3);
+        textArea1.setWildcard(scoreBuffer);
+        hud.drawToDynamicBitmap(back);
+    }
+    scoreBenchmark.textAreaCycles = (PerfCounter_GetCycles() - start) / RUNS;
+
+    textArea1.setVisible(false);
+    scoreDigits.setVisible(true);
+    start = PerfCounter_GetCycles();
+    for (uint16_t i = 1; i <= RUNS; i++)
+    {
+        patchHudScore(scoreDigits.setValue(i * 3));
+    }
+    scoreBenchmark.glyphCycles = (PerfCounter_GetCycles() - start) / RUNS;
+
+    // Leave the layer showing the HUD as it was
+    scoreDigits.setValue(0);
+    renderHud();
+#endif
 }
@@ -23,3 +23,12 @@ uint16_t Screen3Presenter::getHighScore()
 {
     return model->getHighScore();
 }
+
+void Screen3Presenter::buttonPressed(SnakeDirection dir, uint32_t timeMs)
+{
+    if (dir == SNAKE_DIR_DOWN)
+    {
+        model->startBenchmark();
+        view.startBenchmark();
+    }
+}
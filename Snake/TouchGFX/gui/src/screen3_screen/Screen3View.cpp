@@ -1,5 +1,11 @@
 #include <gui/screen3_screen/Screen3View.hpp>
 #include <touchgfx/Unicode.hpp>
+#include <touchgfx/Color.hpp>
+
+#ifndef SIMULATOR
+#include <BeamRaceMonitor.hpp>
+#include <TileBatchDMA.hpp>
+#endif
 
 Screen3View::Screen3View()
 {
@@ -13,6 +19,9 @@ void Screen3View::setupScreen()
 {
     Screen3ViewBase::setupScreen();
 
+    setupDigits(scoreDigits, textArea_Score);
+    setupDigits(highScoreDigits, textArea_Highscore);
+
     // Update score displays when screen is shown
     updateScoreDisplay();
 }
@@ -22,12 +31,46 @@ void Screen3View::tearDownScreen()
     Screen3ViewBase::tearDownScreen();
 }
 
+void Screen3View::startBenchmark()
+{
+#ifndef SIMULATOR
+    // Tearing/latency, cell clear and blit throughput counters cover the benchmark run only
+    BeamRaceMonitor::getInstance().reset();
+    TileBatchDMA::getInstance().resetTotals();
+#endif
+    application().gotoScreen2ScreenNoTransition();
+}
+
+void Screen3View::setupDigits(DigitScore &digits, touchgfx::TextAreaWithOneWildcard &text)
+{
+    const DigitGlyphs *glyphs = DigitGlyphs::get(text, touchgfx::Color::getColorFromRGB(0, 0, 0));
+    if (!glyphs)
+    {
+        return;
+    }
+
+    digits.setGlyphs(glyphs, touchgfx::Color::getColorFromRGB(0, 0, 0));
+    digits.setAlignment(DigitScore::ALIGN_CENTER);
+    digits.setPosition(text.getX(), text.getY(), text.getWidth(), text.getHeight());
+    text.setVisible(false);
+    add(digits);
+}
+
 void Screen3View::updateScoreDisplay()
 {
     // Get scores from presenter
     uint16_t lastScore = presenter->getLastScore();
     uint16_t highScore = presenter->getHighScore();
 
+    if (scoreDigits.hasGlyphs() && highScoreDigits.hasGlyphs())
+    {
+        touchgfx::Rect changed = scoreDigits.setValue(lastScore);
+        scoreDigits.invalidateRect(changed);
+        changed = highScoreDigits.setValue(highScore);
+        highScoreDigits.invalidateRect(changed);
+        return;
+    }
+
     // Update score buffer
     touchgfx::Unicode::snprintf(scoreBuffer, 10, "%d", lastScore);
     textArea_Score.setWildcard(scoreBuffer);
@@ -0,0 +1,118 @@
+#include "SimulatorHAL.hpp"
+#include <gui/common/SnakeInterface.h>
+#include <stdio.h>
+
+SimulatorHAL::SimulatorHAL(touchgfx::DMA_Interface& dma, touchgfx::LCD& lcd, touchgfx::TouchController& tc, uint16_t width, uint16_t height)
+    : touchgfx::HALSDL2(dma, lcd, tc, width, height),
+      ticks(0), turbo(false),
+      keyUp(false), keyDown(false), keyLeft(false), keyRight(false),
+      frameStart(0), busyTime(0), loadStart(0), loadFrames(0),
+      turboReportStart(0), turboReportTicks(0)
+{
+}
+
+void SimulatorHAL::enableKeyboard()
+{
+    // A watch sees the key events whether or not HALSDL2 consumes them
+    SDL_AddEventWatch(keyboardWatch, this);
+    loadStart = SDL_GetPerformanceCounter();
+}
+
+void SimulatorHAL::setTurbo(bool enabled)
+{
+    turbo = enabled;
+    turboReportStart = SDL_GetPerformanceCounter();
+    turboReportTicks = ticks;
+
+    // HALSDL2 paces ticks with its vsync interval; 0 ms runs them back to back
+    setVsyncInterval(enabled ? 0.0f : TICK_US / 1000.0f);
+}
+
+int SimulatorHAL::keyboardWatch(void* userdata, SDL_Event* event)
+{
+    SimulatorHAL* hal = static_cast<SimulatorHAL*>(userdata);
+
+    if ((event->type != SDL_KEYDOWN && event->type != SDL_KEYUP) || event->key.repeat != 0)
+    {
+        return 0;
+    }
+
+    bool pressed = event->type == SDL_KEYDOWN;
+    switch (event->key.keysym.sym)
+    {
+    case SDLK_UP:
+        hal->keyUp = pressed;
+        break;
+    case SDLK_DOWN:
+        hal->keyDown = pressed;
+        break;
+    case SDLK_LEFT:
+        hal->keyLeft = pressed;
+        break;
+    case SDLK_RIGHT:
+        hal->keyRight = pressed;
+        break;
+    default:
+        return 0;
+    }
+
+    // Level states, like the GPIO polling task; Model does the edge detection
+    Snake_UpdateButtonStates(hal->keyUp, hal->keyDown, hal->keyLeft, hal->keyRight);
+    return 0;
+}
+
+bool SimulatorHAL::beginFrame()
+{
+    ticks++;
+    frameStart = SDL_GetPerformanceCounter();
+    return touchgfx::HALSDL2::beginFrame();
+}
+
+void SimulatorHAL::endFrame()
+{
+    touchgfx::HALSDL2::endFrame();
+
+    uint64_t now = SDL_GetPerformanceCounter();
+    busyTime += now - frameStart;
+    loadFrames++;
+
+    if (turbo)
+    {
+        reportTurbo(now);
+    }
+}
+
+void SimulatorHAL::getLoad(uint16_t* cpuLoadPermille, uint32_t* framesRendered, uint32_t* elapsedMs)
+{
+    uint64_t now = SDL_GetPerformanceCounter();
+    uint64_t elapsed = now - loadStart;
+
+    *cpuLoadPermille = elapsed ? (uint16_t)(busyTime * 1000 / elapsed) : 0;
+    *framesRendered = loadFrames;
+    *elapsedMs = (uint32_t)(elapsed * 1000 / SDL_GetPerformanceFrequency());
+
+    loadStart = now;
+    busyTime = 0;
+    loadFrames = 0;
+}
+
+void SimulatorHAL::reportTurbo(uint64_t now)
+{
+    uint64_t frequency = SDL_GetPerformanceFrequency();
+    uint64_t elapsed = now - turboReportStart;
+
+    if (elapsed < frequency)
+    {
+        return;
+    }
+
+    uint64_t tickRate = (ticks - turboReportTicks) * frequency / elapsed;
+    printf("turbo: %u ticks/s, %u.%02ux real time\n",
+           (unsigned)tickRate,
+           (unsigned)(tickRate * TICK_US / 1000000),
+           (unsigned)(tickRate * TICK_US / 10000 % 100));
+    fflush(stdout);
+
+    turboReportStart = now;
+    turboReportTicks = ticks;
+}
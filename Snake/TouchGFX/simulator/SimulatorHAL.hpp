@@ -0,0 +1,76 @@
+#ifndef SIMULATORHAL_HPP
+#define SIMULATORHAL_HPP
+
+#include <platform/hal/simulator/sdl2/HALSDL2.hpp>
+#include <SDL2/SDL.h>
+#include <stdint.h>
+
+/**
+ * @class SimulatorHAL
+ *
+ * @brief SDL2 HAL of the desktop simulator, standing in for the board around the GUI.
+ *
+ *        The arrow keys act as the four game buttons and are handed to
+ *        Snake_UpdateButtonStates() like the GPIO polling task does on the target.
+ *        Game time is counted in ticks (1/60 s each), so BigFood timing follows the
+ *        game rather than the wall clock. In turbo mode ticks run as fast as the host
+ *        allows and the achieved tick rate is printed to the console every second.
+ */
+class SimulatorHAL : public touchgfx::HALSDL2
+{
+public:
+    /** Length of a simulated tick, in microseconds (60 Hz like the LTDC). */
+    static const uint32_t TICK_US = 16667;
+
+    SimulatorHAL(touchgfx::DMA_Interface& dma, touchgfx::LCD& lcd, touchgfx::TouchController& tc, uint16_t width, uint16_t height);
+
+    static SimulatorHAL& getInstance()
+    {
+        return *static_cast<SimulatorHAL*>(touchgfx::HAL::getInstance());
+    }
+
+    /** @brief Start forwarding the arrow keys to the game; call once SDL is up. */
+    void enableKeyboard();
+
+    /** @brief Run ticks back to back instead of at 60 Hz. */
+    void setTurbo(bool enabled);
+
+    /** @return Simulated time since start, in milliseconds. */
+    uint32_t getSimulatedMs() const
+    {
+        return (uint32_t)(ticks * TICK_US / 1000);
+    }
+
+    /**
+     * @brief Busy time and frames since the previous call, like PerfCounter_GetLoad().
+     *
+     *        The busy share is host time spent inside frames over the host time of
+     *        the interval, so it shows GUI cost but not target CPU load.
+     */
+    void getLoad(uint16_t* cpuLoadPermille, uint32_t* framesRendered, uint32_t* elapsedMs);
+
+    virtual bool beginFrame();
+    virtual void endFrame();
+
+private:
+    static int keyboardWatch(void* userdata, SDL_Event* event);
+
+    void reportTurbo(uint64_t now);
+
+    uint64_t ticks;
+    bool turbo;
+
+    // Arrow keys held down
+    bool keyUp, keyDown, keyLeft, keyRight;
+
+    // Host time, in SDL performance counter units
+    uint64_t frameStart;
+    uint64_t busyTime;
+    uint64_t loadStart;
+    uint32_t loadFrames;
+
+    uint64_t turboReportStart;
+    uint64_t turboReportTicks;
+};
+
+#endif // SIMULATORHAL_HPP
@@ -0,0 +1,91 @@
+// SnakeInterface for the desktop simulator, replacing the board functions in main.c.
+// The buzzer and the ISD1820 module print to the console, the high score lives in a
+// file in the working directory instead of Flash sector 23.
+
+#include "SimulatorHAL.hpp"
+#include <gui/common/SnakeInterface.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace
+{
+// Overridden with the SNAKE_SIM_STORAGE environment variable
+const char* const DEFAULT_STORAGE_FILE = "snake_highscore.txt";
+
+const char* storageFile()
+{
+    const char* path = getenv("SNAKE_SIM_STORAGE");
+    return path ? path : DEFAULT_STORAGE_FILE;
+}
+} // namespace
+
+extern "C"
+{
+    void Snake_PlayBuzzer(int durationMs)
+    {
+        if (durationMs > 0)
+        {
+            printf("[%8u ms] buzzer %d ms\n", Snake_GetTickMs(), durationMs);
+            fflush(stdout);
+        }
+    }
+
+    void Snake_PlayMusic(void)
+    {
+        printf("[%8u ms] ISD1820 play\n", Snake_GetTickMs());
+        fflush(stdout);
+    }
+
+    void Snake_TestISD1820Play(void)
+    {
+        Snake_PlayMusic();
+    }
+
+    uint32_t Snake_GetTickMs(void)
+    {
+        return SimulatorHAL::getInstance().getSimulatedMs();
+    }
+
+    void Snake_InitStorage(void)
+    {
+    }
+
+    uint16_t Snake_LoadHighScore(void)
+    {
+        unsigned score = 0;
+        FILE* f = fopen(storageFile(), "r");
+        if (f)
+        {
+            // A missing or corrupted file reads as 0, like an erased sector
+            if (fscanf(f, "%u", &score) != 1 || score > 0xFFFF)
+            {
+                score = 0;
+            }
+            fclose(f);
+        }
+        return (uint16_t)score;
+    }
+
+    void Snake_SaveHighScore(uint16_t score)
+    {
+        // Only keep higher scores, like FlashStorage_SaveHighScore()
+        if (score <= Snake_LoadHighScore())
+        {
+            return;
+        }
+
+        FILE* f = fopen(storageFile(), "w");
+        if (!f)
+        {
+            printf("cannot write %s\n", storageFile());
+            return;
+        }
+        fprintf(f, "%u\n", score);
+        fclose(f);
+    }
+
+    void Snake_GetLoadStats(uint16_t* cpuLoadPermille, uint32_t* framesRendered, uint32_t* elapsedMs)
+    {
+        SimulatorHAL::getInstance().getLoad(cpuLoadPermille, framesRendered, elapsedMs);
+    }
+}
@@ -0,0 +1,76 @@
+#include "SimulatorHAL.hpp"
+#include <touchgfx/hal/NoDMA.hpp>
+#include <common/TouchGFXInit.hpp>
+#include <gui_generated/common/SimConstants.hpp>
+#include <platform/driver/touch/SDL2TouchController.hpp>
+#include <touchgfx/lcd/LCD.hpp>
+#include <touchgfx/Bitmap.hpp>
+#include <gui/common/SnakeSprites.hpp>
+#include <stdlib.h>
+#include <string.h>
+#include <simulator/mainBase.hpp>
+
+using namespace touchgfx;
+
+/*
+ * Desktop simulator of the game. Arrow keys are the buttons; start with --turbo
+ * to run ticks as fast as possible and print the achieved tick rate, e.g. for
+ * profiling the GUI under perf or valgrind:
+ *
+ *     make -f simulator/gcc/Makefile -j8
+ *     ./build/bin/simulator.elf --turbo
+ */
+
+#ifdef __linux__
+int main(int argc, char** argv)
+{
+#else
+#include <shellapi.h>
+#ifdef _UNICODE
+#error Cannot run in unicode mode
+#endif
+int CALLBACK WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow)
+{
+    int argc;
+    char** argv = touchgfx::HALSDL2::getArgv(&argc);
+#endif
+
+    // --turbo is ours, the remaining arguments go to the TouchGFX simulator
+    bool turbo = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--turbo") == 0)
+        {
+            turbo = true;
+            for (int j = i; j < argc - 1; j++)
+            {
+                argv[j] = argv[j + 1];
+            }
+            argc--;
+            break;
+        }
+    }
+
+    touchgfx::NoDMA dma; //For windows/linux, DMA transfers are simulated
+    LCD& lcd = setupLCD();
+    touchgfx::SDL2TouchController tc;
+
+    touchgfx::HAL& hal = touchgfx::touchgfx_generic_init<SimulatorHAL>(dma, lcd, tc, SIM_WIDTH, SIM_HEIGHT, 0, 0);
+
+    setupSimulator(argc, argv, hal);
+
+    SimulatorHAL& simulatorHal = SimulatorHAL::getInstance();
+    simulatorHal.enableKeyboard();
+    simulatorHal.setTurbo(turbo);
+
+    touchgfx_init();
+
+    // The board sprites exist only in the bitmap cache, as on the board
+    static uint16_t bitmapCache[8 * 1024 / 2];
+    Bitmap::setCache(bitmapCache, sizeof(bitmapCache), SnakeSprites::BITMAP_COUNT);
+    SnakeSprites::generateSprites();
+
+    hal.taskEntry(); //Never returns
+
+    return EXIT_SUCCESS;
+}
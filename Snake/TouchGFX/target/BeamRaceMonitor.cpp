@@ -0,0 +1,121 @@
+#include <BeamRaceMonitor.hpp>
+#include "stm32f4xx_hal.h"
+#include "perf_counter.h"
+
+BeamRaceMonitor::BeamRaceMonitor()
+    : frameStartCycles(0), lastVSyncCycles(0), areaStartCycles(0), areaStartLine(0), areaOpen(false), frameCounted(false)
+{
+    stats.framePeriodCycles = 0;
+    reset();
+}
+
+void BeamRaceMonitor::reset()
+{
+    uint32_t period = stats.framePeriodCycles;
+
+    stats.frames = 0;
+    stats.areas = 0;
+    stats.tears = 0;
+    stats.lastLatencyCycles = 0;
+    stats.maxLatencyCycles = 0;
+    stats.framePeriodCycles = period;
+}
+
+uint16_t BeamRaceMonitor::getRawLine()
+{
+    return (uint16_t)(LTDC->CPSR & LTDC_CPSR_CYPOS);
+}
+
+uint16_t BeamRaceMonitor::getActiveLine()
+{
+    uint16_t line = getRawLine();
+    uint16_t firstActive = (uint16_t)(LTDC->BPCR & LTDC_BPCR_AVBP) + 1;
+
+    return (line < firstActive) ? 0 : line - firstActive;
+}
+
+void BeamRaceMonitor::vSync()
+{
+    uint32_t now = PerfCounter_GetCycles();
+
+    if (lastVSyncCycles != 0)
+    {
+        stats.framePeriodCycles = now - lastVSyncCycles;
+    }
+    lastVSyncCycles = now;
+}
+
+void BeamRaceMonitor::beginFrame()
+{
+    frameStartCycles = PerfCounter_GetCycles();
+    areaStartCycles = frameStartCycles;
+    areaStartLine = getRawLine();
+    areaOpen = false;
+    frameCounted = false;
+}
+
+void BeamRaceMonitor::areaStarted()
+{
+    if (!areaOpen)
+    {
+        areaStartCycles = PerfCounter_GetCycles();
+        areaStartLine = getRawLine();
+        areaOpen = true;
+    }
+}
+
+bool BeamRaceMonitor::linesSwept(uint16_t from, uint16_t to, uint16_t first, uint16_t last) const
+{
+    if (from <= to)
+    {
+        return first <= to && last >= from;
+    }
+
+    // The beam wrapped through the blanking period
+    return last >= from || first <= to;
+}
+
+void BeamRaceMonitor::areaFlushed(int16_t y, int16_t height)
+{
+    uint32_t now = PerfCounter_GetCycles();
+    uint16_t line = getRawLine();
+    uint16_t totalLines = (uint16_t)(LTDC->TWCR & LTDC_TWCR_TOTALH) + 1;
+    uint16_t firstActive = (uint16_t)(LTDC->BPCR & LTDC_BPCR_AVBP) + 1;
+    uint16_t first = firstActive + y;
+    uint16_t last = first + height - 1;
+
+    if (height <= 0)
+    {
+        return;
+    }
+
+    stats.areas++;
+    if (!frameCounted)
+    {
+        stats.frames++;
+        frameCounted = true;
+    }
+
+    // Drawing for longer than a frame always lets the beam pass through the area
+    bool fullFrame = stats.framePeriodCycles != 0 && now - areaStartCycles >= stats.framePeriodCycles;
+    if (fullFrame || linesSwept(areaStartLine, line, first, last))
+    {
+        stats.tears++;
+    }
+
+    // Visible once the beam next reaches the first row of the area
+    uint16_t linesToGo = (uint16_t)((first + totalLines - line) % totalLines);
+    uint32_t cyclesPerLine = stats.framePeriodCycles / totalLines;
+    uint32_t latency = (now - frameStartCycles) + linesToGo * cyclesPerLine;
+
+    stats.lastLatencyCycles = latency;
+    if (latency > stats.maxLatencyCycles)
+    {
+        stats.maxLatencyCycles = latency;
+    }
+
+    // Areas drawn without a framebuffer lock (e.g. only DMA2D fills) start at the previous flush
+    areaStartCycles = now;
+    areaStartLine = line;
+    areaOpen = false;
+}
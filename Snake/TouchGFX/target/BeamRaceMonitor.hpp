@@ -0,0 +1,88 @@
+#ifndef BEAMRACEMONITOR_HPP
+#define BEAMRACEMONITOR_HPP
+
+#include <stdint.h>
+
+/**
+ * @class BeamRaceMonitor
+ *
+ * @brief On-target tearing and latency check for single framebuffer rendering.
+ *
+ *        With one framebuffer the LTDC scans the same memory TouchGFX draws
+ *        into. For every flushed area this class records which LTDC lines were
+ *        scanned while the area was being drawn. If those lines overlap the area,
+ *        part of it was shown half drawn in that frame, which counts as a tear.
+ *        It also estimates the latency from the start of the frame until the
+ *        beam reaches the area, which is when the change becomes visible.
+ *        Results are kept in getStats() and are read with the debugger or on
+ *        the benchmark screen.
+ */
+class BeamRaceMonitor
+{
+public:
+    struct Stats
+    {
+        uint32_t frames;             ///< Frames with at least one flushed area
+        uint32_t areas;              ///< Flushed areas
+        uint32_t tears;              ///< Areas scanned out while being drawn
+        uint32_t lastLatencyCycles;  ///< Frame start to visible, last area (SYSCLK cycles)
+        uint32_t maxLatencyCycles;   ///< Highest latency seen (SYSCLK cycles)
+        uint32_t framePeriodCycles;  ///< Measured LTDC frame period (SYSCLK cycles)
+    };
+
+    static BeamRaceMonitor& getInstance()
+    {
+        static BeamRaceMonitor instance;
+        return instance;
+    }
+
+    /**
+     * @brief Current LTDC line relative to the first active line.
+     *
+     * @return 0 during vertical sync and back porch, the active line otherwise
+     *         (the display height or more in the front porch).
+     */
+    static uint16_t getActiveLine();
+
+    /** @brief Once per LTDC frame, from the TouchGFX task, to measure the frame period. */
+    void vSync();
+
+    /** @brief TouchGFX starts rendering a frame. */
+    void beginFrame();
+
+    /** @brief TouchGFX starts drawing the next area (first framebuffer lock after a flush). */
+    void areaStarted();
+
+    /**
+     * @brief TouchGFX has finished drawing an area.
+     *
+     * @param y, height Rows of the area on screen.
+     */
+    void areaFlushed(int16_t y, int16_t height);
+
+    /** @brief Clear the counters, e.g. before a benchmark run. */
+    void reset();
+
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+private:
+    BeamRaceMonitor();
+
+    // Raw LTDC line position (CPSR.CYPOS), including sync and back porch
+    static uint16_t getRawLine();
+
+    bool linesSwept(uint16_t from, uint16_t to, uint16_t first, uint16_t last) const;
+
+    Stats stats;
+    uint32_t frameStartCycles;
+    uint32_t lastVSyncCycles;
+    uint32_t areaStartCycles;
+    uint16_t areaStartLine;
+    bool areaOpen;
+    bool frameCounted;
+};
+
+#endif // BEAMRACEMONITOR_HPP
@@ -0,0 +1,219 @@
+#include <BitmapPreloader.hpp>
+#include <string.h>
+#include "stm32f4xx_hal.h"
+#include "perf_counter.h"
+
+using namespace touchgfx;
+
+namespace
+{
+DMA_HandleTypeDef hdmaPreload;
+
+void preloadTransferComplete(DMA_HandleTypeDef* hdma)
+{
+    (void)hdma;
+    BitmapPreloader::getInstance().transferDone(true);
+}
+
+void preloadTransferError(DMA_HandleTypeDef* hdma)
+{
+    (void)hdma;
+    BitmapPreloader::getInstance().transferDone(false);
+}
+}
+
+BitmapPreloader::BitmapPreloader()
+    : count(0), bitmapCount(0), next(0), busy(false), enabled(true),
+      requestedBytes(0), usedBytes(0), rejected(0), startCycles(0), copyCycles(0)
+{
+}
+
+bool BitmapPreloader::add(const void* src, void* dst, uint32_t size)
+{
+    requestedBytes += size;
+
+    /* Copies are done in words; reading up to 3 bytes past the end of flash data is harmless */
+    return addRegion(src, dst, (size + 3) & ~3u, BITMAP_INVALID, BITMAP_INVALID);
+}
+
+bool BitmapPreloader::addBitmap(BitmapId id)
+{
+    Bitmap bitmap(id);
+    uint32_t pixels = (uint32_t)bitmap.getWidth() * bitmap.getHeight();
+    uint32_t size;
+    switch (bitmap.getFormat())
+    {
+    case Bitmap::RGB565:
+        /* The alpha channel of RGB565 bitmaps is stored separately and not copied */
+        size = bitmap.getExtraData() ? 0 : pixels * 2;
+        break;
+    case Bitmap::RGB888:
+        size = pixels * 3;
+        break;
+    case Bitmap::ARGB8888:
+        size = pixels * 4;
+        break;
+    default:
+        size = 0;
+        break;
+    }
+
+    requestedBytes += size;
+
+    if (size < 4 || bitmap.getData() == 0 || bitmapCount >= MAX_BITMAPS || count >= MAX_REGIONS)
+    {
+        rejected++;
+        return false;
+    }
+
+    /* Exactly the size of the database entry, taken from the bitmap cache */
+    BitmapId copy = Bitmap::dynamicBitmapCreate(bitmap.getWidth(), bitmap.getHeight(), bitmap.getFormat());
+    if (copy == BITMAP_INVALID)
+    {
+        rejected++;
+        return false;
+    }
+
+    /* The DMA copies whole words; a trailing partial word is copied right away */
+    uint8_t* dst = Bitmap::dynamicBitmapGetAddress(copy);
+    uint32_t words = size & ~3u;
+    memcpy(dst + words, bitmap.getData() + words, size - words);
+
+    addRegion(bitmap.getData(), dst, words, id, copy);
+    usedBytes += size - words;
+    bitmapCount++;
+    return true;
+}
+
+bool BitmapPreloader::addRegion(const void* src, void* dst, uint32_t size, BitmapId bitmap, BitmapId copy)
+{
+    if (src == 0 || dst == 0 || count >= MAX_REGIONS)
+    {
+        rejected++;
+        return false;
+    }
+
+    Region& region = regions[count];
+    region.src = static_cast<const uint8_t*>(src);
+    region.dst = static_cast<uint8_t*>(dst);
+    region.size = size;
+    region.bitmap = bitmap;
+    region.copy = copy;
+    region.ready = false;
+
+    usedBytes += size;
+    count++;
+    return true;
+}
+
+void BitmapPreloader::start()
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    hdmaPreload.Instance = DMA2_Stream0;
+    hdmaPreload.Init.Channel = DMA_CHANNEL_0;
+    hdmaPreload.Init.Direction = DMA_MEMORY_TO_MEMORY;
+    hdmaPreload.Init.PeriphInc = DMA_PINC_ENABLE;
+    hdmaPreload.Init.MemInc = DMA_MINC_ENABLE;
+    hdmaPreload.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    hdmaPreload.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdmaPreload.Init.Mode = DMA_NORMAL;
+    hdmaPreload.Init.Priority = DMA_PRIORITY_LOW;
+    hdmaPreload.Init.FIFOMode = DMA_FIFOMODE_ENABLE;
+    hdmaPreload.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
+    hdmaPreload.Init.MemBurst = DMA_MBURST_SINGLE;
+    hdmaPreload.Init.PeriphBurst = DMA_PBURST_SINGLE;
+    if (HAL_DMA_Init(&hdmaPreload) != HAL_OK)
+    {
+        /* Everything stays in flash */
+        return;
+    }
+    HAL_DMA_RegisterCallback(&hdmaPreload, HAL_DMA_XFER_CPLT_CB_ID, preloadTransferComplete);
+    HAL_DMA_RegisterCallback(&hdmaPreload, HAL_DMA_XFER_ERROR_CB_ID, preloadTransferError);
+
+    HAL_NVIC_SetPriority(DMA2_Stream0_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+
+    next = 0;
+    busy = true;
+    startCycles = PerfCounter_GetCycles();
+    startNext();
+}
+
+void BitmapPreloader::startNext()
+{
+    while (next < count)
+    {
+        const Region& region = regions[next];
+        if (HAL_DMA_Start_IT(&hdmaPreload, reinterpret_cast<uint32_t>(region.src),
+                             reinterpret_cast<uint32_t>(region.dst), region.size / 4) == HAL_OK)
+        {
+            return;
+        }
+        /* Could not start: leave this one in flash */
+        next++;
+    }
+
+    copyCycles = PerfCounter_GetCycles() - startCycles;
+    busy = false;
+}
+
+void BitmapPreloader::transferDone(bool ok)
+{
+    regions[next].ready = ok;
+    next++;
+    startNext();
+}
+
+const void* BitmapPreloader::resolve(const void* src) const
+{
+    if (!enabled)
+    {
+        return src;
+    }
+
+    const uint8_t* address = static_cast<const uint8_t*>(src);
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const Region& region = regions[i];
+        if (address >= region.src && address < region.src + region.size)
+        {
+            return region.ready ? region.dst + (address - region.src) : src;
+        }
+    }
+    return src;
+}
+
+BitmapId BitmapPreloader::resolveBitmap(BitmapId id) const
+{
+    if (!enabled)
+    {
+        return id;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const Region& region = regions[i];
+        if (region.bitmap == id)
+        {
+            return region.ready ? region.copy : id;
+        }
+    }
+    return id;
+}
+
+void BitmapPreloader::handleInterrupt()
+{
+    HAL_DMA_IRQHandler(&hdmaPreload);
+}
+
+extern "C" void BitmapPreloader_IRQHandler(void)
+{
+    BitmapPreloader::getInstance().handleInterrupt();
+}
@@ -0,0 +1,159 @@
+#ifndef BITMAPPRELOADER_HPP
+#define BITMAPPRELOADER_HPP
+
+#include <stdint.h>
+#include <touchgfx/Bitmap.hpp>
+
+/**
+ * @class BitmapPreloader
+ *
+ * @brief Copies bitmap pixel data from internal flash to SDRAM at boot.
+ *
+ *        Internal flash runs with wait states at 180 MHz, so sprites blitted every
+ *        frame are cheaper to read from SDRAM. TouchGFX bitmaps are added with
+ *        addBitmap(), which takes a dynamic bitmap of the same size and format from
+ *        the bitmap cache, so the SDRAM used follows the BitmapDatabase entries.
+ *        Other data is added with add() and copied into storage of the caller.
+ *        The copies run in the background on DMA2 stream 0 (memory to memory),
+ *        one after the other, so start() returns immediately and the first frame
+ *        is not delayed. Until a copy is complete, resolve() and resolveBitmap()
+ *        keep returning the flash data. Bitmaps that do not fit the cache stay in flash.
+ */
+class BitmapPreloader
+{
+public:
+    /** Maximum number of preloaded regions. */
+    static const uint8_t MAX_REGIONS = 24;
+
+    /** Maximum number of preloaded bitmaps, i.e. dynamic bitmaps taken from the cache. */
+    static const uint8_t MAX_BITMAPS = 8;
+
+    static BitmapPreloader& getInstance()
+    {
+        static BitmapPreloader instance;
+        return instance;
+    }
+
+    /**
+     * @brief Copy a flash region to SDRAM. Must be called before start().
+     *
+     * @param src  Start of the data in flash.
+     * @param dst  Word aligned SDRAM storage of at least size bytes rounded up to words.
+     * @param size Size in bytes.
+     *
+     * @return false if there are no free regions; it will then be read from flash.
+     */
+    bool add(const void* src, void* dst, uint32_t size);
+
+    /**
+     * @brief Copy the pixels of a bitmap to a dynamic bitmap in the cache. Must be called
+     *        before start().
+     *
+     * @param id Bitmap in the BitmapDatabase (RGB565 without alpha, RGB888 or ARGB8888).
+     *
+     * @return false if the format is not supported or the cache is full; it will then be
+     *         read from flash.
+     */
+    bool addBitmap(touchgfx::BitmapId id);
+
+    /**
+     * @brief Start copying the added regions in the background.
+     */
+    void start();
+
+    /**
+     * @brief Address to read preloaded data from.
+     *
+     * @param src Flash address inside a region passed to add(), e.g. a sprite in an atlas.
+     *
+     * @return The same byte in the SDRAM copy once the region is complete (and preloading
+     *         is enabled), src otherwise.
+     */
+    const void* resolve(const void* src) const;
+
+    /**
+     * @brief Bitmap to draw instead of a bitmap passed to addBitmap().
+     *
+     * @return The dynamic bitmap holding the SDRAM copy once it is complete (and
+     *         preloading is enabled), id otherwise.
+     */
+    touchgfx::BitmapId resolveBitmap(touchgfx::BitmapId id) const;
+
+    /** Read from the SDRAM copies (true) or always from flash (false), for timing comparisons. */
+    void setEnabled(bool enable)
+    {
+        enabled = enable;
+    }
+
+    /** @return true when all regions have been copied. */
+    bool isDone() const
+    {
+        return next >= count && !busy;
+    }
+
+    /** @return Bytes requested through add() and addBitmap(), including those that did not fit. */
+    uint32_t getRequestedBytes() const
+    {
+        return requestedBytes;
+    }
+
+    /** @return Bytes copied to SDRAM. */
+    uint32_t getUsedBytes() const
+    {
+        return usedBytes;
+    }
+
+    /** @return Number of regions and bitmaps left in flash. */
+    uint8_t getRejectedCount() const
+    {
+        return rejected;
+    }
+
+    /** @return Time from start() until the last copy completed (SYSCLK cycles). */
+    uint32_t getCopyCycles() const
+    {
+        return copyCycles;
+    }
+
+    /**
+     * @brief Transfer complete/error handling, called from DMA2_Stream0_IRQHandler.
+     */
+    void handleInterrupt();
+
+    /** DMA completion, called through the HAL DMA callbacks. */
+    void transferDone(bool ok);
+
+private:
+    struct Region
+    {
+        const uint8_t* src;
+        uint8_t* dst;
+        uint32_t size;
+        touchgfx::BitmapId bitmap; ///< Bitmap passed to addBitmap(), BITMAP_INVALID for add()
+        touchgfx::BitmapId copy;   ///< Dynamic bitmap holding the copy
+        volatile bool ready;
+    };
+
+    bool addRegion(const void* src, void* dst, uint32_t size, touchgfx::BitmapId bitmap, touchgfx::BitmapId copy);
+
+    BitmapPreloader();
+
+    void startNext();
+
+    Region regions[MAX_REGIONS];
+    uint8_t count;
+    uint8_t bitmapCount;
+    volatile uint8_t next;
+    volatile bool busy;
+    bool enabled;
+
+    uint32_t requestedBytes;
+    uint32_t usedBytes;
+    uint8_t rejected;
+    uint32_t startCycles;
+    volatile uint32_t copyCycles;
+};
+
+extern "C" void BitmapPreloader_IRQHandler(void);
+
+#endif // BITMAPPRELOADER_HPP
@@ -0,0 +1,193 @@
+#include <DisplaySpi.hpp>
+#include <FrameBufferConfig.hpp>
+#include "stm32f4xx_hal.h"
+#include "perf_counter.h"
+
+extern SPI_HandleTypeDef hspi5;
+extern LTDC_HandleTypeDef hltdc;
+
+extern "C" {
+    void LCD_IO_WriteReg(uint8_t Reg);
+    void LCD_IO_WriteData(uint16_t RegValue);
+}
+
+/* ILI9341 commands */
+#define ILI9341_COLUMN_ADDR     0x2A
+#define ILI9341_PAGE_ADDR       0x2B
+#define ILI9341_GRAM            0x2C
+#define ILI9341_PIXEL_FORMAT    0x3A
+#define ILI9341_INTERFACE       0xF6
+
+/* LCD chip select and data/command lines, as used by LCD_IO_WriteReg() */
+#define LCD_CS_PORT  GPIOC
+#define LCD_CS_PIN   GPIO_PIN_2
+#define LCD_WRX_PORT GPIOD
+#define LCD_WRX_PIN  GPIO_PIN_13
+
+namespace
+{
+DMA_HandleTypeDef hdmaSpiTx;
+
+// Window set-up, one DMA transfer per step out of DisplaySpi::window. Commands
+// are 16-bit frames too: the high byte is a NOP (0x00) in front of the command.
+struct WindowStep
+{
+    uint8_t first;
+    uint8_t count;
+    bool command;
+};
+
+const WindowStep windowSteps[] = {
+    { 0, 1, true },  // Column address set
+    { 1, 2, false }, // x, x1
+    { 3, 1, true },  // Page address set
+    { 4, 2, false }, // y, y1
+    { 6, 1, true }   // Memory write, the pixels follow
+};
+
+const uint8_t WINDOW_STEP_COUNT = sizeof(windowSteps) / sizeof(windowSteps[0]);
+}
+
+DisplaySpi::DisplaySpi()
+    : doneCallback(0), transmitting(false), step(0), blockPixels(0), blockPixelCount(0),
+      blocks(0), bytes(0), startCycles(0), busyCycles(0)
+{
+    window[0] = ILI9341_COLUMN_ADDR;
+    window[3] = ILI9341_PAGE_ADDR;
+    window[6] = ILI9341_GRAM;
+}
+
+void DisplaySpi::init(DoneCallback callback)
+{
+    doneCallback = callback;
+
+    /* Stop scanning the (SDRAM) framebuffer */
+    __HAL_LTDC_DISABLE(&hltdc);
+
+    /* System interface (RM = 0) with internal clock (DM = 00): the panel shows its GRAM */
+    LCD_IO_WriteReg(ILI9341_INTERFACE);
+    LCD_IO_WriteData(0x01);
+    LCD_IO_WriteData(0x00);
+    LCD_IO_WriteData(0x00);
+
+    /* 16 bits per pixel on the MCU interface */
+    LCD_IO_WriteReg(ILI9341_PIXEL_FORMAT);
+    LCD_IO_WriteData(0x55);
+
+    /* 16-bit frames from here on, set once so the DMA interrupt never reinitialises
+       the SPI; a later LCD_IO_WriteReg() sends a NOP byte before its command */
+    hspi5.Init.DataSize = SPI_DATASIZE_16BIT;
+    HAL_SPI_Init(&hspi5);
+
+    /* SPI5_TX: DMA2 stream 4, channel 2 */
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    hdmaSpiTx.Instance = DMA2_Stream4;
+    hdmaSpiTx.Init.Channel = DMA_CHANNEL_2;
+    hdmaSpiTx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdmaSpiTx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdmaSpiTx.Init.MemInc = DMA_MINC_ENABLE;
+    hdmaSpiTx.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    hdmaSpiTx.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    hdmaSpiTx.Init.Mode = DMA_NORMAL;
+    hdmaSpiTx.Init.Priority = DMA_PRIORITY_HIGH;
+    hdmaSpiTx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdmaSpiTx) != HAL_OK)
+    {
+        return;
+    }
+    __HAL_LINKDMA(&hspi5, hdmatx, hdmaSpiTx);
+
+    HAL_NVIC_SetPriority(DMA2_Stream4_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream4_IRQn);
+}
+
+void DisplaySpi::transmitBlock(const uint8_t* pixels, uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+    transmitting = true;
+
+    window[1] = x;
+    window[2] = x + width - 1;
+    window[4] = y;
+    window[5] = y + height - 1;
+    blockPixels = pixels;
+    blockPixelCount = (uint16_t)(width * height);
+    step = 0;
+
+    blocks++;
+    bytes += (uint32_t)width * height * 2;
+    startCycles = PerfCounter_GetCycles();
+
+    HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
+    sendStep();
+}
+
+void DisplaySpi::sendStep()
+{
+    HAL_StatusTypeDef status;
+
+    /* The SPI is idle here (the HAL waits for BSY before the completion callback),
+       so the data/command line can change between transfers */
+    if (step < WINDOW_STEP_COUNT)
+    {
+        const WindowStep& windowStep = windowSteps[step];
+        HAL_GPIO_WritePin(LCD_WRX_PORT, LCD_WRX_PIN, windowStep.command ? GPIO_PIN_RESET : GPIO_PIN_SET);
+        status = HAL_SPI_Transmit_DMA(&hspi5, reinterpret_cast<uint8_t*>(&window[windowStep.first]), windowStep.count);
+    }
+    else
+    {
+        HAL_GPIO_WritePin(LCD_WRX_PORT, LCD_WRX_PIN, GPIO_PIN_SET);
+        status = HAL_SPI_Transmit_DMA(&hspi5, const_cast<uint8_t*>(blockPixels), blockPixelCount);
+    }
+
+    if (status != HAL_OK)
+    {
+        /* Drop the block rather than stall the frame */
+        finishBlock();
+    }
+}
+
+void DisplaySpi::transferDone()
+{
+    if (step < WINDOW_STEP_COUNT)
+    {
+        step++;
+        sendStep();
+    }
+    else
+    {
+        finishBlock();
+    }
+}
+
+void DisplaySpi::finishBlock()
+{
+    HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
+    busyCycles += PerfCounter_GetCycles() - startCycles;
+    transmitting = false;
+
+    if (doneCallback)
+    {
+        doneCallback();
+    }
+}
+
+void DisplaySpi::handleInterrupt()
+{
+    HAL_DMA_IRQHandler(&hdmaSpiTx);
+}
+
+#if SNAKE_PARTIAL_FRAMEBUFFER
+extern "C" void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi)
+{
+    if (hspi == &hspi5)
+    {
+        DisplaySpi::getInstance().transferDone();
+    }
+}
+#endif
+
+extern "C" void DisplaySpi_IRQHandler(void)
+{
+    DisplaySpi::getInstance().handleInterrupt();
+}
@@ -0,0 +1,93 @@
+#ifndef DISPLAYSPI_HPP
+#define DISPLAYSPI_HPP
+
+#include <stdint.h>
+
+/**
+ * @class DisplaySpi
+ *
+ * @brief Writes rectangles into the ILI9341 GRAM over SPI5 (partial framebuffer mode).
+ *
+ *        The ILI9341 on the DISCO board is normally fed by the LTDC through its RGB
+ *        interface. init() switches it to the system interface, so it shows its own
+ *        GRAM, turns the LTDC off and leaves the SPI in 16-bit frames (MSB first, as
+ *        the controller expects RGB565). transmitBlock() runs from the TouchGFX task
+ *        and from the DMA interrupt, so it never waits: the column/page window
+ *        commands, their parameters and the pixels are queued as DMA transfers on
+ *        stream 4, each started from the completion of the one before. The done
+ *        callback runs in the DMA interrupt when the last pixel has been shifted out.
+ */
+class DisplaySpi
+{
+public:
+    typedef void (*DoneCallback)();
+
+    static DisplaySpi& getInstance()
+    {
+        static DisplaySpi instance;
+        return instance;
+    }
+
+    /** @brief Switch the display to GRAM writes over SPI and set up the TX DMA. */
+    void init(DoneCallback callback);
+
+    /** @return true while a block is being sent. */
+    bool isTransmitting() const
+    {
+        return transmitting;
+    }
+
+    /**
+     * @brief Start sending a block of RGB565 pixels to a display rectangle.
+     *
+     * @param pixels Block data, width * height pixels, rows packed.
+     * @param x, y, width, height Display rectangle.
+     */
+    void transmitBlock(const uint8_t* pixels, uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+    /** @return Blocks and bytes sent since boot. */
+    uint32_t getBlockCount() const
+    {
+        return blocks;
+    }
+    uint32_t getByteCount() const
+    {
+        return bytes;
+    }
+
+    /** @return SYSCLK cycles the SPI has spent sending pixels since boot. */
+    uint32_t getBusyCycles() const
+    {
+        return busyCycles;
+    }
+
+    /** DMA interrupt, called from DMA2_Stream4_IRQHandler. */
+    void handleInterrupt();
+
+    /** End of a transfer, called through the HAL SPI callback. */
+    void transferDone();
+
+private:
+    DisplaySpi();
+
+    /** Start the DMA transfer of the current step, or the pixels after the last one. */
+    void sendStep();
+
+    /** Release the display and report the block as sent. */
+    void finishBlock();
+
+    DoneCallback doneCallback;
+    volatile bool transmitting;
+    uint16_t window[7];   ///< Window commands and parameters as 16-bit frames
+    uint8_t step;         ///< Transfer in progress, see sendStep()
+    const uint8_t* blockPixels;
+    uint16_t blockPixelCount;
+    uint32_t blocks;
+    uint32_t bytes;
+    uint32_t startCycles;
+    volatile uint32_t busyCycles;
+};
+
+extern "C" void DisplaySpi_IRQHandler(void);
+
+#endif // DISPLAYSPI_HPP
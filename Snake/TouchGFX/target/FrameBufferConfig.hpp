@@ -0,0 +1,55 @@
+#ifndef FRAMEBUFFERCONFIG_HPP
+#define FRAMEBUFFERCONFIG_HPP
+
+#include <stdint.h>
+
+// 0 = double framebuffer in SDRAM scanned out by the LTDC (default)
+// 1 = partial framebuffer blocks in internal SRAM, sent to the ILI9341 GRAM over SPI5.
+//     Nothing of ours is placed in SDRAM (the generated frameBuf is left
+//     unreferenced, see TouchGFXHAL::initialize()) and the FMC is not initialised.
+//     Set with `make partial_framebuffer=1` in gcc/. Not yet checked on hardware:
+//     the panel orientation (MADCTL) and the SPI5 clock.
+#ifndef SNAKE_PARTIAL_FRAMEBUFFER
+#define SNAKE_PARTIAL_FRAMEBUFFER 0
+#endif
+
+// 1 = a single framebuffer in SDRAM. The LTDC scans the buffer that is drawn
+//     into, so TouchGFX draws each dirty area only once the LTDC line has passed
+//     it (beam racing). Set with `make single_framebuffer=1` in gcc/. Neither the
+//     second framebuffer nor the animation storage is allocated: 300 KB less
+//     SDRAM than the default (150 KB framebuffer + 150 KB animation storage).
+#ifndef SNAKE_SINGLE_FRAMEBUFFER
+#define SNAKE_SINGLE_FRAMEBUFFER 0
+#endif
+
+#if SNAKE_PARTIAL_FRAMEBUFFER && SNAKE_SINGLE_FRAMEBUFFER
+#error "SNAKE_PARTIAL_FRAMEBUFFER and SNAKE_SINGLE_FRAMEBUFFER are exclusive"
+#endif
+
+namespace FrameBufferConfig
+{
+// Partial framebuffer: blocks of 10 full-width lines, three so that one can be
+// rendered while another is transmitted
+static const uint32_t PARTIAL_BLOCK_SIZE = 240 * 10 * 2;
+static const uint32_t PARTIAL_BLOCK_COUNT = 3;
+
+#if SNAKE_PARTIAL_FRAMEBUFFER
+// Framebuffer memory in internal SRAM
+static const uint32_t FRAMEBUFFER_BYTES = PARTIAL_BLOCK_SIZE * PARTIAL_BLOCK_COUNT;
+// Bitmap cache in internal SRAM, only for the snake sprites (14 x 200 bytes)
+static const uint32_t BITMAP_CACHE_BYTES = 4 * 1024;
+static const bool IN_SDRAM = false;
+#elif SNAKE_SINGLE_FRAMEBUFFER
+// One 240x320 RGB565 framebuffer in SDRAM
+static const uint32_t FRAMEBUFFER_BYTES = 240 * 320 * 2;
+static const uint32_t BITMAP_CACHE_BYTES = 128 * 1024;
+static const bool IN_SDRAM = true;
+#else
+// Two 240x320 RGB565 framebuffers in SDRAM
+static const uint32_t FRAMEBUFFER_BYTES = 2 * 240 * 320 * 2;
+static const uint32_t BITMAP_CACHE_BYTES = 128 * 1024;
+static const bool IN_SDRAM = true;
+#endif
+} // namespace FrameBufferConfig
+
+#endif // FRAMEBUFFERCONFIG_HPP
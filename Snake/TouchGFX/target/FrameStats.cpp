@@ -0,0 +1,142 @@
+#include <FrameStats.hpp>
+#include "perf_counter.h"
+
+namespace
+{
+// Histogram resolution: 0.5 ms bins cover 32 ms (two frames), idle in 1/64 steps
+const uint32_t TIME_BIN_US = 500;
+const uint32_t IDLE_BIN_PERMILLE = 16;
+} // namespace
+
+FrameStats::FrameStats()
+    : frames(0), next(0), logicStartCycles(0), logicCycles(0), frameStartCycles(0), frameCycles(0),
+      dma2dCycles(0), waitStartCycles(0), periodStartCycles(0), periodStartIdle(0)
+{
+    for (uint8_t m = 0; m < METRIC_COUNT; m++)
+    {
+        series[m].binWidth = (m == IDLE) ? IDLE_BIN_PERMILLE : TIME_BIN_US;
+    }
+    reset();
+}
+
+void FrameStats::reset()
+{
+    for (uint8_t m = 0; m < METRIC_COUNT; m++)
+    {
+        for (uint8_t i = 0; i < WINDOW; i++)
+        {
+            series[m].samples[i] = 0;
+        }
+        for (uint8_t i = 0; i < HISTOGRAM_BINS; i++)
+        {
+            series[m].histogram[i] = 0;
+        }
+    }
+    frames = 0;
+    next = 0;
+}
+
+void FrameStats::logicStart()
+{
+    logicStartCycles = PerfCounter_GetCycles();
+}
+
+void FrameStats::logicEnd()
+{
+    logicCycles += PerfCounter_GetCycles() - logicStartCycles;
+}
+
+void FrameStats::beginFrame()
+{
+    frameStartCycles = PerfCounter_GetCycles();
+}
+
+void FrameStats::endFrame(uint32_t dma2d)
+{
+    frameCycles += PerfCounter_GetCycles() - frameStartCycles;
+    dma2dCycles += dma2d;
+}
+
+void FrameStats::vSyncWaitStart()
+{
+    waitStartCycles = PerfCounter_GetCycles();
+}
+
+void FrameStats::vSyncWaitEnd()
+{
+    uint32_t now = PerfCounter_GetCycles();
+    uint32_t idle = PerfCounter_GetIdleCycles();
+    uint32_t period = now - periodStartCycles;
+
+    // The first call only starts the period
+    if (periodStartCycles != 0 && period != 0)
+    {
+        uint32_t drawCycles = (frameCycles > logicCycles) ? frameCycles - logicCycles : 0;
+        uint32_t idlePermille = (uint32_t)((uint64_t)(idle - periodStartIdle) * 1000 / period);
+
+        add(LOGIC, PerfCounter_CyclesToUs(logicCycles));
+        add(DRAW, PerfCounter_CyclesToUs(drawCycles));
+        add(DMA2D, PerfCounter_CyclesToUs(dma2dCycles));
+        add(VSYNC_WAIT, PerfCounter_CyclesToUs(now - waitStartCycles));
+        add(IDLE, (idlePermille > 1000) ? 1000 : idlePermille);
+
+        next = (next + 1) % WINDOW;
+        frames++;
+    }
+
+    logicCycles = 0;
+    frameCycles = 0;
+    dma2dCycles = 0;
+    periodStartCycles = now;
+    periodStartIdle = idle;
+}
+
+void FrameStats::add(Metric metric, uint32_t value)
+{
+    Series& s = series[metric];
+    uint32_t bin = value / s.binWidth;
+
+    s.samples[next] = value;
+    s.histogram[(bin < HISTOGRAM_BINS) ? bin : HISTOGRAM_BINS - 1]++;
+}
+
+FrameStats::Summary FrameStats::getSummary(Metric metric) const
+{
+    const Series& s = series[metric];
+    uint8_t count = (frames < WINDOW) ? (uint8_t)frames : WINDOW;
+    Summary summary = { 0, 0, 0, 0 };
+    uint32_t sum = 0;
+
+    if (count == 0)
+    {
+        return summary;
+    }
+
+    // Window: the last count samples (the ring is only partly filled at first)
+    summary.min = 0xFFFFFFFF;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint32_t value = s.samples[i];
+        sum += value;
+        if (value < summary.min)
+            summary.min = value;
+        if (value > summary.max)
+            summary.max = value;
+    }
+    summary.avg = sum / count;
+
+    // 99th percentile from the histogram since the last reset
+    uint32_t target = frames - frames / 100;
+    uint32_t seen = 0;
+    for (uint8_t bin = 0; bin < HISTOGRAM_BINS; bin++)
+    {
+        seen += s.histogram[bin];
+        if (seen >= target)
+        {
+            summary.p99 = (bin + 1) * s.binWidth;
+            break;
+        }
+    }
+
+    return summary;
+}
@@ -0,0 +1,102 @@
+#ifndef FRAMESTATS_HPP
+#define FRAMESTATS_HPP
+
+#include <stdint.h>
+
+/**
+ * @class FrameStats
+ *
+ * @brief Per-frame timing breakdown measured with the DWT cycle counter.
+ *
+ *        Every pass of the TouchGFX task loop (one LTDC frame) is split into
+ *        game logic (Screen2View::handleTickEvent), drawing (the rest of the
+ *        frame between beginFrame() and endFrame()), DMA2D busy time of the
+ *        batched tile blits, the wait for the next vsync and the share of the
+ *        frame the CPU slept in the FreeRTOS idle hook. Each metric keeps the
+ *        min/avg/max of the last WINDOW frames and a histogram since the last
+ *        reset for the 99th percentile.
+ */
+class FrameStats
+{
+public:
+    enum Metric
+    {
+        LOGIC = 0,  ///< Screen2View::handleTickEvent (us)
+        DRAW,       ///< Rendering outside the game logic (us)
+        DMA2D,      ///< DMA2D busy time of the tile batches (us)
+        VSYNC_WAIT, ///< Waiting for the next frame (us)
+        IDLE,       ///< Idle share of the frame (permille)
+        METRIC_COUNT
+    };
+
+    /** Number of frames in the rolling min/avg/max window. */
+    static const uint8_t WINDOW = 64;
+
+    /** Histogram bins; the last bin also collects everything above the range. */
+    static const uint8_t HISTOGRAM_BINS = 64;
+
+    struct Summary
+    {
+        uint32_t min;
+        uint32_t avg;
+        uint32_t max;
+        uint32_t p99; ///< Upper edge of the histogram bin holding the 99th percentile
+    };
+
+    static FrameStats& getInstance()
+    {
+        static FrameStats instance;
+        return instance;
+    }
+
+    /** @brief Game logic of the frame starts / ends (may be called more than once per frame). */
+    void logicStart();
+    void logicEnd();
+
+    /** @brief TouchGFX starts / finishes rendering the frame. */
+    void beginFrame();
+    void endFrame(uint32_t dma2dCycles);
+
+    /** @brief The TouchGFX task starts / stops waiting for the next frame; the end closes the frame. */
+    void vSyncWaitStart();
+    void vSyncWaitEnd();
+
+    /** @return Rolling and percentile values of a metric. */
+    Summary getSummary(Metric metric) const;
+
+    /** @return Number of frames recorded since the last reset. */
+    uint32_t getFrameCount() const
+    {
+        return frames;
+    }
+
+    /** @brief Clear all samples and histograms. */
+    void reset();
+
+private:
+    struct Series
+    {
+        uint32_t samples[WINDOW];
+        uint32_t histogram[HISTOGRAM_BINS];
+        uint32_t binWidth;
+    };
+
+    FrameStats();
+
+    void add(Metric metric, uint32_t value);
+
+    Series series[METRIC_COUNT];
+    uint32_t frames;
+    uint8_t next;
+
+    uint32_t logicStartCycles;
+    uint32_t logicCycles;
+    uint32_t frameStartCycles;
+    uint32_t frameCycles;
+    uint32_t dma2dCycles;
+    uint32_t waitStartCycles;
+    uint32_t periodStartCycles;
+    uint32_t periodStartIdle;
+};
+
+#endif // FRAMESTATS_HPP
@@ -0,0 +1,158 @@
+#include <HudLayer.hpp>
+#include "stm32f4xx_hal.h"
+#include <string.h>
+
+extern LTDC_HandleTypeDef hltdc;
+
+/* LTDC layer 2 (HAL index 1); layer 1 belongs to TouchGFX */
+#define HUD_LTDC_LAYER 1
+
+HudLayer::HudLayer()
+    : front(0), visible(false)
+{
+    buffers[0] = 0;
+    buffers[1] = 0;
+    changed.width = 0;
+    stale.width = 0;
+}
+
+void HudLayer::expand(Area& area, int16_t x, int16_t y, int16_t width, int16_t height)
+{
+    if (area.width == 0)
+    {
+        area.x = x;
+        area.y = y;
+        area.width = width;
+        area.height = height;
+        return;
+    }
+
+    int16_t right = (area.x + area.width > x + width) ? area.x + area.width : x + width;
+    int16_t bottom = (area.y + area.height > y + height) ? area.y + area.height : y + height;
+    area.x = (area.x < x) ? area.x : x;
+    area.y = (area.y < y) ? area.y : y;
+    area.width = right - area.x;
+    area.height = bottom - area.y;
+}
+
+void HudLayer::show(uint16_t* buffer0, uint16_t* buffer1)
+{
+    LTDC_LayerCfgTypeDef layerCfg = {0};
+
+    if (!isAvailable())
+    {
+        return;
+    }
+
+    buffers[0] = buffer0;
+    buffers[1] = buffer1;
+    front = 0;
+    /* Both buffers are expected to hold the same, complete HUD */
+    changed.width = 0;
+    stale.width = 0;
+
+    layerCfg.WindowX0 = X;
+    layerCfg.WindowX1 = X + WIDTH;
+    layerCfg.WindowY0 = Y;
+    layerCfg.WindowY1 = Y + HEIGHT;
+    layerCfg.PixelFormat = LTDC_PIXEL_FORMAT_RGB565;
+    layerCfg.Alpha = 255;
+    layerCfg.Alpha0 = 0;
+    /* Opaque: the HUD replaces layer 1 inside its window */
+    layerCfg.BlendingFactor1 = LTDC_BLENDING_FACTOR1_CA;
+    layerCfg.BlendingFactor2 = LTDC_BLENDING_FACTOR2_CA;
+    layerCfg.FBStartAdress = reinterpret_cast<uint32_t>(buffer0);
+    layerCfg.ImageWidth = WIDTH;
+    layerCfg.ImageHeight = HEIGHT;
+    layerCfg.Backcolor.Blue = 0;
+    layerCfg.Backcolor.Green = 0;
+    layerCfg.Backcolor.Red = 0;
+
+    /* Configures and enables the layer with an immediate reload */
+    if (HAL_LTDC_ConfigLayer(&hltdc, &layerCfg, HUD_LTDC_LAYER) == HAL_OK)
+    {
+        visible = true;
+    }
+}
+
+void HudLayer::hide()
+{
+    if (!visible)
+    {
+        return;
+    }
+
+    LTDC_Layer2->CR &= ~LTDC_LxCR_LEN;
+    LTDC->SRCR = (uint32_t)LTDC_SRCR_IMR;
+    visible = false;
+}
+
+uint8_t HudLayer::getBackBuffer()
+{
+    /* A pending vertical blanking reload means the old front buffer may still be scanned */
+    while ((LTDC->SRCR & LTDC_SRCR_VBR) != 0U)
+    {
+    }
+
+    uint8_t back = front ^ 1;
+    if (stale.width != 0)
+    {
+        for (int16_t row = stale.y; row < stale.y + stale.height; row++)
+        {
+            memcpy(buffers[back] + row * WIDTH + stale.x, buffers[front] + row * WIDTH + stale.x,
+                   stale.width * sizeof(uint16_t));
+        }
+        stale.width = 0;
+    }
+    return back;
+}
+
+void HudLayer::invalidate(int16_t x, int16_t y, int16_t width, int16_t height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return;
+    }
+    expand(changed, x, y, width, height);
+}
+
+void HudLayer::present()
+{
+    if (!visible || changed.width == 0)
+    {
+        return;
+    }
+    if (stale.width != 0)
+    {
+        /* Invalidated without drawing through getBackBuffer(): bring the buffer up to date first */
+        (void)getBackBuffer();
+    }
+
+    front ^= 1;
+    /* The new back buffer lacks what was drawn since the last present() */
+    stale = changed;
+    changed.width = 0;
+    LTDC_Layer2->CFBAR = reinterpret_cast<uint32_t>(buffers[front]);
+
+    /* Reload during vertical blanking so the HUD never tears */
+    LTDC->SRCR = (uint32_t)LTDC_SRCR_VBR;
+}
+
+void HudLayer::fillRect(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color)
+{
+    if (!visible || x < 0 || y < 0 || x + width > WIDTH || y + height > HEIGHT)
+    {
+        return;
+    }
+
+    uint16_t* buffer = buffers[getBackBuffer()];
+    for (int16_t row = y; row < y + height; row++)
+    {
+        uint16_t* pixel = buffer + row * WIDTH + x;
+        for (int16_t col = 0; col < width; col++)
+        {
+            pixel[col] = color;
+        }
+    }
+    invalidate(x, y, width, height);
+}
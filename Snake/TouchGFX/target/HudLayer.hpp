@@ -0,0 +1,117 @@
+#ifndef HUDLAYER_HPP
+#define HUDLAYER_HPP
+
+#include <stdint.h>
+#include <FrameBufferConfig.hpp>
+
+/**
+ * @class HudLayer
+ *
+ * @brief Shows the game HUD strip through LTDC layer 2.
+ *
+ *        Layer 1 scans the TouchGFX framebuffers. Layer 2 covers the strip below
+ *        the playfield and scans its own small RGB565 buffer, which the LTDC
+ *        composites in hardware. HUD updates therefore only render the strip and
+ *        never invalidate the playfield. The buffer is double buffered: changes go
+ *        into the back buffer only, present() switches to it during the next
+ *        vertical blanking period, and the presented area is copied into the
+ *        other buffer once that buffer is no longer scanned out.
+ */
+class HudLayer
+{
+public:
+    /** Window of the layer on screen, in pixels. */
+    static const uint16_t X = 0;
+    static const uint16_t Y = 280;
+    static const uint16_t WIDTH = 240;
+    static const uint16_t HEIGHT = 40;
+
+    /** Number of HUD buffers (front and back). */
+    static const uint8_t BUFFER_COUNT = 2;
+
+    static HudLayer& getInstance()
+    {
+        static HudLayer instance;
+        return instance;
+    }
+
+    /**
+     * @brief Enable layer 2 over the HUD strip.
+     *
+     * @param buffer0 WIDTH x HEIGHT RGB565 buffer, shown first.
+     * @param buffer1 Second buffer of the same size, drawn into next.
+     */
+    void show(uint16_t* buffer0, uint16_t* buffer1);
+
+    /** @brief Disable layer 2 immediately, the playfield framebuffer shows through again. */
+    void hide();
+
+    /** @return false when the LTDC is not used (partial framebuffer mode). */
+    static bool isAvailable()
+    {
+        return !SNAKE_PARTIAL_FRAMEBUFFER;
+    }
+
+    /** @return true while layer 2 is enabled. */
+    bool isVisible() const
+    {
+        return visible;
+    }
+
+    /**
+     * @brief Index (0 or 1) of the buffer to draw the next HUD into.
+     *
+     *        Waits until the previous present() has taken effect, so the returned
+     *        buffer is no longer being scanned out, then copies the area presented
+     *        last time from the front buffer so the back buffer is up to date.
+     */
+    uint8_t getBackBuffer();
+
+    /**
+     * @brief Mark an area of the back buffer as changed, to be shown by present().
+     *
+     * @param x, y, width, height Rectangle relative to the layer window.
+     */
+    void invalidate(int16_t x, int16_t y, int16_t width, int16_t height);
+
+    /** @brief Mark the whole back buffer as changed. */
+    void invalidate()
+    {
+        invalidate(0, 0, WIDTH, HEIGHT);
+    }
+
+    /**
+     * @brief Show the back buffer from the next vertical blank, if anything was
+     *        invalidated since the last present().
+     */
+    void present();
+
+    /**
+     * @brief Fill a rectangle in the back buffer and invalidate it, for small
+     *        updates that do not justify rendering the whole strip.
+     *
+     * @param x, y, width, height Rectangle relative to the layer window.
+     * @param color               RGB565 colour.
+     */
+    void fillRect(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color);
+
+private:
+    /** Pixel rectangle in the layer window; empty when width is 0. */
+    struct Area
+    {
+        int16_t x, y, width, height;
+    };
+
+    HudLayer();
+
+    /** @brief Grow area to also cover the given rectangle. */
+    static void expand(Area& area, int16_t x, int16_t y, int16_t width, int16_t height);
+
+    uint16_t* buffers[BUFFER_COUNT];
+    uint8_t front;
+    bool visible;
+    Area changed; ///< Drawn into the back buffer, not presented yet
+    Area stale;   ///< Presented from the front buffer, missing in the back buffer
+};
+
+#endif // HUDLAYER_HPP
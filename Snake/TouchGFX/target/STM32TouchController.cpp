@@ -20,10 +20,22 @@
 
 /* USER CODE BEGIN STM32TouchController */
 #include <STM32TouchController.hpp>
+#include <gui/common/SwipeGesture.hpp>
+#include <gui/common/SnakeInterface.h>
 #include "Components/stmpe811/stmpe811.h"
+#include "main.h"
+#include "perf_counter.h"
 
 #define TS_I2C_ADDRESS                      0x82
 
+/* 1 = read the controller over I2C every tick (the original BSP polling) */
+#ifndef TOUCH_INPUT_POLLED
+#define TOUCH_INPUT_POLLED 0
+#endif
+
+/* FIFO samples read per tick; each is 4 bytes (12 bit X, 12 bit Y, 8 bit Z) */
+#define TS_FIFO_BATCH                       16
+
 static TS_DrvTypeDef*     TsDrv;
 static uint16_t          TsXBoundary, TsYBoundary;
 
@@ -44,18 +56,63 @@ typedef enum
 
 uint8_t BSP_TS_Init(uint16_t XSize, uint16_t YSize);
 void    BSP_TS_GetState(TS_StateTypeDef* TsState);
+static void TS_ConvertRaw(uint16_t* x, uint16_t* y);
+static void TS_Filter(TS_StateTypeDef* TsState, uint16_t x, uint16_t y);
 
 extern "C" uint8_t isRevD; /* Applicable only for STM32F429I DISCOVERY REVD and above */
 
+/* Touch input cost, read with the debugger. Compare the busy cycles per
+   sampleTouch() call between TOUCH_INPUT_POLLED builds. */
+struct TouchStats
+{
+    uint32_t calls;       /* sampleTouch() calls */
+    uint32_t busCalls;    /* Calls that used the I2C bus */
+    uint32_t fifoSamples; /* Samples read from the FIFO */
+    uint32_t busyCycles;  /* SYSCLK cycles spent in sampleTouch(), wraps like CYCCNT */
+    uint32_t swipes;      /* Swipes passed on as button presses */
+} touchStats;
+
+static volatile uint8_t touchPending = 0; /* TP_INT fell since the last sample */
+static bool touchActive = false;          /* Finger down as of the last sample */
+static SwipeGesture swipe;
+
+/* Called from HAL_GPIO_EXTI_Callback; the I2C work is left to the GUI task */
+extern "C" void TouchController_IRQHandler(void)
+{
+    touchPending = 1;
+}
+
+static void feedSwipe(uint16_t x, uint16_t y)
+{
+    SnakeDirection dir;
+    if (swipe.addSample((int16_t)x, (int16_t)y, HAL_GetTick(), dir))
+    {
+        touchStats.swipes++;
+        Snake_InjectButtonPress(dir);
+    }
+}
+
 void STM32TouchController::init()
 {
     /**
      * Initialize touch controller and driver
      *
      */
-    BSP_TS_Init(240, 320);
+    if (BSP_TS_Init(240, 320) != TS_OK)
+    {
+        return;
+    }
+
+#if !TOUCH_INPUT_POLLED
+    /* Interrupt on touch down/up and FIFO overflow only; while the finger is
+       down sampleTouch() drains the FIFO every tick anyway */
+    IOE_ITConfig();
+    stmpe811_EnableITSource(TS_I2C_ADDRESS, STMPE811_GIT_TOUCH | STMPE811_GIT_FOV);
+    stmpe811_EnableGlobalIT(TS_I2C_ADDRESS);
+#endif
 }
 
+#if TOUCH_INPUT_POLLED
 bool STM32TouchController::sampleTouch(int32_t& x, int32_t& y)
 {
     /**
@@ -68,16 +125,111 @@ bool STM32TouchController::sampleTouch(int32_t& x, int32_t& y)
      * By default sampleTouch is called every tick, this can be adjusted by HAL::setTouchSampleRate(int8_t);
      *
      */
+    uint32_t start = PerfCounter_GetCycles();
+    bool touched = false;
     TS_StateTypeDef state;
+
+    touchStats.calls++;
+    touchStats.busCalls++;
     BSP_TS_GetState(&state);
     if (state.TouchDetected)
     {
+        feedSwipe(state.X, state.Y);
         x = state.X;
         y = state.Y;
-        return true;
+        touched = true;
+    }
+    else
+    {
+        swipe.release();
     }
-    return false;
+
+    touchStats.busyCycles += PerfCounter_GetCycles() - start;
+    return touched;
 }
+#else
+bool STM32TouchController::sampleTouch(int32_t& x, int32_t& y)
+{
+    /**
+     * Called every tick by the TouchGFX framework, but the bus is only used
+     * after TP_INT fell or while a finger is down. All samples the FIFO
+     * collected since the previous tick go to the swipe recognizer, the last
+     * one is the position reported to TouchGFX.
+     */
+    static TS_StateTypeDef state = {0, 0, 0, 0};
+    uint32_t start = PerfCounter_GetCycles();
+    uint8_t data[TS_FIFO_BATCH * 4];
+
+    touchStats.calls++;
+    if (!touchPending && !touchActive)
+    {
+        touchStats.busyCycles += PerfCounter_GetCycles() - start;
+        return false;
+    }
+
+    touchPending = 0;
+    touchStats.busCalls++;
+
+    /* Clear the status first, so a touch change from here on lowers TP_INT again */
+    IOE_Write(TS_I2C_ADDRESS, STMPE811_REG_INT_STA, 0xFF);
+
+    bool touched = (IOE_Read(TS_I2C_ADDRESS, STMPE811_REG_TSC_CTRL) & STMPE811_TS_CTRL_STATUS) != 0;
+    uint8_t count = IOE_Read(TS_I2C_ADDRESS, STMPE811_REG_FIFO_SIZE);
+    if (count > TS_FIFO_BATCH)
+    {
+        count = TS_FIFO_BATCH;
+    }
+
+    if (count > 0)
+    {
+        /* Reading the non-incrementing data register pops one sample per 4 bytes */
+        IOE_ReadMultiple(TS_I2C_ADDRESS, STMPE811_REG_TSC_DATA_NON_INC, data, count * 4);
+        for (uint8_t i = 0; i < count; i++)
+        {
+            uint32_t xyz = ((uint32_t)data[i * 4] << 24) | ((uint32_t)data[i * 4 + 1] << 16) |
+                           ((uint32_t)data[i * 4 + 2] << 8) | data[i * 4 + 3];
+            uint16_t sx = (xyz >> 20) & 0x0FFF;
+            uint16_t sy = (xyz >> 8) & 0x0FFF;
+
+            TS_ConvertRaw(&sx, &sy);
+            feedSwipe(sx, sy);
+            if (i == count - 1)
+            {
+                TS_Filter(&state, sx, sy);
+            }
+        }
+        touchStats.fifoSamples += count;
+        state.TouchDetected = 1;
+    }
+
+    if (!touched)
+    {
+        /* Finger lifted: drop what is left and wait for the next interrupt */
+        IOE_Write(TS_I2C_ADDRESS, STMPE811_REG_FIFO_STA, 0x01);
+        IOE_Write(TS_I2C_ADDRESS, STMPE811_REG_FIFO_STA, 0x00);
+        state.TouchDetected = 0;
+        swipe.release();
+    }
+    touchActive = touched;
+
+    /* Still low: a status bit was set again after the clear, its edge is gone */
+    if (HAL_GPIO_ReadPin(TP_INT_GPIO_Port, TP_INT_Pin) == GPIO_PIN_RESET)
+    {
+        touchPending = 1;
+    }
+
+    touchStats.busyCycles += PerfCounter_GetCycles() - start;
+
+    /* Down but no sample converted yet in this stroke: nothing to report */
+    if (!touched || !state.TouchDetected)
+    {
+        return false;
+    }
+    x = state.X;
+    y = state.Y;
+    return true;
+}
+#endif
 
 /**
   * @brief  Initializes and configures the touch screen functionalities and
@@ -119,96 +271,120 @@ uint8_t BSP_TS_Init(uint16_t XSize, uint16_t YSize)
   */
 void BSP_TS_GetState(TS_StateTypeDef* TsState)
 {
-    static uint32_t _x = 0, _y = 0;
-    uint16_t xDiff, yDiff, x, y, xr, yr;
+    uint16_t x, y;
 
     TsState->TouchDetected = TsDrv->DetectTouch(TS_I2C_ADDRESS);
 
     if (TsState->TouchDetected)
     {
         TsDrv->GetXY(TS_I2C_ADDRESS, &x, &y);
+        TS_ConvertRaw(&x, &y);
+        TS_Filter(TsState, x, y);
+    }
+}
 
-        if (isRevD)
-        {
-            //Ensures the coordinates are within the screen
-            if (y > 3700)
-            {
-                y = 3700;
-            }
-            else if (y < 180)
-            {
-                y = 180;
-            }
-
-            /* Y value first correction */
-            y -= 180;
+/**
+  * @brief  Converts raw STMPE811 coordinates to screen coordinates.
+  * @param  px: Raw X value in, screen X out
+  * @param  py: Raw Y value in, screen Y out
+  */
+static void TS_ConvertRaw(uint16_t* px, uint16_t* py)
+{
+    uint16_t x = *px, y = *py, xr, yr;
 
-            /* Y value second correction */
-            y = 3520 - y;
+    if (isRevD)
+    {
+        //Ensures the coordinates are within the screen
+        if (y > 3700)
+        {
+            y = 3700;
         }
-        else
+        else if (y < 180)
         {
-            /* Y value first correction */
-            y -= 360;
+            y = 180;
         }
 
+        /* Y value first correction */
+        y -= 180;
+
         /* Y value second correction */
-        yr = y / 11;
+        y = 3520 - y;
+    }
+    else
+    {
+        /* Y value first correction */
+        y -= 360;
+    }
 
-        /* Return y position value */
-        if (yr <= 0)
-        {
-            yr = 0;
-        }
-        else if (yr > TsYBoundary)
-        {
-            yr = TsYBoundary - 1;
-        }
-        else
-        {}
-        y = yr;
+    /* Y value second correction */
+    yr = y / 11;
 
-        /* X value first correction */
-        if (x <= 3000)
-        {
-            x = 3870 - x;
-        }
-        else
-        {
-            x = 3800 - x;
-        }
+    /* Return y position value */
+    if (yr <= 0)
+    {
+        yr = 0;
+    }
+    else if (yr > TsYBoundary)
+    {
+        yr = TsYBoundary - 1;
+    }
+    else
+    {}
+    *py = yr;
 
-        /* X value second correction */
-        xr = x / 15;
+    /* X value first correction */
+    if (x <= 3000)
+    {
+        x = 3870 - x;
+    }
+    else
+    {
+        x = 3800 - x;
+    }
 
-        /* Return X position value */
-        if (xr <= 0)
-        {
-            xr = 0;
-        }
-        else if (xr > TsXBoundary)
-        {
-            xr = TsXBoundary - 1;
-        }
-        else
-        {}
+    /* X value second correction */
+    xr = x / 15;
 
-        x = xr;
-        xDiff = x > _x ? (x - _x) : (_x - x);
-        yDiff = y > _y ? (y - _y) : (_y - y);
+    /* Return X position value */
+    if (xr <= 0)
+    {
+        xr = 0;
+    }
+    else if (xr > TsXBoundary)
+    {
+        xr = TsXBoundary - 1;
+    }
+    else
+    {}
 
-        if (xDiff + yDiff > 5)
-        {
-            _x = x;
-            _y = y;
-        }
+    *px = xr;
+}
+
+/**
+  * @brief  Updates the reported position, ignoring moves of up to 5 pixels.
+  * @param  TsState: Touch screen state to update
+  * @param  x: Screen X of the new sample
+  * @param  y: Screen Y of the new sample
+  */
+static void TS_Filter(TS_StateTypeDef* TsState, uint16_t x, uint16_t y)
+{
+    static uint32_t _x = 0, _y = 0;
+    uint16_t xDiff, yDiff;
 
-        /* Update the X position */
-        TsState->X = _x;
+    xDiff = x > _x ? (x - _x) : (_x - x);
+    yDiff = y > _y ? (y - _y) : (_y - y);
 
-        /* Update the Y position */
-        TsState->Y = _y;
+    if (xDiff + yDiff > 5)
+    {
+        _x = x;
+        _y = y;
     }
+
+    /* Update the X position */
+    TsState->X = _x;
+
+    /* Update the Y position */
+    TsState->Y = _y;
 }
 
 /* USER CODE END STM32TouchController */
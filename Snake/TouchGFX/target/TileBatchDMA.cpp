@@ -0,0 +1,282 @@
+#include <TileBatchDMA.hpp>
+#include <touchgfx/hal/HAL.hpp>
+#include "stm32f4xx_hal.h"
+#include "stm32f4xx_hal_dma2d.h"
+#include "perf_counter.h"
+#include <cmsis_os2.h>
+
+using namespace touchgfx;
+
+namespace
+{
+// Given by handleInterrupt() when a batch has ended, taken by execute()
+osSemaphoreId_t batchDone = NULL;
+
+// Set by init(); the DMA2D interrupt must not construct the instance itself
+TileBatchDMA* batcher = 0;
+}
+
+TileBatchDMA::TileBatchDMA()
+    : count(0), next(0), running(false), batchUsesClut(false), clut(0), clutSize(0), startCycles(0), busyCycles(0),
+      blitsThisFrame(0), batchesThisFrame(0), busyCyclesThisFrame(0),
+      directBlitsThisFrame(0), directCyclesThisFrame(0), clearsThisFrame(0), clearCyclesThisFrame(0), queuedPixels(0)
+{
+    stats.blitsLastFrame = 0;
+    stats.batchesLastFrame = 0;
+    stats.busyCyclesLastFrame = 0;
+    stats.cyclesPerBlitLastFrame = 0;
+    stats.maxBlitsPerFrame = 0;
+    stats.overflows = 0;
+    stats.errors = 0;
+    stats.clutLoads = 0;
+    stats.directBlitsLastFrame = 0;
+    stats.directCyclesLastFrame = 0;
+    stats.clearsLastFrame = 0;
+    stats.clearCyclesLastFrame = 0;
+    resetTotals();
+}
+
+void TileBatchDMA::init()
+{
+    if (batchDone == NULL)
+    {
+        batchDone = osSemaphoreNew(1, 0, NULL); // Binary semaphore
+    }
+    batcher = this;
+}
+
+void TileBatchDMA::resetTotals()
+{
+    stats.clearFrames = 0;
+    stats.clearsTotal = 0;
+    stats.clearCyclesTotal = 0;
+    stats.pixelsTotal = 0;
+    stats.busyCyclesTotal = 0;
+}
+
+bool TileBatchDMA::queue(uint32_t src, uint16_t srcStride, uint16_t* dst, uint16_t dstStride, uint16_t width, uint16_t height, uint8_t type)
+{
+    if (count >= MAX_COMMANDS)
+    {
+        stats.overflows++;
+        return false;
+    }
+
+    Command& cmd = commands[count];
+    cmd.src = src;
+    cmd.dst = reinterpret_cast<uint32_t>(dst);
+    cmd.srcOffset = (type == CMD_FILL) ? 0 : srcStride - width;
+    cmd.dstOffset = dstStride - width;
+    cmd.width = width;
+    cmd.height = height;
+    cmd.type = type;
+    count++;
+    queuedPixels += (uint32_t)width * height;
+
+    if (type == CMD_COPY_L8)
+    {
+        batchUsesClut = true;
+    }
+    return true;
+}
+
+bool TileBatchDMA::queueCopy(const uint16_t* src, uint16_t srcStride, uint16_t* dst, uint16_t dstStride, uint16_t width, uint16_t height)
+{
+    return queue(reinterpret_cast<uint32_t>(src), srcStride, dst, dstStride, width, height, CMD_COPY);
+}
+
+bool TileBatchDMA::queueCopyL8(const uint8_t* src, uint16_t srcStride, uint16_t* dst, uint16_t dstStride, uint16_t width, uint16_t height)
+{
+    if (clut == 0)
+    {
+        return false;
+    }
+    return queue(reinterpret_cast<uint32_t>(src), srcStride, dst, dstStride, width, height, CMD_COPY_L8);
+}
+
+bool TileBatchDMA::queueFill(uint16_t color, uint16_t* dst, uint16_t dstStride, uint16_t width, uint16_t height)
+{
+    return queue(color, 0, dst, dstStride, width, height, CMD_FILL);
+}
+
+void TileBatchDMA::setClut(const uint32_t* palette, uint16_t size)
+{
+    clut = palette;
+    clutSize = size;
+}
+
+void TileBatchDMA::loadClut()
+{
+    /* TouchGFX reloads the foreground CLUT for its own L8 bitmaps; FGCMAR tells whose palette is in there */
+    if (READ_REG(DMA2D->FGCMAR) == reinterpret_cast<uint32_t>(clut))
+    {
+        return;
+    }
+
+    WRITE_REG(DMA2D->FGCMAR, reinterpret_cast<uint32_t>(clut));
+    WRITE_REG(DMA2D->FGPFCCR, DMA2D_INPUT_L8 | (DMA2D_CCM_ARGB8888 << DMA2D_FGPFCCR_CCM_Pos) |
+              ((uint32_t)(clutSize - 1) << DMA2D_FGPFCCR_CS_Pos) | DMA2D_FGPFCCR_START);
+
+    while ((READ_REG(DMA2D->ISR) & DMA2D_FLAG_CTC) == 0U)
+    {
+    }
+    WRITE_REG(DMA2D->IFCR, DMA2D_FLAG_CTC);
+    stats.clutLoads++;
+}
+
+void TileBatchDMA::startCommand(const Command& cmd)
+{
+    /* Output is always the RGB565 framebuffer */
+    WRITE_REG(DMA2D->OPFCCR, DMA2D_OUTPUT_RGB565);
+    WRITE_REG(DMA2D->OMAR, cmd.dst);
+    WRITE_REG(DMA2D->OOR, cmd.dstOffset);
+    WRITE_REG(DMA2D->NLR, (cmd.height | (cmd.width << DMA2D_NLR_PL_Pos)));
+
+    if (cmd.type == CMD_FILL)
+    {
+        WRITE_REG(DMA2D->OCOLR, cmd.src);
+        WRITE_REG(DMA2D->CR, DMA2D_R2M | DMA2D_IT_TC | DMA2D_IT_CE | DMA2D_IT_TE | DMA2D_CR_START);
+    }
+    else if (cmd.type == CMD_COPY_L8)
+    {
+        /* CLUT already loaded by execute(), the CS field keeps the palette size */
+        WRITE_REG(DMA2D->FGMAR, cmd.src);
+        WRITE_REG(DMA2D->FGOR, cmd.srcOffset);
+        WRITE_REG(DMA2D->FGPFCCR, DMA2D_INPUT_L8 | (DMA2D_CCM_ARGB8888 << DMA2D_FGPFCCR_CCM_Pos) |
+                  ((uint32_t)(clutSize - 1) << DMA2D_FGPFCCR_CS_Pos) | (DMA2D_NO_MODIF_ALPHA << DMA2D_FGPFCCR_AM_Pos));
+        WRITE_REG(DMA2D->CR, DMA2D_M2M_PFC | DMA2D_IT_TC | DMA2D_IT_CE | DMA2D_IT_TE | DMA2D_CR_START);
+    }
+    else
+    {
+        WRITE_REG(DMA2D->FGMAR, cmd.src);
+        WRITE_REG(DMA2D->FGOR, cmd.srcOffset);
+        WRITE_REG(DMA2D->FGPFCCR, DMA2D_INPUT_RGB565 | (DMA2D_NO_MODIF_ALPHA << DMA2D_FGPFCCR_AM_Pos));
+        WRITE_REG(DMA2D->CR, DMA2D_M2M | DMA2D_IT_TC | DMA2D_IT_CE | DMA2D_IT_TE | DMA2D_CR_START);
+    }
+}
+
+void TileBatchDMA::execute()
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    /* The TouchGFX DMA queue shares the DMA2D; let it drain first */
+    HAL::getInstance()->flushDMA();
+
+    /* Wait for any stray register-level transfer (paint::rgb565::lineFrom*) */
+    while ((READ_REG(DMA2D->CR) & DMA2D_CR_START) != 0U)
+    {
+    }
+    WRITE_REG(DMA2D->IFCR, DMA2D_FLAG_TC | DMA2D_FLAG_CE | DMA2D_FLAG_TE);
+
+    if (batchUsesClut)
+    {
+        loadClut();
+    }
+
+    next = 1;
+    running = true;
+    startCycles = PerfCounter_GetCycles();
+    startCommand(commands[0]);
+
+    /* Remaining transfers are chained from handleInterrupt(); sleep until the last one */
+    if (batchDone != NULL)
+    {
+        osSemaphoreAcquire(batchDone, osWaitForever);
+    }
+    else
+    {
+        while (running)
+        {
+        }
+    }
+
+    blitsThisFrame += count;
+    batchesThisFrame++;
+    busyCyclesThisFrame += busyCycles;
+    stats.pixelsTotal += queuedPixels;
+    stats.busyCyclesTotal += busyCycles;
+    queuedPixels = 0;
+    count = 0;
+    next = 0;
+    batchUsesClut = false;
+}
+
+bool TileBatchDMA::handleInterrupt()
+{
+    if (!running)
+    {
+        return false;
+    }
+
+    uint32_t isr = READ_REG(DMA2D->ISR);
+
+    if ((isr & (DMA2D_FLAG_TE | DMA2D_FLAG_CE)) != 0U)
+    {
+        /* Abort the rest of the batch, the framebuffer area is left as-is */
+        WRITE_REG(DMA2D->IFCR, DMA2D_FLAG_TC | DMA2D_FLAG_CE | DMA2D_FLAG_TE);
+        WRITE_REG(DMA2D->CR, 0U);
+        stats.errors++;
+        busyCycles = PerfCounter_GetCycles() - startCycles;
+        running = false;
+        osSemaphoreRelease(batchDone);
+        return true;
+    }
+
+    if ((isr & DMA2D_FLAG_TC) != 0U)
+    {
+        WRITE_REG(DMA2D->IFCR, DMA2D_FLAG_TC);
+
+        if (next < count)
+        {
+            startCommand(commands[next]);
+            next++;
+        }
+        else
+        {
+            WRITE_REG(DMA2D->CR, 0U);
+            busyCycles = PerfCounter_GetCycles() - startCycles;
+            running = false;
+            osSemaphoreRelease(batchDone);
+        }
+    }
+
+    return true;
+}
+
+void TileBatchDMA::endFrame()
+{
+    stats.blitsLastFrame = blitsThisFrame;
+    stats.batchesLastFrame = batchesThisFrame;
+    stats.busyCyclesLastFrame = busyCyclesThisFrame;
+    stats.cyclesPerBlitLastFrame = (blitsThisFrame != 0) ? busyCyclesThisFrame / blitsThisFrame : 0;
+    stats.directBlitsLastFrame = directBlitsThisFrame;
+    stats.directCyclesLastFrame = directCyclesThisFrame;
+    stats.clearsLastFrame = clearsThisFrame;
+    stats.clearCyclesLastFrame = clearCyclesThisFrame;
+    if (clearsThisFrame != 0)
+    {
+        stats.clearFrames++;
+        stats.clearsTotal += clearsThisFrame;
+        stats.clearCyclesTotal += clearCyclesThisFrame;
+    }
+    if (blitsThisFrame > stats.maxBlitsPerFrame)
+    {
+        stats.maxBlitsPerFrame = blitsThisFrame;
+    }
+
+    blitsThisFrame = 0;
+    batchesThisFrame = 0;
+    busyCyclesThisFrame = 0;
+    directBlitsThisFrame = 0;
+    directCyclesThisFrame = 0;
+    clearsThisFrame = 0;
+    clearCyclesThisFrame = 0;
+}
+
+extern "C" int TileBatchDMA_IRQHandler(void)
+{
+    return (batcher != 0 && batcher->handleInterrupt()) ? 1 : 0;
+}
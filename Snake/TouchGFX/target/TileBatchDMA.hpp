@@ -0,0 +1,231 @@
+#ifndef TILEBATCHDMA_HPP
+#define TILEBATCHDMA_HPP
+
+#include <stdint.h>
+
+/**
+ * @class TileBatchDMA
+ *
+ * @brief Queues many small DMA2D transfers and chains them from the DMA2D interrupt.
+ *
+ *        The generated STM32DMA performs one transfer per TouchGFX draw call. For
+ *        the game board that means one setup and one interrupt per 10x10 cell. This
+ *        class collects a batch of cell blits (RGB565 or L8 copies and solid fills) and
+ *        programs the next transfer directly from the transfer-complete interrupt,
+ *        so the CPU only touches the DMA2D once per batch.
+ *
+ *        The batch must only be executed while the TouchGFX DMA queue is idle,
+ *        since both drive the same DMA2D instance. The calling task sleeps on a
+ *        semaphore while the batch runs, so the wait counts as idle time.
+ */
+class TileBatchDMA
+{
+public:
+    /** Maximum number of queued transfers in one batch. */
+    static const uint16_t MAX_COMMANDS = 160;
+
+    /** Per-frame statistics, latched at the end of each frame. */
+    struct Stats
+    {
+        uint32_t blitsLastFrame;      ///< Transfers executed in the previous frame
+        uint32_t batchesLastFrame;    ///< Batches (CPU kicks) in the previous frame
+        uint32_t busyCyclesLastFrame; ///< DMA2D busy time in the previous frame (SYSCLK cycles)
+        uint32_t cyclesPerBlitLastFrame; ///< Average DMA2D time per blit in the previous frame (SYSCLK cycles)
+        uint32_t maxBlitsPerFrame;    ///< Highest blit count seen in a single frame
+        uint32_t overflows;           ///< Commands rejected because the batch was full
+        uint32_t errors;              ///< DMA2D transfer or configuration errors
+        uint32_t clutLoads;           ///< Number of times the L8 palette was loaded into the CLUT
+        uint32_t directBlitsLastFrame;  ///< Cell blits issued one by one through TouchGFX in the previous frame
+        uint32_t directCyclesLastFrame; ///< Time spent on those blits in the previous frame (SYSCLK cycles)
+        uint32_t clearsLastFrame;       ///< Empty board cells cleared in the previous frame
+        uint32_t clearCyclesLastFrame;  ///< Time spent on those clears in the previous frame (SYSCLK cycles)
+        uint32_t clearFrames;           ///< Frames with cell clears since resetTotals() (one per game step)
+        uint32_t clearsTotal;           ///< Cells cleared since resetTotals()
+        uint32_t clearCyclesTotal;      ///< Time spent on them since resetTotals() (SYSCLK cycles)
+        uint32_t pixelsTotal;           ///< Pixels written by batches since resetTotals()
+        uint32_t busyCyclesTotal;       ///< DMA2D busy time of those batches (SYSCLK cycles)
+    };
+
+    static TileBatchDMA& getInstance()
+    {
+        static TileBatchDMA instance;
+        return instance;
+    }
+
+    /**
+     * @brief Create the completion semaphore and hook up the DMA2D interrupt.
+     *        Called from TouchGFXHAL::initialize(), before the first DMA2D interrupt.
+     */
+    void init();
+
+    /**
+     * @brief Queue an RGB565 to RGB565 rectangle copy.
+     *
+     * @param src       First source pixel.
+     * @param srcStride Source line length in pixels.
+     * @param dst       First destination pixel.
+     * @param dstStride Destination line length in pixels.
+     * @param width     Width in pixels.
+     * @param height    Height in pixels.
+     *
+     * @return false if the batch is full.
+     */
+    bool queueCopy(const uint16_t* src, uint16_t srcStride, uint16_t* dst, uint16_t dstStride, uint16_t width, uint16_t height);
+
+    /**
+     * @brief Queue an L8 to RGB565 rectangle copy through the CLUT set with setClut().
+     *
+     * @param src       First source index.
+     * @param srcStride Source line length in pixels.
+     * @param dst       First destination pixel.
+     * @param dstStride Destination line length in pixels.
+     * @param width     Width in pixels.
+     * @param height    Height in pixels.
+     *
+     * @return false if the batch is full.
+     */
+    bool queueCopyL8(const uint8_t* src, uint16_t srcStride, uint16_t* dst, uint16_t dstStride, uint16_t width, uint16_t height);
+
+    /**
+     * @brief Set the palette used for L8 copies.
+     *
+     *        The palette is loaded into the DMA2D foreground CLUT before the next batch
+     *        that needs it, and only reloaded if something else has loaded a CLUT since.
+     *
+     * @param palette ARGB8888 palette, must stay valid.
+     * @param size    Number of entries (1-256).
+     */
+    void setClut(const uint32_t* palette, uint16_t size);
+
+    /**
+     * @brief Queue a solid RGB565 rectangle fill.
+     *
+     * @param color     RGB565 fill color.
+     * @param dst       First destination pixel.
+     * @param dstStride Destination line length in pixels.
+     * @param width     Width in pixels.
+     * @param height    Height in pixels.
+     *
+     * @return false if the batch is full.
+     */
+    bool queueFill(uint16_t color, uint16_t* dst, uint16_t dstStride, uint16_t width, uint16_t height);
+
+    /**
+     * @brief Start the queued batch and block the calling task until the last
+     *        transfer has completed.
+     */
+    void execute();
+
+    /** @return true while a batch is being executed by the DMA2D. */
+    bool isBusy() const
+    {
+        return running;
+    }
+
+    /** @return Number of commands waiting in the current batch. */
+    uint16_t getQueuedCount() const
+    {
+        return count;
+    }
+
+    /**
+     * @brief Latch this frame's counters into the statistics. Called once per frame.
+     */
+    void endFrame();
+
+    /**
+     * @brief Account for blits drawn without batching, for comparison with the batched path.
+     *
+     * @param blits  Number of blits issued through the TouchGFX DMA queue.
+     * @param cycles Time from the first blit until the queue was flushed (SYSCLK cycles).
+     */
+    void noteDirectBlits(uint32_t blits, uint32_t cycles)
+    {
+        directBlitsThisFrame += blits;
+        directCyclesThisFrame += cycles;
+    }
+
+    /**
+     * @brief Account for board cells cleared to the background (fills or tile copies).
+     *
+     * @param clears Number of cells cleared.
+     * @param cycles Time until the clears had completed (SYSCLK cycles).
+     */
+    void noteClears(uint32_t clears, uint32_t cycles)
+    {
+        clearsThisFrame += clears;
+        clearCyclesThisFrame += cycles;
+    }
+
+    /** @brief Restart the cumulative clear and throughput counters, e.g. for a benchmark run. */
+    void resetTotals();
+
+    /** @return DMA2D busy time of the last executed batch (SYSCLK cycles). */
+    uint32_t getLastBatchCycles() const
+    {
+        return busyCycles;
+    }
+
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+    /**
+     * @brief Transfer-complete / error handling, called from DMA2D_IRQHandler.
+     *
+     * @return true if the interrupt belonged to a batch and has been handled.
+     */
+    bool handleInterrupt();
+
+private:
+    enum CommandType
+    {
+        CMD_COPY = 0,
+        CMD_COPY_L8,
+        CMD_FILL
+    };
+
+    struct Command
+    {
+        uint32_t src;   ///< Source address (copy) or RGB565 color (fill)
+        uint32_t dst;   ///< Destination address
+        uint16_t srcOffset;
+        uint16_t dstOffset;
+        uint16_t width;
+        uint16_t height;
+        uint8_t type;
+    };
+
+    TileBatchDMA();
+
+    void startCommand(const Command& cmd);
+    bool queue(uint32_t src, uint16_t srcStride, uint16_t* dst, uint16_t dstStride, uint16_t width, uint16_t height, uint8_t type);
+    void loadClut();
+
+    Command commands[MAX_COMMANDS];
+    volatile uint16_t count;
+    volatile uint16_t next;
+    volatile bool running;
+    bool batchUsesClut;
+
+    const uint32_t* clut;
+    uint16_t clutSize;
+
+    uint32_t startCycles;
+    volatile uint32_t busyCycles;
+    uint32_t blitsThisFrame;
+    uint32_t batchesThisFrame;
+    uint32_t busyCyclesThisFrame;
+    uint32_t directBlitsThisFrame;
+    uint32_t directCyclesThisFrame;
+    uint32_t clearsThisFrame;
+    uint32_t clearCyclesThisFrame;
+    uint32_t queuedPixels;
+
+    Stats stats;
+};
+
+extern "C" int TileBatchDMA_IRQHandler(void);
+
+#endif // TILEBATCHDMA_HPP
@@ -24,6 +24,25 @@
 
 #include "stm32f4xx.h"
 #include <touchgfx/hal/OSWrappers.hpp>
+#include <touchgfx/Application.hpp>
+#include <TileBatchDMA.hpp>
+#include <BitmapPreloader.hpp>
+#include <HudLayer.hpp>
+#include <touchgfx/Bitmap.hpp>
+#include <gui/common/SnakeSprites.hpp>
+#include <gui/common/DigitGlyphs.hpp>
+#include <FrameBufferConfig.hpp>
+#include <BeamRaceMonitor.hpp>
+#include <FrameStats.hpp>
+#include "perf_counter.h"
+#include "latency_probe.h"
+
+#if SNAKE_PARTIAL_FRAMEBUFFER
+#include <DisplaySpi.hpp>
+#include <touchgfx/hal/FrameBufferAllocator.hpp>
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
 
 extern "C" {
     void     LCD_IO_WriteReg(uint8_t Reg);
@@ -33,8 +52,51 @@ using namespace touchgfx;
 
 namespace
 {
+#if SNAKE_PARTIAL_FRAMEBUFFER
+// Framebuffer blocks and bitmap cache in internal SRAM; nothing touches SDRAM
+ManyBlockAllocator<FrameBufferConfig::PARTIAL_BLOCK_SIZE, FrameBufferConfig::PARTIAL_BLOCK_COUNT, 2> blockAllocator;
+uint16_t bitmapCache[FrameBufferConfig::BITMAP_CACHE_BYTES / 2];
+
+// Send the next rendered block if the SPI is idle (task and DMA interrupt context)
+void transmitNextBlock()
+{
+    DisplaySpi& display = DisplaySpi::getInstance();
+    if (!display.isTransmitting() && blockAllocator.hasBlockReadyForTransfer())
+    {
+        Rect rect;
+        const uint8_t* pixels = blockAllocator.getBlockForTransfer(rect);
+        display.transmitBlock(pixels, rect.x, rect.y, rect.width, rect.height);
+    }
+}
+
+void blockTransmitted()
+{
+    blockAllocator.freeBlockAfterTransfer();
+    transmitNextBlock();
+}
+#else
+#if SNAKE_SINGLE_FRAMEBUFFER
+// The only framebuffer; the generated two-buffer frameBuf is left unreferenced (see initialize())
+LOCATION_PRAGMA_NOLOAD("TouchGFX_Framebuffer")
+uint32_t singleFrameBuffer[FrameBufferConfig::FRAMEBUFFER_BYTES / 4] LOCATION_ATTRIBUTE_NOLOAD("TouchGFX_Framebuffer");
+#else
 LOCATION_PRAGMA_NOLOAD("TouchGFX_Framebuffer")
 uint32_t animationStorage[(240 * 320 * 2 + 3) / 4] LOCATION_ATTRIBUTE_NOLOAD("TouchGFX_Framebuffer");
+#endif
+
+// Bitmap cache for dynamic bitmaps (snake sprites, HUD layer buffers, score digit glyphs,
+// preloaded Screen2 bitmaps)
+LOCATION_PRAGMA_NOLOAD("TouchGFX_Framebuffer")
+uint16_t bitmapCache[FrameBufferConfig::BITMAP_CACHE_BYTES / 2] LOCATION_ATTRIBUTE_NOLOAD("TouchGFX_Framebuffer");
+
+// SDRAM copy of the L8 sprite atlas, read by the batched board blits
+LOCATION_PRAGMA_NOLOAD("TouchGFX_Framebuffer")
+uint32_t spriteAtlasCopy[(sizeof(snakeSpriteAtlasL8) + 3) / 4] LOCATION_ATTRIBUTE_NOLOAD("TouchGFX_Framebuffer");
+
+// Bitmaps of Screen2 drawn from the BitmapDatabase (the board sprites are generated
+// into the bitmap cache at boot, see SnakeSprites)
+const BitmapId screen2Bitmaps[] = { BITMAP_FOOD_ID, BITMAP_BIGFOOD_ID };
+#endif
 }
 
 void TouchGFXHAL::initialize()
@@ -45,14 +107,96 @@ void TouchGFXHAL::initialize()
     // and implemented needed functionality here.
     // Please note, HAL::initialize() must be called to initialize the framework.
 
+#if SNAKE_SINGLE_FRAMEBUFFER || SNAKE_PARTIAL_FRAMEBUFFER
+    // Replaces the generated initialize(), which registers both halves of its
+    // 2 x 150 KB frameBuf in SDRAM
+    HAL::initialize();
+    registerEventListener(*(Application::getInstance()));
+#if SNAKE_SINGLE_FRAMEBUFFER
+    // One buffer, drawn into and scanned out, and no animation storage (the
+    // GUI uses no screen transitions)
+    setFrameBufferStartAddresses((void*)singleFrameBuffer, 0, 0);
+#endif
+#else
     TouchGFXGeneratedHAL::initialize();
+#endif
+
+    // Batched board blits: set up here, before the DMA2D interrupt can first fire
+    TileBatchDMA::getInstance().init();
+
+#if SNAKE_PARTIAL_FRAMEBUFFER
+    // Render into SRAM blocks that are streamed to the display as they complete
+    setFrameBufferAllocator(&blockAllocator);
+    setFrameRefreshStrategy(REFRESH_STRATEGY_PARTIAL_FRAMEBUFFER);
 
+    // Only the board sprites fit; the HUD layer and digit glyphs fall back to the framebuffer path
+    Bitmap::setCache(bitmapCache, sizeof(bitmapCache), SnakeSprites::BITMAP_COUNT);
+    SnakeSprites::generateSprites();
+#else
+#if SNAKE_SINGLE_FRAMEBUFFER
+    // Scan out the buffer that is drawn into
+    setTFTFrameBuffer(frameBuffer0);
+
+    // Dirty areas are drawn once the LTDC line has passed them (see getTFTCurrentLine())
+    setFrameRefreshStrategy(REFRESH_STRATEGY_OPTIM_SINGLE_BUFFER_TFT_CTRL);
+#else
     // Add animation storage
     setAnimationStorage((void*)animationStorage);
+#endif
+
+    // Bitmap cache in SDRAM, then render the board sprites into it
+    Bitmap::setCache(bitmapCache, sizeof(bitmapCache), SnakeSprites::BITMAP_COUNT + HudLayer::BUFFER_COUNT + DigitGlyphs::BITMAP_COUNT + BitmapPreloader::MAX_BITMAPS);
+    SnakeSprites::generateSprites();
+
+    // Copy the stored game sprites to SDRAM in the background
+    preloadGameBitmaps();
+#endif
+}
+
+void TouchGFXHAL::preloadGameBitmaps()
+{
+#if !SNAKE_PARTIAL_FRAMEBUFFER
+    BitmapPreloader& preloader = BitmapPreloader::getInstance();
+
+    // Each copy is a dynamic bitmap sized from its BitmapDatabase entry; the
+    // Image widgets draw it through resolveBitmap() once it is complete
+    for (uint8_t i = 0; i < sizeof(screen2Bitmaps) / sizeof(screen2Bitmaps[0]); i++)
+    {
+        preloader.addBitmap(screen2Bitmaps[i]);
+    }
+
+    // All L8 sprites are sub-rectangles of one atlas: a single region
+    preloader.add(snakeSpriteAtlasL8, spriteAtlasCopy, sizeof(snakeSpriteAtlasL8));
+
+    preloader.start();
+#endif
 }
 
 void TouchGFXHAL::taskEntry()
 {
+#if SNAKE_PARTIAL_FRAMEBUFFER
+    // No LTDC, so no vsync interrupt: frames are paced by the RTOS at 60 Hz
+    // (17, 17 and 16 ms, i.e. 50 ms per three ticks)
+    static const TickType_t framePeriods[3] = { 17, 17, 16 };
+    uint8_t period = 0;
+
+    enableInterrupts();
+    DisplaySpi::getInstance().init(blockTransmitted);
+
+    backPorchExited();
+    LCD_IO_WriteReg(0x29);
+
+    TickType_t wake = xTaskGetTickCount();
+    for (;;)
+    {
+        FrameStats::getInstance().vSyncWaitStart();
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(framePeriods[period]));
+        FrameStats::getInstance().vSyncWaitEnd();
+        period = (period + 1) % 3;
+        backPorchExited();
+    }
+#endif
+
     enableLCDControllerInterrupt();
     enableInterrupts();
 
@@ -63,11 +207,55 @@ void TouchGFXHAL::taskEntry()
 
     for (;;)
     {
+        FrameStats::getInstance().vSyncWaitStart();
         OSWrappers::waitForVSync();
+        FrameStats::getInstance().vSyncWaitEnd();
+        LatencyProbe_VSync();
+#if SNAKE_SINGLE_FRAMEBUFFER
+        BeamRaceMonitor::getInstance().vSync();
+#endif
         backPorchExited();
     }
 }
 
+/**
+ * Current line of the LTDC, used by the single framebuffer refresh strategy to
+ * draw each area only after the beam has passed it.
+ *
+ * @return The active line being scanned, 0 during vertical blanking.
+ */
+uint16_t TouchGFXHAL::getTFTCurrentLine()
+{
+    return BeamRaceMonitor::getActiveLine();
+}
+
+/**
+ * Called before each area is drawn into the framebuffer.
+ *
+ * @return The framebuffer to draw into.
+ */
+uint16_t* TouchGFXHAL::lockFrameBuffer()
+{
+#if SNAKE_SINGLE_FRAMEBUFFER
+    BeamRaceMonitor::getInstance().areaStarted();
+#endif
+    return TouchGFXGeneratedHAL::lockFrameBuffer();
+}
+
+/**
+ * Called when the framework starts rendering a frame.
+ *
+ * @return true if rendering can begin.
+ */
+bool TouchGFXHAL::beginFrame()
+{
+#if SNAKE_SINGLE_FRAMEBUFFER
+    BeamRaceMonitor::getInstance().beginFrame();
+#endif
+    FrameStats::getInstance().beginFrame();
+    return TouchGFXGeneratedHAL::beginFrame();
+}
+
 /**
  * Gets the frame buffer address used by the TFT controller.
  *
@@ -114,7 +302,38 @@ void TouchGFXHAL::flushFrameBuffer(const touchgfx::Rect& rect)
     // Please note, HAL::flushFrameBuffer(const touchgfx::Rect& rect) must
     // be called to notify the touchgfx framework that flush has been performed.
 
+#if SNAKE_PARTIAL_FRAMEBUFFER
+    // The block holding rect is complete: queue it and start sending if the SPI is idle
+    HAL::flushFrameBuffer(rect);
+    blockAllocator.markBlockReadyForTransfer();
+    HAL_NVIC_DisableIRQ(DMA2_Stream4_IRQn);
+    transmitNextBlock();
+    HAL_NVIC_EnableIRQ(DMA2_Stream4_IRQn);
+#else
     TouchGFXGeneratedHAL::flushFrameBuffer(rect);
+#endif
+#if SNAKE_SINGLE_FRAMEBUFFER
+    BeamRaceMonitor::getInstance().areaFlushed(rect.y, rect.height);
+#endif
+    frameDrawn = true;
+}
+
+/**
+ * Called when the framework has finished rendering a frame.
+ */
+void TouchGFXHAL::endFrame()
+{
+    TileBatchDMA::getInstance().endFrame();
+    FrameStats::getInstance().endFrame(TileBatchDMA::getInstance().getStats().busyCyclesLastFrame);
+
+    if (frameDrawn)
+    {
+        PerfCounter_FrameRendered();
+        LatencyProbe_FrameRendered();
+        frameDrawn = false;
+    }
+
+    TouchGFXGeneratedHAL::endFrame();
 }
 
 /**
@@ -47,7 +47,7 @@ public:
      * @param width            Width of the display.
      * @param height           Height of the display.
      */
-    TouchGFXHAL(touchgfx::DMA_Interface& dma, touchgfx::LCD& display, touchgfx::TouchController& tc, uint16_t width, uint16_t height) : TouchGFXGeneratedHAL(dma, display, tc, width, height)
+    TouchGFXHAL(touchgfx::DMA_Interface& dma, touchgfx::LCD& display, touchgfx::TouchController& tc, uint16_t width, uint16_t height) : TouchGFXGeneratedHAL(dma, display, tc, width, height), frameDrawn(false)
     {
     }
 
@@ -122,6 +122,48 @@ public:
      */
     virtual void flushFrameBuffer(const touchgfx::Rect& rect);
 
+    /**
+     * @fn virtual void TouchGFXHAL::endFrame();
+     *
+     * @brief Called when a frame has been rendered.
+     *
+     *        Latches the per-frame tile batch statistics and frame times before
+     *        handing over to the generated implementation.
+     */
+    virtual void endFrame();
+
+    /**
+     * @fn virtual bool TouchGFXHAL::beginFrame();
+     *
+     * @brief Called when a frame is about to be rendered.
+     *
+     *        Starts the frame time measurement, and the tearing/latency
+     *        measurement in single framebuffer mode.
+     */
+    virtual bool beginFrame();
+
+    /**
+     * @fn virtual uint16_t* TouchGFXHAL::lockFrameBuffer();
+     *
+     * @brief Called before drawing into the framebuffer.
+     *
+     *        Marks the start of an area for the tearing measurement in single
+     *        framebuffer mode.
+     */
+    virtual uint16_t* lockFrameBuffer();
+
+    /**
+     * @fn virtual uint16_t TouchGFXHAL::getTFTCurrentLine();
+     *
+     * @brief Line currently scanned out by the LTDC.
+     *
+     *        Required by REFRESH_STRATEGY_OPTIM_SINGLE_BUFFER_TFT_CTRL, which waits
+     *        for the beam to pass an area before drawing it.
+     *
+     * @return The active line, 0 during vertical blanking.
+     */
+    virtual uint16_t getTFTCurrentLine();
+
 protected:
     /**
      * @fn virtual uint16_t* TouchGFXHAL::getTFTFrameBuffer() const;
@@ -144,6 +186,20 @@ protected:
      * @param [in,out] adr New frame buffer address.
      */
     virtual void setTFTFrameBuffer(uint16_t* adr);
+
+    /**
+     * @fn void TouchGFXHAL::preloadGameBitmaps();
+     *
+     * @brief Starts copying the Screen2 bitmaps and the sprite atlas from internal flash to SDRAM.
+     *
+     *        The copy runs on DMA2 in the background; blits keep reading flash
+     *        until each bitmap has been copied. Not available in the partial
+     *        framebuffer build, which does not use the SDRAM.
+     */
+    void preloadGameBitmaps();
+
+    /** Set by flushFrameBuffer(); ticks without invalidations end a frame with nothing drawn. */
+    bool frameDrawn;
 };
 
 /* USER CODE END TouchGFXHAL.hpp */
@@ -0,0 +1,86 @@
+// Host benchmark of the IMA-ADPCM decoder (Core/Src/adpcm.c).
+//
+// Decodes the game over sound from Core/Inc/audio_data.h the way the audio
+// engine does, one half buffer (AUDIO_HALF_SAMPLES) per call, over and over,
+// and reports the time per half buffer. The checksum of the decoded samples
+// must match the one printed by tools/audio_adpcm.py.
+//
+// On the target the same work is one refill interrupt: AudioEngine_GetStats()
+// gives its cycles (busyCycles / interrupts, maxCycles).
+//
+// Build and run from the Snake directory:
+//     make -C tools/adpcm_bench
+//     tools/adpcm_bench/adpcm_bench [--passes N]
+
+#include "adpcm.h"
+#include "audio_data.h"
+#include "audio_engine.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+    int passes = 200;
+    AdpcmDecoder decoder;
+    int16_t half[AUDIO_HALF_SAMPLES];
+    uint32_t checksum = 0;
+    uint32_t buffers = 0;
+    uint32_t samples = 0;
+    uint32_t count;
+    double start, elapsed;
+    int pass;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc)
+        {
+            passes = atoi(argv[++i]);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--passes N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // One pass for the checksum
+    Adpcm_Init(&decoder, gameOverAudioData, gameOverAudioSamples);
+    while ((count = Adpcm_Decode(&decoder, half, AUDIO_HALF_SAMPLES)) > 0)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            checksum += (uint32_t)(int32_t)half[i];
+        }
+    }
+
+    start = nowNs();
+    for (pass = 0; pass < passes; pass++)
+    {
+        Adpcm_Init(&decoder, gameOverAudioData, gameOverAudioSamples);
+        while ((count = Adpcm_Decode(&decoder, half, AUDIO_HALF_SAMPLES)) > 0)
+        {
+            buffers++;
+            samples += count;
+        }
+    }
+    elapsed = nowNs() - start;
+
+    printf("ADPCM decode: %u samples, %u bytes, decoded checksum 0x%08X\n",
+           (unsigned)gameOverAudioSamples, (unsigned)gameOverAudioSize, (unsigned)checksum);
+    printf("ADPCM decode: %u buffers of %u samples, %.1f ns per buffer, %.2f ns per sample\n",
+           (unsigned)buffers, (unsigned)AUDIO_HALF_SAMPLES, elapsed / buffers, elapsed / samples);
+    printf("ADPCM decode: %.0fx real time at %u Hz\n",
+           (samples / (double)AUDIO_SAMPLE_RATE) / (elapsed / 1e9), (unsigned)AUDIO_SAMPLE_RATE);
+    return 0;
+}
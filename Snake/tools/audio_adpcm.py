@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""Convert a WAV sound to 4-bit IMA-ADPCM at the playback rate, as a C header.
+
+The game over sound used to be embedded as 44.1 kHz 16-bit PCM, of which the
+player only used every 5th sample. This resamples it to the audio engine's rate
+with a polyphase low-pass filter (audio_resample.py) and stores it as IMA-ADPCM
+(4 bits per sample), decoded by Core/Src/adpcm.c a half buffer at a time from
+the audio refill interrupt. The firmware does no resampling.
+
+Usage (from the Snake directory, also run by gcc/Makefile):
+    python3 tools/audio_adpcm.py [--wav FILE] [--header FILE] [--name NAME] [--rate HZ]
+
+Prints the flash saving, the ADPCM error against the PCM it encodes and a
+checksum of the decoded samples (tools/adpcm_bench prints the same one).
+"""
+
+import argparse
+import math
+import os
+import struct
+import sys
+import wave
+
+from audio_resample import resample
+from png_reader import write_if_changed
+
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+    34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143,
+    157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+    724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024,
+    3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767]
+
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8]
+
+# Audio engine sample rate (AUDIO_SAMPLE_RATE in Core/Inc/audio_engine.h)
+DEVICE_RATE = 8000
+
+
+def read_wav(path):
+    """Return (rate, samples) of a 16-bit PCM WAV, channels averaged to mono."""
+    w = wave.open(path, "rb")
+    try:
+        if w.getsampwidth() != 2:
+            raise ValueError("%s: only 16-bit PCM is supported" % path)
+        channels = w.getnchannels()
+        rate = w.getframerate()
+        frames = w.readframes(w.getnframes())
+    finally:
+        w.close()
+    values = struct.unpack("<%dh" % (len(frames) // 2), frames)
+    if channels > 1:
+        values = [sum(values[i:i + channels]) // channels for i in range(0, len(values), channels)]
+    return rate, list(values)
+
+
+def decode_step(code, predictor, index):
+    """One sample of the decoder in Core/Src/adpcm.c (same arithmetic)."""
+    step = STEP_TABLE[index]
+    diff = step >> 3
+    if code & 4:
+        diff += step
+    if code & 2:
+        diff += step >> 1
+    if code & 1:
+        diff += step >> 2
+    predictor += -diff if code & 8 else diff
+    predictor = max(-32768, min(32767, predictor))
+    index = max(0, min(88, index + INDEX_TABLE[code]))
+    return predictor, index
+
+
+def encode(samples):
+    """IMA-ADPCM encode from predictor 0 / index 0, tracking the decoder exactly.
+
+    Returns (packed bytes, decoded samples)."""
+    predictor = 0
+    index = 0
+    codes = []
+    decoded = []
+    for s in samples:
+        step = STEP_TABLE[index]
+        delta = s - predictor
+        code = 0
+        if delta < 0:
+            code = 8
+            delta = -delta
+        if delta >= step:
+            code |= 4
+            delta -= step
+        if delta >= step >> 1:
+            code |= 2
+            delta -= step >> 1
+        if delta >= step >> 2:
+            code |= 1
+        predictor, index = decode_step(code, predictor, index)
+        codes.append(code)
+        decoded.append(predictor)
+
+    if len(codes) & 1:
+        codes.append(0)
+    data = bytes(codes[i] | (codes[i + 1] << 4) for i in range(0, len(codes), 2))
+    return data, decoded
+
+
+def snr_db(reference, decoded):
+    signal = sum(float(s) * s for s in reference)
+    noise = sum(float(a - b) * (a - b) for a, b in zip(reference, decoded))
+    if noise == 0:
+        return float("inf")
+    return 10.0 * math.log10(signal / noise) if signal else 0.0
+
+
+def c_array(values, fmt, per_line):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(fmt % v for v in values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def emit_header(name, source, source_rate, source_frames, rate, samples, data):
+    guard = name.upper() + "_H"
+    return """/* Generated by tools/audio_adpcm.py from %s - do not edit */
+#ifndef %s
+#define %s
+
+#include <stdint.h>
+
+/**
+ * @brief %s, IMA-ADPCM (decode with Core/Src/adpcm.c)
+ *
+ * Audio Format:
+ *   Channels: 1 (Mono)
+ *   Sample Rate: %d Hz (source %d Hz, %d frames)
+ *   Sample Width: 4-bit IMA-ADPCM, low nibble first
+ *   Total Samples: %d
+ *   Duration: %.2f seconds
+ *   Data Size: %d bytes (%d bytes as 16-bit PCM at the source rate)
+ */
+const uint8_t %sData[] = {
+%s
+};
+
+const uint32_t %sSize = sizeof(%sData);
+const uint32_t %sSamples = %d;
+const uint8_t %sChannels = 1;
+const uint8_t %sBitsPerSample = 4;
+const uint32_t %sSampleRate = %d;
+
+#endif /* %s */
+""" % (source, guard, guard, name, rate, source_rate, source_frames, samples, samples / float(rate),
+       len(data), source_frames * 2, name, c_array(list(data), "0x%02X", 16), name, name, name, samples,
+       name, name, name, rate, guard)
+
+
+def main():
+    root = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--wav", default=os.path.join(root, "assets/audio/game_over.wav"))
+    parser.add_argument("--header", default=os.path.join(root, "Core/Inc/audio_data.h"))
+    parser.add_argument("--name", default="gameOverAudio")
+    parser.add_argument("--rate", type=int, default=DEVICE_RATE)
+    args = parser.parse_args()
+
+    source_rate, source = read_wav(args.wav)
+    pcm = resample(source, source_rate, args.rate)
+    data, decoded = encode(pcm)
+
+    source_name = os.path.relpath(args.wav, root).replace(os.sep, "/")
+    write_if_changed(args.header, emit_header(args.name, source_name, source_rate, len(source),
+                                              args.rate, len(pcm), data))
+
+    print("Audio ADPCM: %s %d Hz %d frames -> %d Hz %d samples"
+          % (source_name, source_rate, len(source), args.rate, len(pcm)))
+    print("Audio ADPCM: flash %d -> %d bytes (%.1fx smaller), SNR %.1f dB against %d Hz PCM"
+          % (len(source) * 2, len(data), len(source) * 2.0 / len(data), snr_db(pcm, decoded), args.rate))
+    print("Audio ADPCM: decoded checksum 0x%08X" % (sum(decoded) & 0xFFFFFFFF))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
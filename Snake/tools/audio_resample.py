@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+"""Polyphase sample rate conversion for the audio assets.
+
+Converts by the exact rational ratio L/M (8000/44100 = 80/441): conceptually the
+input is upsampled by L, low-pass filtered and decimated by M. Only the filter
+taps that meet real input samples are evaluated, so each output sample costs
+one dot product with one phase of the filter. The filter is a Kaiser windowed
+sinc, linear phase and centred, so the output is not delayed.
+
+Used by tools/audio_adpcm.py. Self-test (exit status 1 on failure):
+    python3 tools/audio_resample.py --check
+
+The check converts synthetic tones 44.1 kHz -> 8 kHz and verifies the length
+(duration), the frequency of a tone (pitch), the error against the ideal tone
+in the passband and the attenuation of tones that would alias.
+"""
+
+import argparse
+import math
+import operator
+import sys
+
+PASSBAND = 0.85     # Of the lower Nyquist frequency, kept within the ripple
+STOPBAND = 1.0      # Of the lower Nyquist frequency, attenuated by ATTENUATION
+ATTENUATION = 70.0  # dB
+
+
+def bessel_i0(x):
+    """Modified Bessel function of the first kind, order 0 (Kaiser window)."""
+    total = 1.0
+    term = 1.0
+    k = 1
+    while term > 1e-12 * total:
+        term *= (x / (2.0 * k)) ** 2
+        total += term
+        k += 1
+    return total
+
+
+def design(rate, target):
+    """Return (L, M, phases, offset) for converting rate -> target.
+
+    phases[p] holds the coefficients applied to input samples base + offset + i,
+    where base = (n * M) // L and p = (n * M) % L for output sample n."""
+    g = math.gcd(rate, target)
+    up = target // g
+    down = rate // g
+
+    nyquist = min(rate, target) / 2.0
+    cutoff = (PASSBAND + STOPBAND) / 2.0 * nyquist
+    transition = (STOPBAND - PASSBAND) * nyquist
+    fs = float(rate) * up
+
+    # Kaiser's estimates for the window shape and the filter length
+    beta = 0.1102 * (ATTENUATION - 8.7)
+    taps = int(math.ceil((ATTENUATION - 8.0) / (2.285 * 2.0 * math.pi * transition / fs)))
+    half = taps // 2
+
+    fc = cutoff / fs
+    i0_beta = bessel_i0(beta)
+
+    def h(j):
+        if abs(j) > half:
+            return 0.0
+        x = 2.0 * fc * j
+        sinc = 1.0 if j == 0 else math.sin(math.pi * x) / (math.pi * x)
+        window = bessel_i0(beta * math.sqrt(1.0 - (float(j) / half) ** 2)) / i0_beta
+        return 2.0 * fc * sinc * window
+
+    # Output n sits at upsampled position u = n * M; tap j meets the input
+    # sample (u - j) / L, so with p = u % L the taps are j = p - m * L
+    offset = -((half + up - 1) // up) - 1
+    width = 2 * (half // up + 2) + 1
+    phases = []
+    for p in range(up):
+        coeffs = [h(p - (offset + i) * up) for i in range(width)]
+        phases.append(coeffs)
+
+    # Unity gain at DC for every phase
+    for coeffs in phases:
+        total = sum(coeffs)
+        for i in range(width):
+            coeffs[i] /= total
+    return up, down, phases, offset
+
+
+def resample(samples, rate, target):
+    """Convert 16-bit samples from rate to target, result clipped to 16 bits."""
+    if rate == target:
+        return list(samples)
+
+    up, down, phases, offset = design(rate, target)
+    width = len(phases[0])
+    pad = width + 1
+    padded = [0.0] * pad + [float(s) for s in samples] + [0.0] * pad
+
+    count = len(samples) * up // down
+    out = []
+    for n in range(count):
+        u = n * down
+        start = u // up + offset + pad
+        value = sum(map(operator.mul, phases[u % up], padded[start:start + width]))
+        out.append(max(-32768, min(32767, int(round(value)))))
+    return out
+
+
+def tone(freq, rate, count, amplitude=16000.0):
+    return [amplitude * math.sin(2.0 * math.pi * freq * n / rate) for n in range(count)]
+
+
+def rms(values):
+    return math.sqrt(sum(float(v) * v for v in values) / len(values)) if values else 0.0
+
+
+def measure_frequency(samples, rate):
+    """Frequency from the interval between the first and last rising zero crossings."""
+    crossings = []
+    for n in range(1, len(samples)):
+        a, b = samples[n - 1], samples[n]
+        if a < 0 <= b:
+            crossings.append(n - 1 + float(-a) / (b - a))
+    if len(crossings) < 2:
+        return 0.0
+    return (len(crossings) - 1) * rate / (crossings[-1] - crossings[0])
+
+
+def check(rate=44100, target=8000):
+    """Self-test; returns the number of failed checks."""
+    failures = 0
+    seconds = 1
+    count = rate * seconds
+    margin = target // 20  # Skip the filter's start and end
+
+    def report(ok, text):
+        print("%s %s" % ("ok  " if ok else "FAIL", text))
+        return 0 if ok else 1
+
+    # Duration: one output sample per target period
+    out = resample([0] * count, rate, target)
+    expected = count * target // rate
+    failures += report(abs(len(out) - expected) <= 1,
+                       "duration: %d samples at %d Hz -> %d at %d Hz (expected %d)"
+                       % (count, rate, len(out), target, expected))
+
+    # Pitch: a tone keeps its frequency (integer skipping played 907 Hz here)
+    out = resample(tone(1000.0, rate, count), rate, target)
+    freq = measure_frequency(out[margin:-margin], target)
+    failures += report(abs(freq - 1000.0) < 0.5, "pitch: 1000 Hz tone -> %.2f Hz" % freq)
+
+    # Spectral error: passband tones match the ideal tone at the new rate
+    for freq in (440.0, 2000.0, 3200.0):
+        out = resample(tone(freq, rate, count), rate, target)
+        ideal = tone(freq, target, len(out))
+        error = [a - b for a, b in zip(out[margin:-margin], ideal[margin:-margin])]
+        snr = 20.0 * math.log10(rms(ideal[margin:-margin]) / max(rms(error), 1e-9))
+        failures += report(snr > 50.0, "passband: %.0f Hz tone error %.1f dB below the signal" % (freq, snr))
+
+    # Aliasing: tones above the new Nyquist frequency are removed
+    for freq in (4600.0, 6000.0, 12000.0):
+        source = tone(freq, rate, count)
+        out = resample(source, rate, target)
+        level = 20.0 * math.log10(max(rms(out[margin:-margin]), 1e-9) / rms(source))
+        failures += report(level < -55.0, "stopband: %.0f Hz tone at %.1f dB" % (freq, level))
+
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--check", action="store_true", help="run the self-test")
+    args = parser.parse_args()
+    if not args.check:
+        parser.print_help()
+        return 0
+    return 1 if check() else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
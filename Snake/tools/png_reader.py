@@ -0,0 +1,123 @@
+"""Minimal PNG reader for the asset tools (8-bit, non-interlaced, no external dependencies)."""
+
+import struct
+import zlib
+
+PNG_SIGNATURE = b"\x89PNG\r\n\x1a\n"
+
+# Colour type -> channels per pixel
+_CHANNELS = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}
+
+
+def _paeth(a, b, c):
+    p = a + b - c
+    pa = abs(p - a)
+    pb = abs(p - b)
+    pc = abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    if pb <= pc:
+        return b
+    return c
+
+
+def read_png(path):
+    """Return (width, height, pixels) where pixels is a row-major list of (r, g, b, a) tuples."""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if data[:8] != PNG_SIGNATURE:
+        raise ValueError("%s: not a PNG file" % path)
+
+    pos = 8
+    idat = b""
+    palette = []
+    trns = b""
+    width = height = bit_depth = colour_type = interlace = None
+    while pos < len(data):
+        length, tag = struct.unpack(">I4s", data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if tag == b"IHDR":
+            width, height, bit_depth, colour_type, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+        elif tag == b"PLTE":
+            palette = [tuple(chunk[i:i + 3]) for i in range(0, length, 3)]
+        elif tag == b"tRNS":
+            trns = chunk
+        elif tag == b"IDAT":
+            idat += chunk
+        elif tag == b"IEND":
+            break
+
+    if bit_depth != 8 or interlace != 0 or colour_type not in _CHANNELS:
+        raise ValueError("%s: only 8-bit non-interlaced PNG files are supported" % path)
+
+    bpp = _CHANNELS[colour_type]
+    stride = width * bpp
+    raw = zlib.decompress(idat)
+    rows = []
+    prev = bytearray(stride)
+    pos = 0
+    for _ in range(height):
+        ftype = raw[pos]
+        line = bytearray(raw[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        for i in range(stride):
+            left = line[i - bpp] if i >= bpp else 0
+            up = prev[i]
+            upleft = prev[i - bpp] if i >= bpp else 0
+            if ftype == 1:
+                line[i] = (line[i] + left) & 0xFF
+            elif ftype == 2:
+                line[i] = (line[i] + up) & 0xFF
+            elif ftype == 3:
+                line[i] = (line[i] + ((left + up) >> 1)) & 0xFF
+            elif ftype == 4:
+                line[i] = (line[i] + _paeth(left, up, upleft)) & 0xFF
+        rows.append(line)
+        prev = line
+
+    pixels = []
+    for line in rows:
+        for x in range(width):
+            p = line[x * bpp:(x + 1) * bpp]
+            if colour_type == 0:
+                pixels.append((p[0], p[0], p[0], 255))
+            elif colour_type == 2:
+                pixels.append((p[0], p[1], p[2], 255))
+            elif colour_type == 3:
+                r, g, b = palette[p[0]]
+                a = trns[p[0]] if p[0] < len(trns) else 255
+                pixels.append((r, g, b, a))
+            elif colour_type == 4:
+                pixels.append((p[0], p[0], p[0], p[1]))
+            else:
+                pixels.append((p[0], p[1], p[2], p[3]))
+
+    return width, height, pixels
+
+
+def to_rgb565(r, g, b):
+    """Round an 8-bit RGB triple to RGB565."""
+    return (((r * 31 + 127) // 255) << 11) | (((g * 63 + 127) // 255) << 5) | ((b * 31 + 127) // 255)
+
+
+def rgb565_to_rgb888(c):
+    """Expand RGB565 to 8-bit channels by bit replication (truncating back gives the same RGB565)."""
+    r = (c >> 11) & 0x1F
+    g = (c >> 5) & 0x3F
+    b = c & 0x1F
+    return (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)
+
+
+def write_if_changed(path, text):
+    """Write text to path unless the file already has that content. Returns True if written."""
+    try:
+        with open(path, "r") as f:
+            if f.read() == text:
+                return False
+    except IOError:
+        pass
+    with open(path, "w") as f:
+        f.write(text)
+    return True
@@ -0,0 +1,11 @@
+// Host stand-in for the generated bitmap database: ids of the food sprites in
+// the host SnakeSpritesL8.cpp (the values only need to be distinct)
+#ifndef BITMAPDATABASE_HPP
+#define BITMAPDATABASE_HPP
+
+#include <stdint.h>
+
+const uint16_t BITMAP_FOOD_ID = 0;
+const uint16_t BITMAP_BIGFOOD_ID = 1;
+
+#endif // BITMAPDATABASE_HPP
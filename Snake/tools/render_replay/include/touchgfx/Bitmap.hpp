@@ -0,0 +1,13 @@
+// Host stand-in for the TouchGFX header, only what SnakeSpritesL8.cpp needs
+#ifndef TOUCHGFX_BITMAP_HPP
+#define TOUCHGFX_BITMAP_HPP
+
+#include <stdint.h>
+
+namespace touchgfx
+{
+typedef uint16_t BitmapId;
+const BitmapId BITMAP_INVALID = 0xFFFF;
+}
+
+#endif // TOUCHGFX_BITMAP_HPP
@@ -0,0 +1,7 @@
+// Host stand-in for the TouchGFX header, only what SnakeSpritesL8.cpp needs
+#ifndef TOUCHGFX_TYPES_HPP
+#define TOUCHGFX_TYPES_HPP
+
+#include <stdint.h>
+
+#endif // TOUCHGFX_TYPES_HPP
@@ -0,0 +1,664 @@
+// Headless replay renderer for the game screen.
+//
+// Runs SnakeGame and the screen model of Screen2View (SnakeScreen, the same
+// code the target builds) on the host and draws the playfield into an
+// in-memory 240x320 RGB565 framebuffer with a software blitter, using the same
+// L8 sprite data as the target. Like the target it only redraws the areas
+// SnakeScreen reports as changed. Each frame reports the pixels it redrew and
+// checks that the redrawn areas give the full image, so stale pixels are
+// reported too. Everything is driven by a simulated 60 Hz clock and a fixed
+// game seed, so a replay always renders the same images.
+//
+// Build and check against the committed reference images (golden/):
+//     make -C tools/render_replay check
+//
+// After a change that is meant to alter the picture, look at the new images and
+// replace the references with them:
+//     make -C tools/render_replay golden
+//
+// Options:
+//     --steps N          game steps to play (default 200)
+//     --difficulty NAME  easy, normal, hard, insane or nightmare (default normal)
+//     --replay FILE      one character per step: U, D, L, R or '.' (keep going);
+//                        without it the game autopilot steers
+//     --every N          take an image every N steps only (default 1)
+//     --out DIR          write DIR/step_NNNN.png for the imaged steps
+//     --compare DIR      compare the imaged steps with DIR/step_NNNN.png
+//     --cost FILE        write the redrawn areas and pixels per frame as CSV
+//
+// Exit status is 1 if an image differs from --compare or pixels were left stale.
+// The score text is not rendered (it needs the TouchGFX font engine).
+
+#include <gui/common/SnakeGame.hpp>
+#include <gui/common/SnakeScreen.hpp>
+#include <gui/common/SnakeSpritesL8.hpp>
+#include <images/BitmapDatabase.hpp>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Simulated time for the BigFood timer (SnakeInterface.h)
+static uint32_t simulatedMs = 0;
+
+extern "C" uint32_t Snake_GetTickMs(void)
+{
+    return simulatedMs;
+}
+
+namespace
+{
+const int SCREEN_WIDTH = 240;
+const int SCREEN_HEIGHT = 320;
+const int FRAME_RATE = 60;
+
+const uint16_t BLACK = 0x0000;
+const uint16_t BAR_COLOR = ((BIGFOOD_BAR_RED & 0xF8) << 8) | ((BIGFOOD_BAR_GREEN & 0xFC) << 3) | (BIGFOOD_BAR_BLUE >> 3);
+
+// ---------------------------------------------------------------------------
+// PNG output (fixed Huffman deflate, no compression library needed)
+// ---------------------------------------------------------------------------
+
+uint32_t crcTable[256];
+
+void initCrc()
+{
+    for (uint32_t n = 0; n < 256; n++)
+    {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++)
+        {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        crcTable[n] = c;
+    }
+}
+
+uint32_t crc(const uint8_t *data, size_t length, uint32_t c = 0xFFFFFFFFu)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        c = crcTable[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    }
+    return c;
+}
+
+void put32(std::vector<uint8_t> &out, uint32_t value)
+{
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+}
+
+void putChunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data)
+{
+    std::vector<uint8_t> chunk(type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+
+    put32(out, data.size());
+    out.insert(out.end(), chunk.begin(), chunk.end());
+    put32(out, crc(&chunk[0], chunk.size()) ^ 0xFFFFFFFFu);
+}
+
+// Deflate bit stream: values LSB first, Huffman codes MSB first
+class BitWriter
+{
+public:
+    BitWriter(std::vector<uint8_t> &out) : out(out), bits(0), count(0) {}
+
+    void put(uint32_t value, int length)
+    {
+        bits |= value << count;
+        count += length;
+        while (count >= 8)
+        {
+            out.push_back(bits & 0xFF);
+            bits >>= 8;
+            count -= 8;
+        }
+    }
+
+    void putCode(uint32_t code, int length)
+    {
+        uint32_t reversed = 0;
+        for (int i = 0; i < length; i++)
+        {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+        put(reversed, length);
+    }
+
+    void flush()
+    {
+        if (count > 0)
+            out.push_back(bits & 0xFF);
+        bits = 0;
+        count = 0;
+    }
+
+private:
+    std::vector<uint8_t> &out;
+    uint32_t bits;
+    int count;
+};
+
+// Literal/length symbol with the fixed Huffman code (RFC 1951 3.2.6)
+void putSymbol(BitWriter &bits, int symbol)
+{
+    if (symbol < 144)
+        bits.putCode(0x30 + symbol, 8);
+    else if (symbol < 256)
+        bits.putCode(0x190 + symbol - 144, 9);
+    else if (symbol < 280)
+        bits.putCode(symbol - 256, 7);
+    else
+        bits.putCode(0xC0 + symbol - 280, 8);
+}
+
+void putMatch(BitWriter &bits, int length, int distance)
+{
+    static const uint16_t lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const uint16_t distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                              257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const uint8_t distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                              7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    int l = 28;
+    while (lengthBase[l] > length)
+        l--;
+    putSymbol(bits, 257 + l);
+    bits.put(length - lengthBase[l], lengthExtra[l]);
+
+    int d = 29;
+    while (distanceBase[d] > distance)
+        d--;
+    bits.putCode(d, 5);
+    bits.put(distance - distanceBase[d], distanceExtra[d]);
+}
+
+// One fixed Huffman block. The frames are mostly flat colour and repeated sprites,
+// so matches one pixel back and one row up find nearly everything.
+void deflate(const std::vector<uint8_t> &raw, size_t rowBytes, std::vector<uint8_t> &out)
+{
+    BitWriter bits(out);
+    bits.put(1, 1); // Final block
+    bits.put(1, 2); // Fixed Huffman codes
+
+    const size_t candidates[2] = {3, rowBytes};
+    size_t pos = 0;
+    while (pos < raw.size())
+    {
+        size_t bestLength = 0, bestDistance = 0;
+        for (int c = 0; c < 2; c++)
+        {
+            size_t distance = candidates[c];
+            if (distance > pos)
+                continue;
+            size_t length = 0;
+            while (length < 258 && pos + length < raw.size() && raw[pos + length] == raw[pos + length - distance])
+                length++;
+            if (length > bestLength)
+            {
+                bestLength = length;
+                bestDistance = distance;
+            }
+        }
+
+        if (bestLength >= 3)
+        {
+            putMatch(bits, (int)bestLength, (int)bestDistance);
+            pos += bestLength;
+        }
+        else
+        {
+            putSymbol(bits, raw[pos]);
+            pos++;
+        }
+    }
+
+    putSymbol(bits, 256); // End of block
+    bits.flush();
+}
+
+std::vector<uint8_t> encodePng(const uint16_t *fb)
+{
+    // Filter byte 0 + RGB888 per row, RGB565 expanded by bit replication
+    std::vector<uint8_t> raw;
+    for (int y = 0; y < SCREEN_HEIGHT; y++)
+    {
+        raw.push_back(0);
+        for (int x = 0; x < SCREEN_WIDTH; x++)
+        {
+            uint16_t c = fb[y * SCREEN_WIDTH + x];
+            uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+            raw.push_back((r << 3) | (r >> 2));
+            raw.push_back((g << 2) | (g >> 4));
+            raw.push_back((b << 3) | (b >> 2));
+        }
+    }
+
+    // zlib stream (32K window, fastest compression level)
+    std::vector<uint8_t> zlib;
+    zlib.push_back(0x78);
+    zlib.push_back(0x01);
+    deflate(raw, 1 + SCREEN_WIDTH * 3, zlib);
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < raw.size(); i++)
+    {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    put32(zlib, (b << 16) | a);
+
+    std::vector<uint8_t> png;
+    const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    png.insert(png.end(), signature, signature + 8);
+
+    std::vector<uint8_t> header;
+    put32(header, SCREEN_WIDTH);
+    put32(header, SCREEN_HEIGHT);
+    header.push_back(8); // Bit depth
+    header.push_back(2); // RGB
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(0);
+    putChunk(png, "IHDR", header);
+    putChunk(png, "IDAT", zlib);
+    putChunk(png, "IEND", std::vector<uint8_t>());
+    return png;
+}
+
+bool readFile(const std::string &path, std::vector<uint8_t> &data)
+{
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f)
+        return false;
+    uint8_t buffer[4096];
+    size_t n;
+    data.clear();
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+    {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    fclose(f);
+    return true;
+}
+
+bool writeFile(const std::string &path, const std::vector<uint8_t> &data)
+{
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f)
+        return false;
+    bool ok = fwrite(&data[0], 1, data.size(), f) == data.size();
+    return fclose(f) == 0 && ok;
+}
+
+// ---------------------------------------------------------------------------
+// Software blitter
+// ---------------------------------------------------------------------------
+
+uint16_t toRgb565(uint32_t argb)
+{
+    return ((argb >> 8) & 0xF800) | ((argb >> 5) & 0x07E0) | ((argb >> 3) & 0x001F);
+}
+
+const SnakeSpriteL8 &findSprite(uint16_t bitmapId)
+{
+    const SnakeSpriteL8 *sprite = SnakeSpritesL8_find(bitmapId);
+    if (!sprite)
+    {
+        fprintf(stderr, "missing L8 sprite %u\n", bitmapId);
+        exit(2);
+    }
+    return *sprite;
+}
+
+// Opaque L8 blit rotated counter-clockwise, like SnakeSprites::generateSprites() + the DMA2D CLUT copy
+void blitSprite(uint16_t *fb, const SnakeSpriteL8 &sprite, uint8_t quarterTurns, int dstX, int dstY)
+{
+    int width = sprite.width, height = sprite.height;
+    int dstWidth = (quarterTurns & 1) ? height : width;
+    int dstHeight = (quarterTurns & 1) ? width : height;
+
+    for (int y = 0; y < dstHeight; y++)
+    {
+        for (int x = 0; x < dstWidth; x++)
+        {
+            int sx, sy;
+            switch (quarterTurns & 3)
+            {
+            case 1:
+                sx = width - 1 - y;
+                sy = x;
+                break;
+            case 2:
+                sx = width - 1 - x;
+                sy = height - 1 - y;
+                break;
+            case 3:
+                sx = y;
+                sy = height - 1 - x;
+                break;
+            default:
+                sx = x;
+                sy = y;
+                break;
+            }
+            int px = dstX + x, py = dstY + y;
+            if (px >= 0 && px < SCREEN_WIDTH && py >= 0 && py < SCREEN_HEIGHT)
+            {
+                fb[py * SCREEN_WIDTH + px] = toRgb565(snakeSpritePaletteL8[sprite.indices[sy * sprite.stride + sx]]);
+            }
+        }
+    }
+}
+
+void fillRect(uint16_t *fb, const SnakeScreenArea &r, uint16_t color)
+{
+    for (int y = r.y; y < r.y + r.height; y++)
+    {
+        for (int x = r.x; x < r.x + r.width; x++)
+        {
+            fb[y * SCREEN_WIDTH + x] = color;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Screen: SnakeScreen reports the changes, as it does to Screen2View
+// ---------------------------------------------------------------------------
+
+// Full composite in Screen2View's z-order: background, food, snake, BigFood, HUD
+void compose(const SnakeScreen &screen, uint16_t *fb)
+{
+    static const uint8_t shapeSprites[4] = {SNAKE_SPRITE_HEAD, SNAKE_SPRITE_TAIL, SNAKE_SPRITE_MID, SNAKE_SPRITE_TURN};
+
+    for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++)
+    {
+        fb[i] = BLACK;
+    }
+
+    if (screen.isFoodShown())
+    {
+        SnakeScreenArea food = SnakeScreen::foodArea(screen.getFood());
+        blitSprite(fb, findSprite(BITMAP_FOOD_ID), 0, food.x, food.y);
+    }
+
+    for (int16_t y = 0; y < GRID_HEIGHT; y++)
+    {
+        for (int16_t x = 0; x < GRID_WIDTH; x++)
+        {
+            SnakeScreenCell cell = screen.getCell(x, y);
+            if (cell != SNAKE_SCREEN_EMPTY)
+            {
+                SnakeCellSprite sprite = SnakeScreen_decodeCell(cell);
+                SnakeScreenArea area = SnakeScreen::cellArea(x, y);
+                blitSprite(fb, snakeSpritesL8[shapeSprites[sprite.shape]], sprite.rotation, area.x, area.y);
+            }
+        }
+    }
+
+    if (screen.isBigFoodShown())
+    {
+        SnakeScreenArea bigFood = SnakeScreen::bigFoodArea(screen.getBigFood());
+        blitSprite(fb, findSprite(BITMAP_BIGFOOD_ID), 0, bigFood.x, bigFood.y);
+    }
+
+    fillRect(fb, SnakeScreen::barArea(0, screen.getBarFill()), BAR_COLOR);
+}
+
+// Collects the areas Screen2View invalidates for the reported changes
+class DirtyAreas : public SnakeScreenListener
+{
+public:
+    std::vector<SnakeScreenArea> areas;
+
+    virtual void cellChanged(int16_t x, int16_t y, SnakeScreenCell)
+    {
+        areas.push_back(SnakeScreen::cellArea(x, y));
+    }
+
+    virtual void foodChanged(bool wasShown, Position from, Position to)
+    {
+        if (wasShown)
+            areas.push_back(SnakeScreen::foodArea(from));
+        areas.push_back(SnakeScreen::foodArea(to));
+    }
+
+    virtual void bigFoodChanged(bool wasShown, Position from, bool shown, Position to)
+    {
+        if (wasShown)
+            areas.push_back(SnakeScreen::bigFoodArea(from));
+        if (shown)
+            areas.push_back(SnakeScreen::bigFoodArea(to));
+    }
+
+    virtual void barChanged(int16_t first, int16_t count)
+    {
+        areas.push_back(SnakeScreen::barArea(first, count));
+    }
+};
+
+// Copy the invalidated areas of the new composite to the display; returns pixels written
+uint32_t redraw(const std::vector<SnakeScreenArea> &areas, const uint16_t *composite, uint16_t *display)
+{
+    uint32_t pixels = 0;
+    for (size_t i = 0; i < areas.size(); i++)
+    {
+        const SnakeScreenArea &r = areas[i];
+        for (int y = r.y; y < r.y + r.height; y++)
+        {
+            memcpy(&display[y * SCREEN_WIDTH + r.x], &composite[y * SCREEN_WIDTH + r.x], r.width * sizeof(uint16_t));
+        }
+        pixels += r.width * r.height;
+    }
+    return pixels;
+}
+
+uint32_t countStale(const uint16_t *composite, const uint16_t *display)
+{
+    uint32_t stale = 0;
+    for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++)
+    {
+        if (composite[i] != display[i])
+            stale++;
+    }
+    return stale;
+}
+
+bool parseDifficulty(const char *name, Difficulty &difficulty)
+{
+    static const char *const names[NIGHTMARE + 1] = {"easy", "normal", "hard", "insane", "nightmare"};
+    for (int d = EASY; d <= NIGHTMARE; d++)
+    {
+        if (strcmp(name, names[d]) == 0)
+        {
+            difficulty = static_cast<Difficulty>(d);
+            return true;
+        }
+    }
+    return false;
+}
+
+int usage()
+{
+    fprintf(stderr, "usage: render_replay [--steps N] [--difficulty NAME] [--replay FILE] [--every N] [--out DIR] [--compare DIR] [--cost FILE]\n");
+    return 2;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int steps = 200, every = 1;
+    Difficulty difficulty = NORMAL;
+    std::string replay, outDir, compareDir, costFile;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+            return usage();
+        if (arg == "--steps")
+            steps = atoi(argv[++i]);
+        else if (arg == "--difficulty")
+        {
+            if (!parseDifficulty(argv[++i], difficulty))
+                return usage();
+        }
+        else if (arg == "--replay")
+            replay = argv[++i];
+        else if (arg == "--every")
+        {
+            every = atoi(argv[++i]);
+            if (every < 1)
+                return usage();
+        }
+        else if (arg == "--out")
+            outDir = argv[++i];
+        else if (arg == "--compare")
+            compareDir = argv[++i];
+        else if (arg == "--cost")
+            costFile = argv[++i];
+        else
+            return usage();
+    }
+
+    std::vector<uint8_t> moves;
+    if (!replay.empty())
+    {
+        std::vector<uint8_t> text;
+        if (!readFile(replay, text))
+        {
+            fprintf(stderr, "cannot read %s\n", replay.c_str());
+            return 2;
+        }
+        for (size_t i = 0; i < text.size(); i++)
+        {
+            if (strchr("UDLR.", text[i]))
+                moves.push_back(text[i]);
+        }
+    }
+
+    initCrc();
+
+    FILE *cost = 0;
+    if (!costFile.empty())
+    {
+        cost = fopen(costFile.c_str(), "w");
+        if (!cost)
+        {
+            fprintf(stderr, "cannot write %s\n", costFile.c_str());
+            return 2;
+        }
+        fprintf(cost, "frame,step,areas,pixels\n");
+    }
+
+    SnakeGame game;
+    game.setDifficulty(difficulty);
+    game.reset();
+
+    std::vector<uint16_t> composite(SCREEN_WIDTH * SCREEN_HEIGHT);
+    std::vector<uint16_t> display(SCREEN_WIDTH * SCREEN_HEIGHT);
+
+    // First frame: the whole screen (setupScreen redraws everything)
+    SnakeScreen screen;
+    DirtyAreas initial;
+    screen.updateBoard(game, initial);
+    screen.updateBar(game, initial);
+    compose(screen, &composite[0]);
+    display = composite;
+
+    uint32_t frame = 0, tickCounter = 0, totalPixels = 0, maxPixels = 0, stale = 0, mismatches = 0;
+    int step = 0;
+
+    while (step < steps && !game.isGameOver())
+    {
+        frame++;
+        simulatedMs = (uint32_t)((uint64_t)frame * 1000 / FRAME_RATE);
+
+        // Same order and pacing as Screen2View::stepGame: bar every tick, board after a step
+        DirtyAreas dirty;
+        screen.updateBar(game, dirty);
+
+        if (++tickCounter >= game.getTickInterval())
+        {
+            tickCounter = 0;
+
+            if (step < (int)moves.size())
+            {
+                static const SnakeDirection directions[] = {SNAKE_DIR_UP, SNAKE_DIR_DOWN, SNAKE_DIR_LEFT, SNAKE_DIR_RIGHT};
+                const char *found = strchr("UDLR", moves[step]);
+                if (found)
+                    game.setDirection(directions[found - "UDLR"]);
+            }
+            else if (moves.empty())
+            {
+                game.setDirection(game.getAutopilotDirection());
+            }
+
+            if (game.update())
+                screen.updateBoard(game, dirty);
+            step++;
+        }
+
+        const std::vector<SnakeScreenArea> &areas = dirty.areas;
+        compose(screen, &composite[0]);
+        uint32_t pixels = redraw(areas, &composite[0], &display[0]);
+        totalPixels += pixels;
+        if (pixels > maxPixels)
+            maxPixels = pixels;
+
+        uint32_t frameStale = countStale(&composite[0], &display[0]);
+        if (frameStale != 0)
+        {
+            fprintf(stderr, "frame %u: %u stale pixels\n", frame, frameStale);
+            stale += frameStale;
+            display = composite;
+        }
+
+        if (cost)
+            fprintf(cost, "%u,%d,%u,%u\n", frame, step, (unsigned)areas.size(), pixels);
+
+        // One image per imaged game step, taken on the frame that played it
+        if (tickCounter == 0 && step % every == 0 && (!outDir.empty() || !compareDir.empty()))
+        {
+            char name[32];
+            snprintf(name, sizeof(name), "/step_%04d.png", step);
+            std::vector<uint8_t> png = encodePng(&display[0]);
+
+            if (!outDir.empty() && !writeFile(outDir + name, png))
+            {
+                fprintf(stderr, "cannot write %s%s\n", outDir.c_str(), name);
+                return 2;
+            }
+            if (!compareDir.empty())
+            {
+                std::vector<uint8_t> golden;
+                if (!readFile(compareDir + name, golden) || golden != png)
+                {
+                    fprintf(stderr, "step %d differs from %s%s\n", step, compareDir.c_str(), name);
+                    mismatches++;
+                }
+            }
+        }
+    }
+
+    if (cost)
+        fclose(cost);
+
+    printf("steps %d, frames %u, score %u%s\n", step, frame, game.getScore(), game.isGameOver() ? " (game over)" : "");
+    printf("pixels written: total %u, average %u per frame, max %u\n", totalPixels, frame ? totalPixels / frame : 0, maxPixels);
+    if (!compareDir.empty())
+        printf("golden images: %u mismatches\n", mismatches);
+    if (stale != 0)
+        printf("stale pixels: %u\n", stale);
+
+    return (mismatches != 0 || stale != 0) ? 1 : 0;
+}
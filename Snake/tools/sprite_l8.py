@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+"""Convert the snake sprites to 8-bit indexed (L8) data sharing one palette, packed into one atlas.
+
+SnakeBoard blits these through TileBatchDMA with the palette loaded once into the
+DMA2D foreground CLUT, so every cell blit reads 1 byte per pixel instead of 2.
+All sprites live in a single atlas image and are addressed as sub-rectangles of it,
+so they are one contiguous block in flash and one region for the SDRAM preloader.
+
+The sprites are read from TouchGFX/assets/sprites, which the image converter
+never sees: the atlas is their only copy in flash, and SnakeSprites expands them
+to RGB565 in the bitmap cache at boot. --with-images also adds the food sprites
+(which stay RGB565 bitmaps for their Image widgets) for tools/render_replay.
+
+Usage (from the Snake directory, also run by gcc/Makefile):
+    python3 tools/sprite_l8.py [--sprites DIR] [--with-images] [--images DIR] [--header FILE] [--source FILE]
+
+Prints the worst palette error, the source bytes read per cell blit, the atlas
+layout and the net flash change.
+"""
+
+import argparse
+import os
+import sys
+
+from png_reader import read_png, to_rgb565, rgb565_to_rgb888, write_if_changed
+
+# Sprites drawn by SnakeBoard, in palette/table order. Only the canonical orientation
+# is stored; SnakeSprites::generateSprites() rotates the L8 data along with the bitmaps.
+BOARD_SPRITES = ["Head", "Tail", "Mid", "Turn"]
+# BitmapDatabase sprites drawn by Image widgets, only converted for the host renderer
+IMAGE_SPRITES = ["Food", "BigFood"]
+
+MAX_PALETTE = 256
+
+
+def median_cut(colours, limit):
+    """Reduce a {rgb565: count} histogram to at most limit representative RGB565 colours."""
+    boxes = [list(colours.items())]
+    while len(boxes) < limit:
+        # Split the box with the widest channel range
+        best = None
+        for i, box in enumerate(boxes):
+            if len(box) < 2:
+                continue
+            rgb = [rgb565_to_rgb888(c) for c, _ in box]
+            for ch in range(3):
+                span = max(p[ch] for p in rgb) - min(p[ch] for p in rgb)
+                if best is None or span > best[0]:
+                    best = (span, i, ch)
+        if best is None or best[0] == 0:
+            break
+        _, i, ch = best
+        box = sorted(boxes[i], key=lambda e: rgb565_to_rgb888(e[0])[ch])
+        total = sum(n for _, n in box)
+        acc = 0
+        cut = 1
+        for cut in range(1, len(box)):
+            acc += box[cut - 1][1]
+            if acc * 2 >= total:
+                break
+        boxes[i:i + 1] = [box[:cut], box[cut:]]
+
+    mapping = {}
+    palette = []
+    for box in boxes:
+        total = sum(n for _, n in box)
+        avg = [0, 0, 0]
+        for c, n in box:
+            rgb = rgb565_to_rgb888(c)
+            for ch in range(3):
+                avg[ch] += rgb[ch] * n
+        rep = to_rgb565(*[int(round(v / float(total))) for v in avg])
+        if rep not in palette:
+            palette.append(rep)
+        for c, _ in box:
+            mapping[c] = palette.index(rep)
+    return palette, mapping
+
+
+def build(sprites_dir, images_dir):
+    sprites = []
+    histogram = {}
+    sources = [(sprites_dir, name) for name in BOARD_SPRITES]
+    if images_dir:
+        sources += [(images_dir, name) for name in IMAGE_SPRITES]
+    for directory, name in sources:
+        path = os.path.join(directory, name + ".png")
+        width, height, pixels = read_png(path)
+        if any(a != 255 for _, _, _, a in pixels):
+            raise ValueError("%s: L8 sprites must be opaque" % path)
+        rgb565 = [to_rgb565(r, g, b) for r, g, b, _ in pixels]
+        for c in rgb565:
+            histogram[c] = histogram.get(c, 0) + 1
+        sprites.append((name, width, height, rgb565))
+
+    if len(histogram) <= MAX_PALETTE:
+        # Exact: every RGB565 colour gets its own entry, most frequent first
+        palette = sorted(histogram, key=lambda c: (-histogram[c], c))
+        mapping = dict((c, i) for i, c in enumerate(palette))
+    else:
+        palette, mapping = median_cut(histogram, MAX_PALETTE)
+
+    max_error = 0
+    for _, _, _, rgb565 in sprites:
+        for c in rgb565:
+            a = rgb565_to_rgb888(c)
+            b = rgb565_to_rgb888(palette[mapping[c]])
+            max_error = max(max_error, max(abs(a[ch] - b[ch]) for ch in range(3)))
+
+    indexed = [(name, w, h, [mapping[c] for c in px]) for name, w, h, px in sprites]
+    return palette, indexed, len(histogram), max_error
+
+
+def skyline_pack(sizes, width):
+    """Place (w, h) rectangles bottom-left on a skyline of the given width, largest first.
+
+    Returns (height, [(x, y)] in input order), or None if a rectangle does not fit."""
+    order = sorted(range(len(sizes)), key=lambda i: (-sizes[i][0] * sizes[i][1], -sizes[i][1], i))
+    skyline = [0] * width
+    positions = [None] * len(sizes)
+    for i in order:
+        w, h = sizes[i]
+        if w > width:
+            return None
+        # Lowest position, leftmost on ties
+        y, x = min((max(skyline[x:x + w]), x) for x in range(width - w + 1))
+        positions[i] = (x, y)
+        skyline[x:x + w] = [y + h] * w
+    return max(skyline), positions
+
+
+def pack_atlas(sprites):
+    """Choose the atlas width with the least area (the wider one on ties, for longer rows)."""
+    sizes = [(w, h) for _, w, h, _ in sprites]
+    best = None
+    for width in range(max(w for w, _ in sizes), sum(w for w, _ in sizes) + 1):
+        packed = skyline_pack(sizes, width)
+        if packed is None:
+            continue
+        height, positions = packed
+        if best is None or width * height <= best[0] * best[1]:
+            best = (width, height, positions)
+    return best
+
+
+def c_array(values, fmt, per_line):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(fmt % v for v in values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def generated_note(sprites):
+    origin = "TouchGFX/assets/sprites"
+    if len(sprites) > len(BOARD_SPRITES):
+        origin += " and images"
+    return "// Generated by tools/sprite_l8.py from %s - do not edit" % origin
+
+
+def emit_header(palette, sprites, atlas):
+    indices = "\n".join("#define SNAKE_SPRITE_%s %d" % (name.upper(), i) for i, (name, _, _, _) in enumerate(sprites))
+    return """%s
+#ifndef SNAKESPRITESL8_HPP
+#define SNAKESPRITESL8_HPP
+
+#include <touchgfx/hal/Types.hpp>
+#include <touchgfx/Bitmap.hpp>
+
+// Shared-palette 8-bit indexed copy of a TouchGFX sprite: a sub-rectangle of an atlas
+struct SnakeSpriteL8
+{
+    touchgfx::BitmapId bitmapId;
+    uint8_t width;
+    uint8_t height;
+    uint16_t stride;        // Atlas line length in pixels
+    const uint8_t *indices; // Top left pixel in the atlas
+};
+
+// Palette as ARGB8888 (DMA2D CLUT format), RGB565 expanded by bit replication
+#define SNAKE_SPRITE_PALETTE_SIZE %d
+extern const uint32_t snakeSpritePaletteL8[SNAKE_SPRITE_PALETTE_SIZE];
+
+// All stored sprites packed into one L8 image
+#define SNAKE_SPRITE_ATLAS_WIDTH %d
+#define SNAKE_SPRITE_ATLAS_HEIGHT %d
+extern const uint8_t snakeSpriteAtlasL8[SNAKE_SPRITE_ATLAS_WIDTH * SNAKE_SPRITE_ATLAS_HEIGHT];
+
+#define SNAKE_SPRITE_COUNT %d
+extern const SnakeSpriteL8 snakeSpritesL8[SNAKE_SPRITE_COUNT];
+
+// Table indices. The first SNAKE_SPRITE_BOARD_COUNT sprites are not in the
+// BitmapDatabase: their bitmapId is BITMAP_INVALID and SnakeSprites creates the bitmaps
+%s
+#define SNAKE_SPRITE_BOARD_COUNT %d
+
+// L8 copy of a sprite, or 0 if the bitmap has none
+const SnakeSpriteL8 *SnakeSpritesL8_find(touchgfx::BitmapId id);
+
+#endif // SNAKESPRITESL8_HPP
+""" % (generated_note(sprites), len(palette), atlas[0], atlas[1], len(sprites), indices, len(BOARD_SPRITES))
+
+
+def emit_source(palette, sprites, atlas):
+    out = [generated_note(sprites),
+           "#include <gui/common/SnakeSpritesL8.hpp>",
+           "#include <images/BitmapDatabase.hpp>",
+           "",
+           "const uint32_t snakeSpritePaletteL8[SNAKE_SPRITE_PALETTE_SIZE] = {"]
+    argb = []
+    for c in palette:
+        r, g, b = rgb565_to_rgb888(c)
+        argb.append(0xFF000000 | (r << 16) | (g << 8) | b)
+    out.append(c_array(argb, "0x%08X", 6))
+    out.append("};")
+    out.append("")
+
+    atlas_width, atlas_height, positions = atlas
+    pixels = [0] * (atlas_width * atlas_height)
+    for (_, w, h, indices), (x, y) in zip(sprites, positions):
+        for row in range(h):
+            start = (y + row) * atlas_width + x
+            pixels[start:start + w] = indices[row * w:(row + 1) * w]
+
+    out.append("// Layout (x, y, width, height):")
+    for (name, w, h, _), (x, y) in zip(sprites, positions):
+        out.append("//   %-8s %3d %3d %3d %3d" % (name, x, y, w, h))
+    out.append("const uint8_t snakeSpriteAtlasL8[SNAKE_SPRITE_ATLAS_WIDTH * SNAKE_SPRITE_ATLAS_HEIGHT] = {")
+    out.append(c_array(pixels, "%d", atlas_width))
+    out.append("};")
+    out.append("")
+
+    out.append("const SnakeSpriteL8 snakeSpritesL8[SNAKE_SPRITE_COUNT] = {")
+    for (name, w, h, _), (x, y) in zip(sprites, positions):
+        bitmap = "touchgfx::BITMAP_INVALID" if name in BOARD_SPRITES else "BITMAP_%s_ID" % name.upper()
+        out.append("    {%s, %d, %d, SNAKE_SPRITE_ATLAS_WIDTH, snakeSpriteAtlasL8 + %d}, // %s" % (bitmap, w, h, y * atlas_width + x, name))
+    out.append("};")
+    out.append("")
+    if len(sprites) == len(BOARD_SPRITES):
+        out.append("""const SnakeSpriteL8 *SnakeSpritesL8_find(touchgfx::BitmapId)
+{
+    // Only board sprites, which are looked up by SnakeSprites::findL8()
+    return 0;
+}
+""")
+        return "\n".join(out)
+    out.append("""const SnakeSpriteL8 *SnakeSpritesL8_find(touchgfx::BitmapId id)
+{
+    // The board sprites are looked up by SnakeSprites::findL8()
+    for (uint8_t i = SNAKE_SPRITE_BOARD_COUNT; i < SNAKE_SPRITE_COUNT; i++)
+    {
+        if (snakeSpritesL8[i].bitmapId == id)
+        {
+            return &snakeSpritesL8[i];
+        }
+    }
+    return 0;
+}
+""")
+    return "\n".join(out)
+
+
+def main():
+    root = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--sprites", default=os.path.join(root, "TouchGFX/assets/sprites"))
+    parser.add_argument("--with-images", action="store_true")
+    parser.add_argument("--images", default=os.path.join(root, "TouchGFX/assets/images"))
+    parser.add_argument("--header", default=os.path.join(root, "TouchGFX/gui/include/gui/common/SnakeSpritesL8.hpp"))
+    parser.add_argument("--source", default=os.path.join(root, "TouchGFX/gui/src/common/SnakeSpritesL8.cpp"))
+    args = parser.parse_args()
+
+    palette, sprites, colours, max_error = build(args.sprites, args.images if args.with_images else None)
+    atlas = pack_atlas(sprites)
+
+    write_if_changed(args.header, emit_header(palette, sprites, atlas))
+    write_if_changed(args.source, emit_source(palette, sprites, atlas))
+
+    pixels = sum(w * h for _, w, h, _ in sprites)
+    cell_pixels = 10 * 10
+    print("Sprite L8: %d sprites, %d colours -> %d palette entries, max error %d/255 per channel"
+          % (len(sprites), colours, len(palette), max_error))
+    # 1 byte per pixel instead of 2: half the source reads. The CLUT load is not
+    # per blit (TileBatchDMA reloads it only after TouchGFX has used the CLUT).
+    print("Sprite L8: source reads per 10x10 cell blit %d -> %d bytes, CLUT load %d bytes"
+          % (cell_pixels * 2, cell_pixels, len(palette) * 4))
+    print("Sprite atlas: %dx%d, %d%% used, preload regions %d -> 1"
+          % (atlas[0], atlas[1], pixels * 100 // (atlas[0] * atlas[1]), len(sprites)))
+    if args.with_images:
+        # The flash numbers describe the firmware set only
+        return 0
+
+    # Net flash: the atlas (word aligned), palette and table are the only stored
+    # copy of the board sprites and replace their RGB565 pixel data
+    align = lambda n: (n + 3) & ~3
+    l8_bytes = align(atlas[0] * atlas[1]) + len(palette) * 4 + len(sprites) * 12
+    rgb565_bytes = sum(w * h * 2 for _, w, h, _ in sprites)
+    print("Sprite L8: flash %d bytes RGB565 -> %d bytes L8 incl. palette and table, net %+d bytes"
+          % (rgb565_bytes, l8_bytes, l8_bytes - rgb565_bytes))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())